@@ -4,15 +4,18 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include <Vulk/internal/base.h>
 
+#include <Vulk/Device.h>
+
 MI_NAMESPACE_BEGIN(Vulk)
 
-class Device;
 class CommandBuffer;
 class Queue;
 class DeviceMemory;
+class StagingBuffer;
 
 class Buffer : public Sharable<Buffer>, private NotCopyable {
  public:
@@ -42,6 +45,17 @@ class Buffer : public Sharable<Buffer>, private NotCopyable {
   void free();
 
   void load(const void* data, VkDeviceSize size, VkDeviceSize offset = 0, bool staging = true);
+  // Load the regions of `data` to the buffer: `srcOffset` of each region is an offset into `data`
+  // and `dstOffset` into the buffer. Regions adjacent in both are coalesced, and all regions are
+  // copied by one transfer if `staging` is true.
+  void loadRegions(const void* data, std::vector<VkBufferCopy> regions, bool staging = true);
+
+  // The queue family using the buffer. The staging uploads of `load()` and `loadRegions()` run on
+  // the transfer queue and then transfer the ownership of the buffer to this family (graphics by
+  // default), so the buffer can stay VK_SHARING_MODE_EXCLUSIVE. An upload not covering the whole
+  // buffer first transfers the ownership from this family, which keeps the rest of the content.
+  void setOwnerQueueFamily(Device::QueueFamilyType owner) { _ownerQueueFamily = owner; }
+  [[nodiscard]] Device::QueueFamilyType ownerQueueFamily() const { return _ownerQueueFamily; }
 
   void bind(DeviceMemory& memory, VkDeviceSize offset = 0);
 
@@ -66,6 +80,12 @@ class Buffer : public Sharable<Buffer>, private NotCopyable {
   std::shared_ptr<DeviceMemory> _memory;
 
   std::weak_ptr<const Device> _device;
+
+ private:
+  void upload(const StagingBuffer& stagingBuffer, const std::vector<VkBufferCopy>& regions);
+
+  Device::QueueFamilyType _ownerQueueFamily = Device::QueueFamilyType::Graphics;
+  bool _hasContent = false; // Loaded before, so a partial upload has to keep the rest
 };
 
 MI_NAMESPACE_END(Vulk)
\ No newline at end of file
@@ -21,7 +21,7 @@ class CommandPool;
 class RenderPass;
 class Framebuffer;
 class Pipeline;
-class VertexBuffer;
+class Buffer;
 class IndexBuffer;
 class DescriptorSet;
 class Queue;
@@ -65,6 +65,12 @@ class CommandBuffer : public Sharable<CommandBuffer>, private NotCopyable {
                       const std::vector<Semaphore*>& signals = {},
                       const Fence& fence                     = {}) const;
   void submitCommands(const Fence& fence) const { submitCommands({}, {}, fence); }
+  // Submit to `queue` instead of the queue of the command pool, e.g. one from `QueuePool`. It has
+  // to be of the same queue family as the command pool.
+  void submitCommandsTo(const Queue& queue,
+                        const std::vector<Semaphore*>& waits   = {},
+                        const std::vector<Semaphore*>& signals = {},
+                        const Fence& fence                     = {}) const;
 
   void beginRenderPass(const RenderPass& renderPass,
                        const Framebuffer& framebuffer,
@@ -77,15 +83,67 @@ class CommandBuffer : public Sharable<CommandBuffer>, private NotCopyable {
                    const glm::vec2& extent,
                    const glm::vec2& depthRange = {0.0F, 1.0F}) const;
 
+  // Pipelines and descriptor sets are bound to the bind point (graphics or compute) of `pipeline`.
   void bindPipeline(const Pipeline& pipeline) const;
 
-  void bindVertexBuffer(const VertexBuffer& buffer, uint32_t binding, uint64_t offset = 0) const;
+  // `buffer` is a `VertexBuffer` or any buffer created with VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, e.g.
+  // a `StorageBuffer` with `AS_VERTEX_BUFFER`.
+  void bindVertexBuffer(const Buffer& buffer, uint32_t binding, uint64_t offset = 0) const;
   void bindIndexBuffer(const IndexBuffer& buffer, uint64_t offset = 0) const;
-  void bindDescriptorSet(const Pipeline& pipeline, const DescriptorSet& descriptorSet) const;
+  // Bind `descriptorSet` to `set` of `pipeline`. The sets bound to the other indices stay bound
+  // as long as the pipelines are layout compatible up to them.
+  void bindDescriptorSet(const Pipeline& pipeline,
+                         const DescriptorSet& descriptorSet,
+                         uint32_t set = 0) const;
+  // Write `size` bytes of `data` at `offset` of the push constants of `pipeline`.
+  void pushConstants(const Pipeline& pipeline,
+                     const void* data,
+                     uint32_t size,
+                     uint32_t offset = 0) const;
+  template <typename Constants>
+  void pushConstants(const Pipeline& pipeline, const Constants& constants) const {
+    pushConstants(pipeline, &constants, static_cast<uint32_t>(sizeof(Constants)));
+  }
 
   void draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0) const;
   void drawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0) const;
 
+  void dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) const;
+  // The group counts are read from a `VkDispatchIndirectCommand` at `offset` of `buffer`, which is
+  // created with VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT (e.g. `StorageBuffer::AS_INDIRECT_BUFFER`).
+  void dispatchIndirect(const Buffer& buffer, VkDeviceSize offset = 0) const;
+
+  void copyBuffer(const Buffer& src, const Buffer& dst, VkDeviceSize size) const;
+
+  // Make the `srcAccess` of `srcStage` to all resources available and visible to the `dstAccess` of
+  // `dstStage`. Cheaper than a barrier per resource when several ones are involved.
+  void memoryBarrier(VkPipelineStageFlags srcStage,
+                     VkAccessFlags srcAccess,
+                     VkPipelineStageFlags dstStage,
+                     VkAccessFlags dstAccess) const;
+
+  // Make the `srcAccess` of `srcStage` to `buffer` available and visible to the `dstAccess` of
+  // `dstStage`, e.g. compute shader writes to vertex attribute reads.
+  void bufferBarrier(const Buffer& buffer,
+                     VkPipelineStageFlags srcStage,
+                     VkAccessFlags srcAccess,
+                     VkPipelineStageFlags dstStage,
+                     VkAccessFlags dstAccess,
+                     uint32_t srcQueueFamily = VK_QUEUE_FAMILY_IGNORED,
+                     uint32_t dstQueueFamily = VK_QUEUE_FAMILY_IGNORED) const;
+
+  // Queue family ownership transfer of `buffer` between the queue family of this command buffer and
+  // `dstQueueFamily`/`srcQueueFamily`. The release must be followed by the matching acquire on the
+  // other family, ordered by a semaphore. Both are no-op if the families are the same.
+  void releaseBuffer(const Buffer& buffer,
+                     VkPipelineStageFlags srcStage,
+                     VkAccessFlags srcAccess,
+                     uint32_t dstQueueFamily) const;
+  void acquireBuffer(const Buffer& buffer,
+                     uint32_t srcQueueFamily,
+                     VkPipelineStageFlags dstStage,
+                     VkAccessFlags dstAccess) const;
+
   void reset();
 
   operator VkCommandBuffer() const { return _buffer; }
@@ -12,6 +12,7 @@ MI_NAMESPACE_BEGIN(Vulk)
 
 class DescriptorPool;
 class DescriptorSetLayout;
+class DescriptorUpdateTemplate;
 
 class DescriptorSet : public Sharable<DescriptorSet>, private NotCopyable {
  public:
@@ -28,6 +29,13 @@ class DescriptorSet : public Sharable<DescriptorSet>, private NotCopyable {
         : name(name), type(type), imageInfo(imageInfo) {}
   };
 
+  // The resource of a binding updated by a `DescriptorUpdateTemplate`, at the index of the binding
+  // (see `DescriptorUpdateTemplate::index()`)
+  union Info {
+    VkDescriptorBufferInfo buffer;
+    VkDescriptorImageInfo image;
+  };
+
  public:
   DescriptorSet() = default;
   DescriptorSet(const DescriptorPool& pool, const DescriptorSetLayout& layout);
@@ -40,6 +48,8 @@ class DescriptorSet : public Sharable<DescriptorSet>, private NotCopyable {
   void free();
 
   void bind(const std::vector<Binding>& bindings) const;
+  // Update all the bindings from `infos`, one per binding of the layout of `updateTemplate`.
+  void update(const DescriptorUpdateTemplate& updateTemplate, const Info* infos) const;
 
   operator VkDescriptorSet() const { return _set; }
   operator const VkDescriptorSet*() const { return &_set; }
@@ -22,14 +22,24 @@ class DescriptorSetLayout : public Sharable<DescriptorSetLayout>, private NotCop
 
  public:
   DescriptorSetLayout() = default;
-  DescriptorSetLayout(const Device& device, std::vector<const ShaderModule*> shaders);
-  DescriptorSetLayout(const Device& device, const VertexShader& vertShader, const FragmentShader& fragShader);
-  DescriptorSetLayout(const Device& device, const ComputeShader& compShader);
+  // The layout of the bindings of `set` in `shaders`. It has no binding if the shaders don't use
+  // `set`.
+  DescriptorSetLayout(const Device& device,
+                      std::vector<const ShaderModule*> shaders,
+                      uint32_t set = 0);
+  DescriptorSetLayout(const Device& device,
+                      const VertexShader& vertShader,
+                      const FragmentShader& fragShader,
+                      uint32_t set = 0);
+  DescriptorSetLayout(const Device& device, const ComputeShader& compShader, uint32_t set = 0);
   ~DescriptorSetLayout();
 
-  void create(const Device& device, std::vector<const ShaderModule*> shaders);
-  void create(const Device& device, const VertexShader& vertShader, const FragmentShader& fragShader);
-  void create(const Device& device, const ComputeShader& compShader);
+  void create(const Device& device, std::vector<const ShaderModule*> shaders, uint32_t set = 0);
+  void create(const Device& device,
+              const VertexShader& vertShader,
+              const FragmentShader& fragShader,
+              uint32_t set = 0);
+  void create(const Device& device, const ComputeShader& compShader, uint32_t set = 0);
   void destroy();
 
   operator VkDescriptorSetLayout() const { return _layout; }
@@ -37,6 +47,10 @@ class DescriptorSetLayout : public Sharable<DescriptorSetLayout>, private NotCop
 
   [[nodiscard]] bool isCreated() const { return _layout != VK_NULL_HANDLE; }
 
+  [[nodiscard]] uint32_t set() const { return _set; }
+  // The layout is shared with the other layouts of the same bindings (see `LayoutCache`).
+  [[nodiscard]] bool isShared() const { return _shared; }
+
   [[nodiscard]] const Device& device() const { return *_device.lock(); }
 
   [[nodiscard]] const std::vector<VkDescriptorPoolSize>& poolSizes() const { return _poolSizes; }
@@ -46,6 +60,8 @@ class DescriptorSetLayout : public Sharable<DescriptorSetLayout>, private NotCop
 
  private:
   VkDescriptorSetLayout _layout = VK_NULL_HANDLE;
+  uint32_t _set                 = 0;
+  bool _shared                  = false;
 
   std::vector<DescriptorSetLayoutBinding> _bindings;
   std::vector<VkDescriptorPoolSize> _poolSizes;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <volk/volk.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Vulk/internal/base.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+class Device;
+class DescriptorSetLayout;
+
+//
+// The update of all the bindings of a descriptor set layout from an array of
+// `DescriptorSet::Info`, one per binding in the order of `DescriptorSetLayout::bindings()`. The
+// names of the bindings are resolved to their indices in the array once by `index()`, so
+// `DescriptorSet::update()` neither allocates nor compares strings.
+//
+class DescriptorUpdateTemplate : public Sharable<DescriptorUpdateTemplate>, private NotCopyable {
+ public:
+  DescriptorUpdateTemplate() = default;
+  explicit DescriptorUpdateTemplate(const DescriptorSetLayout& layout);
+  ~DescriptorUpdateTemplate() override;
+
+  void create(const DescriptorSetLayout& layout);
+  void destroy();
+
+  operator VkDescriptorUpdateTemplate() const { return _template; }
+
+  static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+  // The index of the binding of `name` and `type` (as in the shaders) in the array of infos, or
+  // `kInvalidIndex` if the layout has no such binding, e.g. when the shader optimized it out
+  [[nodiscard]] uint32_t index(const std::string& name, const std::string& type) const;
+
+  [[nodiscard]] uint32_t numBindings() const { return static_cast<uint32_t>(_types.size()); }
+  [[nodiscard]] VkDescriptorType descriptorType(uint32_t index) const { return _types[index]; }
+
+  [[nodiscard]] bool isCreated() const { return _template != VK_NULL_HANDLE; }
+
+  [[nodiscard]] const Device& device() const { return *_device.lock(); }
+  [[nodiscard]] const DescriptorSetLayout& layout() const { return *_layout.lock(); }
+
+ private:
+  VkDescriptorUpdateTemplate _template = VK_NULL_HANDLE;
+
+  std::vector<VkDescriptorType> _types;
+
+  std::weak_ptr<const DescriptorSetLayout> _layout;
+  std::weak_ptr<const Device> _device;
+};
+
+MI_NAMESPACE_END(Vulk)
@@ -6,7 +6,9 @@
 #include <map>
 #include <memory>
 #include <functional>
+#include <mutex>
 #include <optional>
+#include <string>
 
 #include <Vulk/internal/base.h>
 #include <Vulk/PhysicalDevice.h>
@@ -15,28 +17,49 @@ MI_NAMESPACE_BEGIN(Vulk)
 
 class Instance;
 class Queue;
+class QueuePool;
+class ImageViewCache;
+class FramebufferCache;
+class LayoutCache;
+class PipelineCache;
 class CommandPool;
 
 class Device : public Sharable<Device>, private NotCopyable {
  public:
   using DeviceCreateInfoOverride = std::function<
       void(VkDeviceCreateInfo*, VkPhysicalDeviceFeatures*, std::vector<VkDeviceQueueCreateInfo>*)>;
+  // Called with the handle of a buffer, image view or sampler being destroyed
+  using HandleDestroyedCallback = std::function<void(uint64_t handle)>;
 
   enum QueueFamilyType { Graphics = 0, Compute, Transfer, Present, NUM_QUEUE_FAMILY_TYPES };
 
+  // The priorities, in [0, 1], of the queues created for each queue family. Its size is the number
+  // of queues per family, capped by the number the family supports. Queue 0 is the one returned by
+  // `queue()`; the others are handed out by the `QueuePool`.
+  using QueuePriorities = std::vector<float>;
+
+  // How the work is handed to the queues, see `Queue`.
+  enum class SubmissionMode { Direct, Threaded };
+
  public:
   Device(const PhysicalDevice& physicalDevice,
          const PhysicalDevice::QueueFamilies& requiredQueueFamilies,
          const std::vector<const char*>& extensions = {},
+         const QueuePriorities& queuePriorities     = {1.0F},
          const DeviceCreateInfoOverride& override   = {});
   ~Device() override;
 
   void create(const PhysicalDevice& physicalDevice,
               const PhysicalDevice::QueueFamilies& requiredQueueFamilies,
               const std::vector<const char*>& extensions = {},
+              const QueuePriorities& queuePriorities     = {1.0F},
               const DeviceCreateInfoOverride& override   = {});
   void initQueues();
   void initCommandPools();
+  void initCaches();
+  // The pipeline cache is loaded from `filename` and saved back by `destroy()`. Without
+  // `filename`, it's only kept in memory.
+  void initPipelineCache(const std::string& filename = {});
   void destroy();
 
   void waitIdle() const;
@@ -48,8 +71,37 @@ class Device : public Sharable<Device>, private NotCopyable {
 
   [[nodiscard]] Queue& queue(QueueFamilyType queueFamilyType);
   [[nodiscard]] const Queue& queue(QueueFamilyType queueFamilyType) const;
+  // All queues of the queue family of `queueFamilyType`, in the order of `QueuePriorities`
+  [[nodiscard]] const std::vector<std::shared_ptr<Queue>>& queues(
+      QueueFamilyType queueFamilyType) const;
+  [[nodiscard]] const QueuePool& queuePool() const { return *_queuePool; }
+  // Call `func` once for every queue of the device; the queue family types may share queues.
+  void forEachQueue(const std::function<void(const Queue&)>& func) const;
+  void setSubmissionMode(SubmissionMode mode);
+  void setQueueContentionTiming(bool enabled);
   [[nodiscard]] std::optional<uint32_t> queueFamilyIndex(QueueFamilyType queueFamilyType) const;
   [[nodiscard]] std::vector<uint32_t> queueFamilyIndices() const;
+  // Whether the queues of `type` and `other` are of different queue families, e.g. a transfer-only
+  // family backed by the DMA engines. Work on distinct families can overlap but resources shared
+  // between them need queue family ownership transfers. False if either is not enabled.
+  [[nodiscard]] bool isQueueFamilyDistinct(QueueFamilyType type, QueueFamilyType other) const;
+
+  // The image views and framebuffers reused across frames and the layouts shared by the pipelines,
+  // created by `initCaches()`
+  [[nodiscard]] ImageViewCache& imageViewCache() const { return *_imageViewCache; }
+  [[nodiscard]] FramebufferCache& framebufferCache() const { return *_framebufferCache; }
+  [[nodiscard]] LayoutCache& layoutCache() const { return *_layoutCache; }
+  [[nodiscard]] bool hasCaches() const { return _imageViewCache != nullptr; }
+  // Used by the creation of all the pipelines, created by `initPipelineCache()`
+  [[nodiscard]] PipelineCache& pipelineCache() const { return *_pipelineCache; }
+  [[nodiscard]] bool hasPipelineCache() const { return _pipelineCache != nullptr; }
+
+  // Let the objects referring to buffers, image views or samplers by handle, e.g. cached descriptor
+  // sets, drop the references before the handles are reused. The callbacks may be called from any
+  // thread and must not destroy such objects.
+  uint64_t addHandleDestroyedCallback(HandleDestroyedCallback callback) const;
+  void removeHandleDestroyedCallback(uint64_t id) const;
+  void notifyHandleDestroyed(uint64_t handle) const;
 
   [[nodiscard]] CommandPool& commandPool(QueueFamilyType queueFamilyType);
   [[nodiscard]] const CommandPool& commandPool(QueueFamilyType queueFamilyType) const;
@@ -66,10 +118,23 @@ class Device : public Sharable<Device>, private NotCopyable {
     uint32_t index;
   };
   std::vector<QueueFamily> _queueFamilies;
-
-  std::vector<std::shared_ptr<Queue>> _queues{NUM_QUEUE_FAMILY_TYPES};
+  QueuePriorities _queuePriorities;
+  std::map<uint32_t, uint32_t> _queueCounts; // queue family index -> number of queues
+
+  // Queue family index -> queues. The queue family types of the same family share the queues.
+  std::map<uint32_t, std::vector<std::shared_ptr<Queue>>> _familyQueues;
+  std::vector<std::shared_ptr<Queue>> _queues{NUM_QUEUE_FAMILY_TYPES}; // queue 0 of each type
+  std::shared_ptr<QueuePool> _queuePool;
+  std::shared_ptr<ImageViewCache> _imageViewCache;
+  std::shared_ptr<FramebufferCache> _framebufferCache;
+  std::shared_ptr<LayoutCache> _layoutCache;
+  std::shared_ptr<PipelineCache> _pipelineCache;
   std::vector<std::shared_ptr<CommandPool>> _commandPools{NUM_QUEUE_FAMILY_TYPES};
 
+  mutable std::mutex _callbackMutex;
+  mutable std::map<uint64_t, HandleDestroyedCallback> _handleDestroyedCallbacks;
+  mutable uint64_t _nextCallbackId = 0;
+
   std::weak_ptr<const PhysicalDevice> _physicalDevice;
 };
 
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <volk/volk.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include <Vulk/internal/base.h>
+#include <Vulk/Framebuffer.h>
+#include <Vulk/ImageView.h>
+#include <Vulk/RenderPass.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+class Device;
+
+//
+// The framebuffers of the device, created at the first request and reused after. A framebuffer is
+// keyed by its render pass, attachments and extent. Together with the views of `ImageViewCache`,
+// rendering to the same images again creates no Vulkan object.
+//
+// The framebuffers using a view are destroyed when the view is invalidated by `ImageViewCache`. A
+// frame still using one keeps it alive by `FrameContext::registerFramebuffer()`. The cache can be
+// used by several threads.
+//
+class FramebufferCache : public Sharable<FramebufferCache>, private NotCopyable {
+ public:
+  explicit FramebufferCache(const Device& device);
+  ~FramebufferCache();
+
+  [[nodiscard]] Framebuffer::shared_ptr framebuffer(
+      const RenderPass::shared_ptr& renderPass,
+      const ImageView::shared_ptr& colorAttachment,
+      const ImageView::shared_ptr& depthStencilAttachment = nullptr);
+
+  // Destroy the framebuffers using `view` as an attachment.
+  void invalidate(const ImageView& view);
+  void clear();
+
+  [[nodiscard]] size_t size() const;
+
+  [[nodiscard]] const Device& device() const { return *_device.lock(); }
+
+ private:
+  // Render pass, color attachment, depth/stencil attachment, width, height
+  using Key = std::tuple<VkRenderPass, VkImageView, VkImageView, uint32_t, uint32_t>;
+
+ private:
+  std::weak_ptr<const Device> _device;
+
+  mutable std::mutex _mutex;
+  std::map<Key, Framebuffer::shared_ptr> _framebuffers;
+};
+
+MI_NAMESPACE_END(Vulk)
@@ -73,6 +73,21 @@ class Image : public Sharable<Image>, private NotCopyable {
     transitToNewLayout(commandBuffer, newLayout, {}, {}, fence);
   }
 
+  // Queue family ownership transfer of the image between the queue family of `commandBuffer` and
+  // `dstQueueFamily`/`srcQueueFamily`, like `CommandBuffer::releaseBuffer()/acquireBuffer()`. The
+  // image is transitioned to `newLayout` by the release and the matching acquire on the other
+  // family. If the families are the same, the release is a plain layout transition and the acquire
+  // is no-op. Both only record the barrier; `commandBuffer` has to be recording.
+  void releaseOwnership(const CommandBuffer& commandBuffer,
+                        VkImageLayout newLayout,
+                        uint32_t dstQueueFamily) const;
+  void acquireOwnership(const CommandBuffer& commandBuffer, uint32_t srcQueueFamily) const;
+
+  // The content of the image is no longer needed, e.g. it's fully overwritten next. The next
+  // transition starts from VK_IMAGE_LAYOUT_UNDEFINED, which doesn't require the ownership of the
+  // queue family which used the image last.
+  void discardContent() const { _layout = VK_IMAGE_LAYOUT_UNDEFINED; }
+
   operator VkImage() const { return _image; }
 
   [[nodiscard]] VkImageType type() const { return _type; }
@@ -83,6 +98,8 @@ class Image : public Sharable<Image>, private NotCopyable {
   [[nodiscard]] uint32_t height() const { return _extent.height; }
   [[nodiscard]] uint32_t depth() const { return _extent.depth; }
 
+  [[nodiscard]] VkImageLayout layout() const { return _layout; }
+
   [[nodiscard]] bool isCreated() const { return _image != VK_NULL_HANDLE; }
   [[nodiscard]] bool isAllocated() const {
     return isCreated() && (_memory && _memory->isAllocated());
@@ -96,6 +113,12 @@ class Image : public Sharable<Image>, private NotCopyable {
  protected:
   void create(const Device& device, const VkImageCreateInfo& imageInfo);
 
+  void recordBarrier(const CommandBuffer& commandBuffer,
+                     VkImageLayout oldLayout,
+                     VkImageLayout newLayout,
+                     uint32_t srcQueueFamily,
+                     uint32_t dstQueueFamily) const;
+
  protected:
   VkImage _image = VK_NULL_HANDLE;
 
@@ -104,6 +127,10 @@ class Image : public Sharable<Image>, private NotCopyable {
   VkExtent3D _extent            = {0, 0, 0};
   mutable VkImageLayout _layout = VK_IMAGE_LAYOUT_UNDEFINED;
 
+  // The layout before the pending release; the acquire has to repeat the same transition.
+  mutable VkImageLayout _releasedLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  mutable bool _released                = false;
+
   std::shared_ptr<DeviceMemory> _memory;
 
   std::weak_ptr<const Device> _device;
@@ -38,6 +38,10 @@ class ImageView : public Sharable<ImageView>, private NotCopyable {
 
   operator VkImageView() const { return _view; }
 
+  // The aspects viewed by `create()`
+  [[nodiscard]] static VkImageAspectFlags aspectMask(const Image2D& image);
+  [[nodiscard]] static VkImageAspectFlags aspectMask(const DepthImage& image);
+
   [[nodiscard]] const Image& image() const { return *_image.lock(); }
 
   [[nodiscard]] const Device& device() const { return *_device.lock(); }
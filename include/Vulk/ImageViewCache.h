@@ -0,0 +1,67 @@
+#pragma once
+
+#include <volk/volk.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include <Vulk/internal/base.h>
+#include <Vulk/ImageView.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+class Device;
+class Image;
+class Image2D;
+class DepthImage;
+
+//
+// The image views of the device, created at the first request and reused after. A view is keyed by
+// its image, format, view type and subresource range, so it's the same as the one `ImageView`
+// creates for the image.
+//
+// The views of an image are destroyed with the image (see `Image::destroy()`), along with the
+// framebuffers using them in the `FramebufferCache`. The cache can be used by several threads.
+//
+class ImageViewCache : public Sharable<ImageViewCache>, private NotCopyable {
+ public:
+  explicit ImageViewCache(const Device& device);
+  ~ImageViewCache();
+
+  [[nodiscard]] ImageView::shared_ptr view(const Image2D& image);
+  [[nodiscard]] ImageView::shared_ptr view(const DepthImage& image);
+
+  // Destroy the views of `image`, e.g. before the image is destroyed and its handle reused.
+  void invalidate(const Image& image);
+  void clear();
+
+  [[nodiscard]] size_t size() const;
+
+  [[nodiscard]] const Device& device() const { return *_device.lock(); }
+
+ private:
+  // Image, format, view type, aspects, base mip level, mip levels, base array layer, array layers
+  using Key = std::tuple<VkImage,
+                         VkFormat,
+                         VkImageViewType,
+                         VkImageAspectFlags,
+                         uint32_t,
+                         uint32_t,
+                         uint32_t,
+                         uint32_t>;
+
+  template <typename ImageType>
+  ImageView::shared_ptr findOrCreate(const ImageType& image);
+
+  static Key keyOf(const Image& image, VkImageAspectFlags aspectMask);
+
+ private:
+  std::weak_ptr<const Device> _device;
+
+  mutable std::mutex _mutex;
+  std::map<Key, ImageView::shared_ptr> _views;
+};
+
+MI_NAMESPACE_END(Vulk)
@@ -21,6 +21,12 @@ class IndexBuffer : public Buffer {
   IndexBuffer(const Device& device, const std::vector<Index>& indices, bool hostVisible = false) {
     create(device, indices, hostVisible);
   }
+  // `indices` points to `numIndices` packed indices of `indexType`.
+  IndexBuffer(const Device& device,
+              const void* indices,
+              size_t numIndices,
+              VkIndexType indexType,
+              bool hostVisible = false);
 
   // Buffer will be device local and can only be loaded using a staging buffer
   void create(const Device& device, VkDeviceSize size, bool hostVisible = false);
@@ -28,9 +34,17 @@ class IndexBuffer : public Buffer {
   // staging buffer
   template <typename Index>
   void create(const Device& device, const std::vector<Index>& indices, bool hostVisible = false);
+  void create(const Device& device,
+              const void* indices,
+              size_t numIndices,
+              VkIndexType indexType,
+              bool hostVisible = false);
 
   VkIndexType indexType() const { return _indexType; }
 
+  // Return the size of an index in bytes
+  static uint32_t indexSize(VkIndexType indexType);
+
   //
   // Override the sharable types and functions
   //
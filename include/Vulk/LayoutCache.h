@@ -0,0 +1,69 @@
+#pragma once
+
+#include <volk/volk.h>
+
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <Vulk/internal/base.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+class Device;
+
+//
+// The descriptor set layouts and pipeline layouts of the device, created at the first request and
+// shared after. A descriptor set layout is keyed by its bindings (binding, type, count and stages)
+// and a pipeline layout by its set layouts and push constant range, so the pipelines with the same
+// shader interfaces get the same layouts. Their descriptor sets are then compatible and stay bound
+// when switching between them, and `DescriptorSetManager` caches the sets across them.
+//
+// The layouts are owned by the cache and destroyed with it. `DescriptorSetLayout` and `Pipeline`
+// use the cache when the device has it (see `Device::initCaches()`). The cache can be used by
+// several threads.
+//
+class LayoutCache : public Sharable<LayoutCache>, private NotCopyable {
+ public:
+  explicit LayoutCache(const Device& device);
+  ~LayoutCache();
+
+  [[nodiscard]] VkDescriptorSetLayout descriptorSetLayout(
+      std::span<const VkDescriptorSetLayoutBinding> bindings);
+  // `setLayouts` must be from `descriptorSetLayout()`: a layout destroyed before the cache could
+  // have its handle reused by another one, which would get the stale pipeline layout.
+  [[nodiscard]] VkPipelineLayout pipelineLayout(std::span<const VkDescriptorSetLayout> setLayouts,
+                                                const VkPushConstantRange& pushConstantRange);
+
+  // Destroy all the layouts. None of them may be used by a pipeline or a descriptor set anymore.
+  void clear();
+
+  [[nodiscard]] size_t numDescriptorSetLayouts() const;
+  [[nodiscard]] size_t numPipelineLayouts() const;
+
+  [[nodiscard]] const Device& device() const { return *_device.lock(); }
+
+ private:
+  struct Key {
+    std::vector<uint64_t> contents;
+    size_t hash = 0;
+
+    bool operator==(const Key& other) const { return contents == other.contents; }
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const { return key.hash; }
+  };
+
+  static void hash(Key& key);
+
+ private:
+  std::weak_ptr<const Device> _device;
+
+  mutable std::mutex _mutex;
+  std::unordered_map<Key, VkDescriptorSetLayout, KeyHash> _descriptorSetLayouts;
+  std::unordered_map<Key, VkPipelineLayout, KeyHash> _pipelineLayouts;
+};
+
+MI_NAMESPACE_END(Vulk)
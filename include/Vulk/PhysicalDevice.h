@@ -59,8 +59,10 @@ class PhysicalDevice : public Sharable<PhysicalDevice>, private NotCopyable {
                    const PhysicalDevice::HasDeviceFeaturesFunc& hasPhysicalDeviceFeatures);
   void reset();
 
+  // `queuePriorities` is a `Device::QueuePriorities`.
   std::shared_ptr<Device> createDevice(const QueueFamilies& requiredQueueFamilies,
-                                       const std::vector<const char*>& extensions = {}) const;
+                                       const std::vector<const char*>& extensions = {},
+                                       const std::vector<float>& queuePriorities  = {1.0F}) const;
 
   void initQueueFamilies(const Surface& surface);
   void initQueueFamilies();
@@ -69,6 +71,10 @@ class PhysicalDevice : public Sharable<PhysicalDevice>, private NotCopyable {
 
   [[nodiscard]] const QueueFamilies& queueFamilies() const { return _queueFamilies; }
 
+  [[nodiscard]] VkPhysicalDeviceProperties properties() const;
+  // Nanoseconds per timestamp tick
+  [[nodiscard]] float timestampPeriod() const { return properties().limits.timestampPeriod; }
+
   [[nodiscard]] const Instance& instance() const { return *_instance.lock(); }
 
   [[nodiscard]] bool isInstantiated() const { return _device != VK_NULL_HANDLE; }
@@ -4,11 +4,13 @@
 
 #include <vector>
 #include <limits>
+#include <map>
 #include <memory>
 
 #include <Vulk/internal/base.h>
 
 #include <Vulk/DescriptorSetLayout.h>
+#include <Vulk/DescriptorUpdateTemplate.h>
 
 MI_NAMESPACE_BEGIN(Vulk)
 
@@ -17,6 +19,7 @@ class RenderPass;
 class VertexShader;
 class FragmentShader;
 class ComputeShader;
+class ShaderModule;
 
 class Pipeline : public Sharable<Pipeline>, private NotCopyable {
  public:
@@ -48,6 +51,10 @@ class Pipeline : public Sharable<Pipeline>, private NotCopyable {
       VkStencilOpState back{};
       //TODO Add more stencil test parameters to directly config StencilOpState front and back
     } stencilTest;
+
+    // The layouts of the sets owned by the caller instead of reflected from the shaders, by set,
+    // e.g. `BindlessTextureTable::layout()` at `BindlessTextureTable::kSet`
+    std::map<uint32_t, VkDescriptorSetLayout> externalSetLayouts;
   };
 
  public:
@@ -56,6 +63,7 @@ class Pipeline : public Sharable<Pipeline>, private NotCopyable {
            const VertexShader& vertShader,
            const FragmentShader& fragShader,
            const Configuration& config = {});
+  Pipeline(const Device& device, const ComputeShader& compShader);
   ~Pipeline() override;
 
   void create(const Device& device,
@@ -68,11 +76,29 @@ class Pipeline : public Sharable<Pipeline>, private NotCopyable {
 
   operator VkPipeline() const { return _pipeline; }
   [[nodiscard]] VkPipelineLayout layout() const { return _layout; }
+  [[nodiscard]] VkPipelineBindPoint bindPoint() const { return _bindPoint; }
+  // The push constants of all the stages, reflected from the shaders. Its size is 0 if none.
+  [[nodiscard]] const VkPushConstantRange& pushConstantRange() const { return _pushConstantRange; }
 
   [[nodiscard]] bool isCreated() const { return _pipeline != VK_NULL_HANDLE; }
 
-  [[nodiscard]] const DescriptorSetLayout::shared_ptr& descriptorSetLayout() const {
-    return _descriptorSetLayout;
+  // The sets are numbered as in the shaders, so they can be split by how often they change (e.g.
+  // per frame, per material and per draw) and bound separately. The sets not used by the shaders
+  // below the highest one have empty layouts.
+  [[nodiscard]] uint32_t numDescriptorSets() const {
+    return static_cast<uint32_t>(_descriptorSetLayouts.size());
+  }
+  // Null for the sets of `Configuration::externalSetLayouts`
+  [[nodiscard]] const DescriptorSetLayout::shared_ptr& descriptorSetLayout(uint32_t set = 0) const {
+    return _descriptorSetLayouts[set];
+  }
+  [[nodiscard]] const std::vector<DescriptorSetLayout::shared_ptr>& descriptorSetLayouts() const {
+    return _descriptorSetLayouts;
+  }
+  // Null if the layout of `set` has no bindings or is external
+  [[nodiscard]] const DescriptorUpdateTemplate::shared_ptr& descriptorUpdateTemplate(
+      uint32_t set = 0) const {
+    return _descriptorUpdateTemplates[set];
   }
 
   template <typename VertexInput>
@@ -89,11 +115,22 @@ class Pipeline : public Sharable<Pipeline>, private NotCopyable {
 
   [[nodiscard]] const Device& device() const { return *_device.lock(); }
 
+ private:
+  // Create the set layouts, their update templates and `_layout` from `shaders`.
+  void createLayout(const Device& device,
+                    const std::vector<const ShaderModule*>& shaders,
+                    const std::map<uint32_t, VkDescriptorSetLayout>& externalSetLayouts = {});
+
  private:
   VkPipeline _pipeline     = VK_NULL_HANDLE;
   VkPipelineLayout _layout = VK_NULL_HANDLE;
+  bool _sharedLayout       = false; // Owned by the `LayoutCache` of the device
+
+  VkPipelineBindPoint _bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  VkPushConstantRange _pushConstantRange{};
 
-  DescriptorSetLayout::shared_ptr _descriptorSetLayout;
+  std::vector<DescriptorSetLayout::shared_ptr> _descriptorSetLayouts; // By set
+  std::vector<DescriptorUpdateTemplate::shared_ptr> _descriptorUpdateTemplates;
 
   std::vector<VkVertexInputBindingDescription> _vertexInputBindings;
 
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <volk/volk.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <Vulk/internal/base.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+class Device;
+
+//
+// The pipeline cache of the device, used to create all the pipelines (see `Pipeline`). It's loaded
+// from a file at creation and saved back at destruction, so the pipelines compiled by a run are
+// reused by the next ones instead of being compiled from SPIR-V again.
+//
+// The data of the file is only used if its header matches the physical device (vendor, device and
+// cache UUID), e.g. not after a driver update. The file is replaced atomically, so an interrupted
+// save leaves the previous one.
+//
+class PipelineCache : public Sharable<PipelineCache>, private NotCopyable {
+ public:
+  struct Statistics {
+    size_t loadedSize     = 0; // The data loaded from the file, 0 for a cold start
+    uint32_t numPipelines = 0;
+    std::chrono::nanoseconds creationTime{0}; // Of all the pipelines
+  };
+
+ public:
+  PipelineCache() = default;
+  // Without `filename`, the cache is only kept in memory.
+  explicit PipelineCache(const Device& device, const std::string& filename = {});
+  ~PipelineCache() override;
+
+  void create(const Device& device, const std::string& filename = {});
+  void destroy();
+
+  // Write the data of the cache to the file. False if it failed, keeping the previous file.
+  bool save() const;
+
+  // Called by `Pipeline` for the time spent in creating a pipeline with the cache
+  void addCreationTime(std::chrono::nanoseconds time);
+
+  operator VkPipelineCache() const { return _cache; }
+
+  [[nodiscard]] Statistics statistics() const;
+  [[nodiscard]] const std::string& filename() const { return _filename; }
+
+  [[nodiscard]] bool isCreated() const { return _cache != VK_NULL_HANDLE; }
+
+  [[nodiscard]] const Device& device() const { return *_device.lock(); }
+
+ private:
+  // Whether `data` was written by a device of the same vendor, device and cache UUID
+  bool isCompatible(const void* data, size_t size) const;
+
+ private:
+  VkPipelineCache _cache = VK_NULL_HANDLE;
+  std::string _filename;
+
+  size_t _loadedSize = 0;
+  std::atomic<uint32_t> _numPipelines{0};
+  std::atomic<int64_t> _creationTime{0}; // In nanoseconds
+
+  std::weak_ptr<const Device> _device;
+};
+
+MI_NAMESPACE_END(Vulk)
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <volk/volk.h>
+
+#include <memory>
+#include <vector>
+
+#include <Vulk/internal/base.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+class Device;
+class CommandBuffer;
+
+class QueryPool : public Sharable<QueryPool>, private NotCopyable {
+ public:
+  QueryPool() = default;
+  QueryPool(const Device& device, VkQueryType type, uint32_t count);
+  ~QueryPool() override;
+
+  void create(const Device& device, VkQueryType type, uint32_t count);
+  void destroy();
+
+  // Queries must be reset before they are written again.
+  void reset(const CommandBuffer& commandBuffer, uint32_t first = 0, uint32_t count = ~0U) const;
+  void writeTimestamp(const CommandBuffer& commandBuffer,
+                      VkPipelineStageFlagBits stage,
+                      uint32_t query) const;
+
+  // Return false if the results are not available yet. With `wait`, wait for the queries to finish.
+  bool results(uint32_t first,
+               uint32_t count,
+               std::vector<uint64_t>& values,
+               bool wait = false) const;
+
+  operator VkQueryPool() const { return _pool; }
+
+  [[nodiscard]] VkQueryType type() const { return _type; }
+  [[nodiscard]] uint32_t count() const { return _count; }
+
+  [[nodiscard]] bool isCreated() const { return _pool != VK_NULL_HANDLE; }
+
+  [[nodiscard]] const Device& device() const { return *_device.lock(); }
+
+ private:
+  VkQueryPool _pool = VK_NULL_HANDLE;
+  VkQueryType _type = VK_QUERY_TYPE_TIMESTAMP;
+  uint32_t _count   = 0;
+
+  std::weak_ptr<const Device> _device;
+};
+
+MI_NAMESPACE_END(Vulk)
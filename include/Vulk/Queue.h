@@ -2,8 +2,16 @@
 
 #include <volk/volk.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+#include <tbb/concurrent_queue.h>
+
 // Defined in CMakeLists.txt:GLM_FORCE_DEPTH_ZERO_TO_ONE, GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
 
@@ -16,16 +24,41 @@ MI_NAMESPACE_BEGIN(Vulk)
 
 class CommandBuffer;
 
+//
+// A queue of the device. Submissions (and everything else requiring the external synchronization
+// of VkQueue) are serialized by a lock of the queue, so a queue can be shared by threads. Queue
+// family types (see `Device::QueueFamilyType`) of the same queue family share the `Queue` objects.
+//
+// In `SubmissionMode::Threaded`, the submissions, presents and labels are handed to a submission
+// thread of the queue through a lock-free queue and run in order there. The callers don't block on
+// the driver, except `present()` and `waitIdle()` which wait for their result.
+// A submission waiting on a semaphore signaled by another queue first flushes that queue, so the
+// signal is always submitted before the wait.
+//
 class Queue : public Sharable<Queue>, private NotCopyable {
  public:
-  Queue(const Device& device, Device::QueueFamilyType queueFamily, uint32_t queueFamilyIndex);
+  using SubmissionMode = Device::SubmissionMode;
+
+  // The time the submissions waited for the queue: for the lock held by another thread in `Direct`
+  // mode, or behind the backlog of the submission thread in `Threaded` mode.
+  struct Contention {
+    uint64_t numSubmissions = 0;
+    uint64_t numContended   = 0; // The submissions which had to wait
+    std::chrono::nanoseconds waitTime{0};
+  };
+
+ public:
+  Queue(const Device& device,
+        uint32_t queueFamilyIndex,
+        uint32_t queueIndex = 0,
+        float priority      = 1.0F);
   ~Queue() override;
 
   operator VkQueue() const { return _queue; }
 
-  Device::QueueFamilyType queueFamily() const { return _queueFamily; }
   uint32_t queueFamilyIndex() const { return _queueFamilyIndex; }
   uint32_t queueIndex() const { return _queueIndex; }
+  float priority() const { return _priority; }
 
   void submitCommands(const CommandBuffer& commandBuffer,
                       const std::vector<Semaphore*>& waits   = {},
@@ -34,9 +67,32 @@ class Queue : public Sharable<Queue>, private NotCopyable {
   void submitCommands(const CommandBuffer& commandBuffer, const Fence& fence) const {
     submitCommands(commandBuffer, {}, {}, fence);
   }
+  // One submission of `commandBuffers`, executed in order as if recorded into one command buffer,
+  // e.g. the ones recorded by several threads.
+  void submitCommands(const std::vector<const CommandBuffer*>& commandBuffers,
+                      const std::vector<Semaphore*>& waits   = {},
+                      const std::vector<Semaphore*>& signals = {},
+                      const Fence& fence                     = {}) const;
+
+  // Returns the result of vkQueuePresentKHR, e.g. VK_SUBOPTIMAL_KHR.
+  VkResult present(const VkPresentInfoKHR& presentInfo) const;
 
   void waitIdle() const;
 
+  void setSubmissionMode(SubmissionMode mode);
+  [[nodiscard]] SubmissionMode submissionMode() const { return _submissionMode; }
+  // Wait until the submission thread has run everything handed to it before the call. The work
+  // handed in meanwhile by other threads doesn't delay the return.
+  void flush() const;
+  // Flush the other queues with submissions signaling `waits`. A wait on a binary semaphore must be
+  // submitted after its signal, which the submission threads of different queues don't order.
+  void flushSignals(const std::vector<Semaphore*>& waits) const;
+
+  // Off by default as it reads the clock for every submission.
+  void setContentionTiming(bool enabled) { _contentionTiming = enabled; }
+  [[nodiscard]] Contention contention() const;
+  void resetContention();
+
   const Device& device() const { return *_device.lock(); }
 
   void beginLabel(const char* label, const glm::vec4& color = {0.8F, 0.2F, 0.1F, 1.0F}) const;
@@ -56,12 +112,53 @@ class Queue : public Sharable<Queue>, private NotCopyable {
       const char* label,
       const glm::vec4& color = {0.8F, 0.2F, 0.1F, 1.0F}) const;
 
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct SubmitBatch {
+    std::vector<VkCommandBuffer> commandBuffers;
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<VkPipelineStageFlags> waitStages;
+    std::vector<VkSemaphore> signalSemaphores;
+    VkFence fence = VK_NULL_HANDLE;
+  };
+  struct Work {
+    std::function<void()> run; // Stops the submission thread if empty
+  };
+
+  void submit(const SubmitBatch& batch) const;
+  // Run `work` with the queue locked, or hand it to the submission thread. `isSubmission` selects
+  // the work counted by `contention()`.
+  void execute(std::function<void()> work, bool isSubmission = false) const;
+  void enqueue(Work item) const;
+  void runSubmissionThread() const;
+  void stopSubmissionThread();
+  void addContention(Clock::duration waitTime, bool contended) const;
+
  private:
   VkQueue _queue = VK_NULL_HANDLE;
 
-  Device::QueueFamilyType _queueFamily;
   uint32_t _queueFamilyIndex;
   uint32_t _queueIndex;
+  float _priority;
+
+  mutable std::mutex _mutex;
+
+  SubmissionMode _submissionMode = SubmissionMode::Direct;
+  std::thread _submissionThread;
+  mutable tbb::concurrent_queue<Work> _work;
+  // The tickets of the work handed in and run. The work is run in the order of its tickets, so
+  // `flush()` waits for the ticket of the last work handed in before it, not for an empty queue.
+  mutable std::atomic<uint64_t> _enqueuedWork  = 0;
+  mutable std::atomic<uint64_t> _completedWork = 0;
+  // Orders the tickets like the pushes to `_work`. The submission thread waits on it for work.
+  mutable std::mutex _workMutex;
+  mutable std::condition_variable _workAvailable;
+
+  std::atomic<bool> _contentionTiming = false;
+  mutable std::atomic<uint64_t> _numSubmissions = 0;
+  mutable std::atomic<uint64_t> _numContended   = 0;
+  mutable std::atomic<int64_t> _waitTime        = 0; // In nanoseconds
 
   std::weak_ptr<const Device> _device;
 };
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <volk/volk.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <Vulk/internal/base.h>
+#include <Vulk/Device.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+class Queue;
+
+//
+// Hands out the queues of the device (see `Device::QueuePriorities`) per workload or per thread,
+// so independent submissions don't serialize on one VkQueue. If a queue family has fewer queues
+// than asked for, the workloads or threads share them, which is still safe since `Queue` locks its
+// submissions.
+//
+class QueuePool : public Sharable<QueuePool>, private NotCopyable {
+ public:
+  enum class Workload {
+    Streaming,    // Uploads on the transfer queue family
+    AsyncCompute, // Compute work overlapping the rendering, on the compute queue family
+    Background    // Low priority work on the graphics queue family
+  };
+
+ public:
+  explicit QueuePool(const Device& device);
+
+  [[nodiscard]] const Queue& queue(Workload workload) const;
+
+  // The queue of `queueFamilyType` for the calling thread. Threads are assigned to the queues of
+  // the family round-robin at their first call.
+  [[nodiscard]] const Queue& threadQueue(Device::QueueFamilyType queueFamilyType) const;
+
+  [[nodiscard]] const Device& device() const { return *_device.lock(); }
+
+ private:
+  // Queue 0 of `queueFamilyType`, or queue 1 if queue 0 is also the main queue of `mainType`.
+  [[nodiscard]] const Queue& sideQueue(Device::QueueFamilyType queueFamilyType,
+                                       Device::QueueFamilyType mainType) const;
+
+ private:
+  std::weak_ptr<const Device> _device;
+
+  mutable std::mutex _mutex;
+  mutable std::map<std::thread::id, uint32_t> _threadSlots;
+};
+
+MI_NAMESPACE_END(Vulk)
@@ -2,6 +2,7 @@
 
 #include <volk/volk.h>
 
+#include <atomic>
 #include <memory>
 
 #include <Vulk/internal/base.h>
@@ -9,6 +10,7 @@
 MI_NAMESPACE_BEGIN(Vulk)
 
 class Device;
+class Queue;
 
 class Semaphore : public Sharable<Semaphore>, private NotCopyable {
  public:
@@ -21,6 +23,13 @@ class Semaphore : public Sharable<Semaphore>, private NotCopyable {
 
   operator VkSemaphore() const { return _semaphore; }
 
+  // The queue of the last submission signaling the semaphore, set by `Queue::submitCommands()`. A
+  // wait takes it to make sure the signal is submitted first (see `Queue::flushSignals()`).
+  void setSignalingQueue(const Queue* queue) const { _signalingQueue = queue; }
+  [[nodiscard]] const Queue* takeSignalingQueue() const {
+    return _signalingQueue.exchange(nullptr);
+  }
+
   [[nodiscard]] bool isCreated() const { return _semaphore != VK_NULL_HANDLE; }
 
   [[nodiscard]] const Device& device() const { return *_device.lock(); }
@@ -28,6 +37,8 @@ class Semaphore : public Sharable<Semaphore>, private NotCopyable {
  private:
   VkSemaphore _semaphore = VK_NULL_HANDLE;
 
+  mutable std::atomic<const Queue*> _signalingQueue = nullptr;
+
   std::weak_ptr<const Device> _device;
 };
 
@@ -19,10 +19,12 @@ class ShaderModule : public Sharable<ShaderModule>, private NotCopyable {
   struct DescriptorSetLayoutBinding {
     std::string name;
     std::string type;
+    uint32_t set = 0;
     VkDescriptorSetLayoutBinding vkBinding{};
 
     bool operator==(const DescriptorSetLayoutBinding& rhs) const {
-      return name == rhs.name && type == rhs.type && vkBinding.binding == rhs.vkBinding.binding &&
+      return name == rhs.name && type == rhs.type && set == rhs.set &&
+             vkBinding.binding == rhs.vkBinding.binding &&
              vkBinding.descriptorType == rhs.vkBinding.descriptorType &&
              vkBinding.descriptorCount == rhs.vkBinding.descriptorCount &&
              vkBinding.stageFlags == rhs.vkBinding.stageFlags;
@@ -47,6 +49,7 @@ class ShaderModule : public Sharable<ShaderModule>, private NotCopyable {
   virtual ~ShaderModule() override;
 
   void create(const Device& device, const std::vector<char>& codes, bool reflection = true);
+  void create(const Device& device, const void* codes, size_t codeSize, bool reflection = true);
   void create(const Device& device, const char* shaderFile, bool reflection = true);
   void destroy();
 
@@ -58,11 +61,18 @@ class ShaderModule : public Sharable<ShaderModule>, private NotCopyable {
                                      const std::string& type,
                                      uint32_t binding,
                                      VkDescriptorType descriptorType,
-                                     VkShaderStageFlags stageFlags);
+                                     VkShaderStageFlags stageFlags,
+                                     uint32_t set = 0);
 
+  // The bindings of all the sets, see `DescriptorSetLayoutBinding::set`
   [[nodiscard]] const std::vector<DescriptorSetLayoutBinding>& descriptorSetLayoutBindings() const {
     return _descriptorSetLayoutBindings;
   }
+  // One more than the highest set of the bindings, 0 if there is no binding
+  [[nodiscard]] uint32_t numDescriptorSets() const;
+  // The end of the push constant block of the shader, in bytes. 0 if it has none.
+  [[nodiscard]] uint32_t pushConstantSize() const { return _pushConstantSize; }
+  [[nodiscard]] VkShaderStageFlags stage() const { return _stage; }
 
   void setEntry(const char* entry) { _entry = entry; }
   [[nodiscard]] const char* entry() const { return _entry.c_str(); }
@@ -73,9 +83,10 @@ class ShaderModule : public Sharable<ShaderModule>, private NotCopyable {
   static void disablePrintReflection();
 
  private:
-  void reflectShader(const std::vector<char>& codes);
+  void reflectShader(const void* codes, size_t codeSize);
   void reflectDescriptorSets(const SpvReflectShaderModule& module);
   void reflectVertexInputs(const SpvReflectShaderModule& module);
+  void reflectPushConstants(const SpvReflectShaderModule& module);
 
  protected:
   VkShaderModule _shader = VK_NULL_HANDLE;
@@ -86,6 +97,9 @@ class ShaderModule : public Sharable<ShaderModule>, private NotCopyable {
   std::vector<VertexInputAttribute> _vertexInputAttributes;
   std::vector<VkVertexInputBindingDescription> _vertexInputBindings;
 
+  VkShaderStageFlags _stage  = 0;
+  uint32_t _pushConstantSize = 0;
+
   std::weak_ptr<const Device> _device;
 };
 
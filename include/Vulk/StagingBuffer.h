@@ -24,6 +24,10 @@ class StagingBuffer : public Buffer {
   void copyFromHost(const void* src, VkDeviceSize size) { copyFromHost(src, 0, size); }
   void copyFromHost(const void* src, VkDeviceSize offset, VkDeviceSize size);
 
+  // The staging memory stays mapped for the lifetime of the buffer so producers (e.g. file
+  // readers) can write into it directly.
+  [[nodiscard]] uint8_t* mappedData() const { return _mappedData; }
+
   void copyToBuffer(const CommandBuffer& commandBuffer,
                     Buffer& dst,
                     const VkBufferCopy& roi,
@@ -36,6 +40,13 @@ class StagingBuffer : public Buffer {
                     const std::vector<Semaphore*>& waits   = {},
                     const std::vector<Semaphore*>& signals = {},
                     const Fence& fence                     = {}) const;
+  // Copy all regions with one vkCmdCopyBuffer.
+  void copyToBuffer(const CommandBuffer& commandBuffer,
+                    Buffer& dst,
+                    const std::vector<VkBufferCopy>& regions,
+                    const std::vector<Semaphore*>& waits   = {},
+                    const std::vector<Semaphore*>& signals = {},
+                    const Fence& fence                     = {}) const;
   void copyToImage(const CommandBuffer& commandBuffer,
                    Image& dst,
                    const VkBufferImageCopy& roi,
@@ -62,6 +73,12 @@ class StagingBuffer : public Buffer {
                     const Fence& fence) const {
     copyToBuffer(commandBuffer, dst, size, {}, {}, fence);
   }
+  void copyToBuffer(const CommandBuffer& commandBuffer,
+                    Buffer& dst,
+                    const std::vector<VkBufferCopy>& regions,
+                    const Fence& fence) const {
+    copyToBuffer(commandBuffer, dst, regions, {}, {}, fence);
+  }
   void copyToImage(const CommandBuffer& commandBuffer,
                    Image& dst,
                    const VkBufferImageCopy& roi,
@@ -80,6 +97,9 @@ class StagingBuffer : public Buffer {
   // Override the sharable types and functions
   //
   MI_DEFINE_SHARED_PTR(StagingBuffer, Buffer);
+
+ private:
+  uint8_t* _mappedData = nullptr;
 };
 
 MI_NAMESPACE_END(Vulk)
\ No newline at end of file
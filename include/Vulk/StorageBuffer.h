@@ -18,9 +18,10 @@ class CommandBuffer;
 class StorageBuffer : public Buffer {
  public:
   enum Property : uint8_t {
-    NONE              = 0x00,
-    HOST_VISIBLE      = 0x01 << 0,
-    AS_VERTEX_BUFFER  = 0x01 << 1
+    NONE               = 0x00,
+    HOST_VISIBLE       = 0x01 << 0,
+    AS_VERTEX_BUFFER   = 0x01 << 1,
+    AS_INDIRECT_BUFFER = 0x01 << 2 // e.g. the arguments of `CommandBuffer::dispatchIndirect()`
   };
 
  public:
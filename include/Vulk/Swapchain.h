@@ -2,6 +2,7 @@
 
 #include <volk/volk.h>
 
+#include <atomic>
 #include <functional>
 #include <vector>
 #include <limits>
@@ -112,7 +113,8 @@ class Swapchain : public Sharable<Swapchain>, private NotCopyable {
   std::weak_ptr<const Device> _device;
   std::weak_ptr<const Surface> _surface;
 
-  mutable bool _requiredRecreate = false;
+  // Set by `present()`, which may run on the present thread, and cleared by `create()`
+  mutable std::atomic<bool> _requiredRecreate = false;
 };
 
 MI_NAMESPACE_END(Vulk)
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include <volk/volk.h>
 
+#include <span>
+#include <vector>
+
 #include <Vulk/internal/base.h>
 #include <Vulk/internal/helpers.h>
 #include <Vulk/internal/debug.h>
@@ -20,6 +23,11 @@ class VertexBuffer : public Buffer {
  public:
   enum Property : uint8_t { NONE = 0x00, HOST_VISIBLE = 0x01 << 0, AS_STORAGE_BUFFER = 0x01 << 1 };
 
+  struct Range {
+    size_t first; // index of the first vertex
+    size_t count; // number of vertices
+  };
+
  public:
   template <typename Vertex>
   VertexBuffer(const Device& device,
@@ -27,6 +35,12 @@ class VertexBuffer : public Buffer {
                Property property = Property::HOST_VISIBLE) {
     create(device, vertices, property);
   }
+  // `vertices` points to `numVertices` packed vertices of `vertexSize` bytes each.
+  VertexBuffer(const Device& device,
+               const void* vertices,
+               size_t numVertices,
+               size_t vertexSize,
+               Property property = Property::NONE);
 
   // Buffer will be device local only and the data will be copied from host to buffer using a
   // staging buffer. To make the buffer host visible, use Property::HOST_VISIBLE and vertices will
@@ -36,8 +50,23 @@ class VertexBuffer : public Buffer {
               const std::vector<Vertex>& vertices,
               Property property = Property::NONE);
 
+  void create(const Device& device,
+              const void* vertices,
+              size_t numVertices,
+              size_t vertexSize,
+              Property property = Property::NONE);
+
+  // Update the whole buffer. If `vertices` doesn't fit, the buffer is reallocated to at least twice
+  // its size; the GPU must not be using the buffer anymore in that case.
   template <typename Vertex>
   void update(const std::vector<Vertex>& vertices);
+  // Update the vertices from `firstVertex` on. The updated vertices must be within `numVertices()`.
+  template <typename Vertex, size_t Extent>
+  void update(std::span<Vertex, Extent> vertices, size_t firstVertex);
+  // Update the dirty `ranges` of `vertices`, a host copy of the whole buffer. Adjacent ranges are
+  // coalesced and all of them are copied by one transfer.
+  template <typename Vertex>
+  void updateRanges(const std::vector<Vertex>& vertices, const std::vector<Range>& ranges);
 
   size_t numVertices() const { return _numVertices; }
 
@@ -53,8 +82,12 @@ class VertexBuffer : public Buffer {
   // To make the buffer host visible, use Property::HOST_VISIBLE
   void create(const Device& device, VkDeviceSize size, Property property = Property::NONE);
 
+  // Reallocate the buffer if it's smaller than `size` bytes. The content is not preserved.
+  void reserve(VkDeviceSize size);
+
  private:
   size_t _numVertices = 0;
+  Property _property  = Property::NONE;
 };
 
 template <typename Vertex>
@@ -69,11 +102,36 @@ inline void VertexBuffer::create(const Device& device,
 
 template <typename Vertex>
 inline void VertexBuffer::update(const std::vector<Vertex>& vertices) {
-  MI_ASSERT(vertices.size() == _numVertices);
-  VkDeviceSize size = sizeof(Vertex) * _numVertices;
+  VkDeviceSize size = sizeof(Vertex) * vertices.size();
+  reserve(size);
+  _numVertices = vertices.size();
   load(vertices.data(), size, 0, !memory().isHostVisible());
 }
 
+template <typename Vertex, size_t Extent>
+inline void VertexBuffer::update(std::span<Vertex, Extent> vertices, size_t firstVertex) {
+  MI_VERIFY(firstVertex + vertices.size() <= _numVertices);
+  load(vertices.data(),
+       vertices.size_bytes(),
+       sizeof(Vertex) * firstVertex,
+       !memory().isHostVisible());
+}
+
+template <typename Vertex>
+inline void VertexBuffer::updateRanges(const std::vector<Vertex>& vertices,
+                                       const std::vector<Range>& ranges) {
+  MI_VERIFY(vertices.size() == _numVertices);
+
+  std::vector<VkBufferCopy> regions;
+  regions.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    MI_VERIFY(range.first + range.count <= _numVertices);
+    const VkDeviceSize offset = sizeof(Vertex) * range.first;
+    regions.push_back({offset, offset, sizeof(Vertex) * range.count});
+  }
+  loadRegions(vertices.data(), std::move(regions), !memory().isHostVisible());
+}
+
 MI_ENABLE_ENUM_BITWISE_OP(VertexBuffer::Property);
 
 MI_NAMESPACE_END(Vulk)
\ No newline at end of file
@@ -28,6 +28,18 @@ class VertexShader : public ShaderModule {
                                uint32_t offset = 0);
   void addVertexInputAttributes(std::vector<VertexInputAttribute> attributes);
 
+  // Replace the reflected formats and offsets of the vertex input attributes, matched by location,
+  // and the reflected binding by the given vertex layout. The reflection assumes tightly packed
+  // 32-bit float attributes, so vertex types with packed attributes (see `Quantized.h`) must
+  // override it for the pipeline to agree with their vertex buffers.
+  void overrideVertexInputLayout(const VkVertexInputBindingDescription& binding,
+                                 const std::vector<VkVertexInputAttributeDescription>& attributes);
+  template <typename Vertex>
+  void overrideVertexInputLayout(uint32_t binding = 0) {
+    overrideVertexInputLayout(Vertex::bindingDescription(binding),
+                              Vertex::attributesDescription(binding));
+  }
+
   void addDescriptorSetLayoutBinding(
       const std::string& name,
       const std::string& type,
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <volk/volk.h>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <Vulk/internal/base.h>
+
+#include <Vulk/engine/DeviceContext.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+class CommandBuffer;
+class Pipeline;
+class Texture2D;
+
+//
+// A descriptor set of all the textures, in an array of sampled images and an array of samplers.
+// The textures get a slot when added and the shaders index the arrays by it, e.g. passed by push
+// constants, so drawing with many textures binds the table once instead of a set per texture:
+//
+//   layout(set = 1, binding = 0) uniform texture2D textures[];
+//   layout(set = 1, binding = 1) uniform sampler samplers[];
+//   ...
+//   texture(sampler2D(textures[nonuniformEXT(slot.image)], samplers[slot.sampler]), uv)
+//
+// The set is update-after-bind with partially bound arrays, so textures can be added while the
+// table is bound by the frames in flight. It requires the descriptor indexing of the device
+// context (see `DeviceContext::CreateInfo::descriptorIndexing`).
+//
+// The slots of the removed textures are reused only after `numFramesInFlight` calls of
+// `nextFrame()`, since the frames in flight may still sample them.
+//
+class BindlessTextureTable : public Sharable<BindlessTextureTable>, private NotCopyable {
+ public:
+  // The indices of a texture in the arrays of the table
+  struct Slot {
+    uint32_t image   = 0;
+    uint32_t sampler = 0;
+  };
+
+  // The set of the table in the pipelines, see `Pipeline::Configuration::externalSetLayouts`
+  static constexpr uint32_t kSet            = 1;
+  static constexpr uint32_t kImageBinding   = 0;
+  static constexpr uint32_t kSamplerBinding = 1;
+
+ public:
+  BindlessTextureTable() = default;
+  explicit BindlessTextureTable(const DeviceContext& deviceContext,
+                                uint32_t maxImages         = 4096,
+                                uint32_t maxSamplers       = 64,
+                                uint32_t numFramesInFlight = 3);
+  ~BindlessTextureTable() override;
+
+  void create(const DeviceContext& deviceContext,
+              uint32_t maxImages,
+              uint32_t maxSamplers,
+              uint32_t numFramesInFlight);
+  void destroy();
+
+  // The slot of `texture`, the same one if it's added again. The textures of the same sampler share
+  // the sampler index. Called by `Texture2D::registerTo()`. Throw `std::length_error`, leaving the
+  // table as it was, if the image or the sampler array is full.
+  Slot add(const Texture2D& texture);
+  // The indices of `texture` are retired until the frames in flight are done with them.
+  void remove(const Texture2D& texture);
+
+  // To be called once per frame, after the oldest frame in flight is done (see
+  // `FrameContext::waitFrameRendered()`). The indices retired `numFramesInFlight` frames ago
+  // become free.
+  void nextFrame();
+
+  // Bind the table to set `kSet` of `pipeline`.
+  void bind(const CommandBuffer& commandBuffer, const Pipeline& pipeline) const;
+
+  operator VkDescriptorSet() const { return _set; }
+  [[nodiscard]] VkDescriptorSetLayout layout() const { return _layout; }
+
+  [[nodiscard]] uint32_t numTextures() const;
+
+  [[nodiscard]] bool isCreated() const { return _set != VK_NULL_HANDLE; }
+
+  [[nodiscard]] const Device& device() const { return *_device.lock(); }
+
+ private:
+  struct Entry {
+    Slot slot;
+    VkSampler sampler = VK_NULL_HANDLE;
+  };
+  struct SamplerEntry {
+    uint32_t index    = 0;
+    uint32_t numUsers = 0;
+  };
+  struct Retired {
+    uint64_t frame = 0; // Free from this frame on
+    uint32_t image = 0;
+    std::optional<uint32_t> sampler; // If no other texture uses the sampler
+  };
+
+  // A free index of `freeIndices`, or the next one of `numIndices`. Throw `std::length_error` if
+  // all `maxIndices` are in use.
+  static uint32_t allocateIndex(std::vector<uint32_t>& freeIndices,
+                                uint32_t& numIndices,
+                                uint32_t maxIndices);
+
+ private:
+  VkDescriptorSetLayout _layout = VK_NULL_HANDLE;
+  VkDescriptorPool _pool        = VK_NULL_HANDLE;
+  VkDescriptorSet _set          = VK_NULL_HANDLE;
+
+  uint32_t _maxImages   = 0;
+  uint32_t _maxSamplers = 0;
+
+  mutable std::mutex _mutex;
+  std::unordered_map<VkImageView, Entry> _textures;
+  std::unordered_map<VkSampler, SamplerEntry> _samplers;
+  std::vector<uint32_t> _freeImages;
+  std::vector<uint32_t> _freeSamplers;
+  uint32_t _numImages   = 0; // The indices used so far
+  uint32_t _numSamplers = 0;
+
+  std::deque<Retired> _retired; // In the order of their frames
+  uint64_t _frame             = 0;
+  uint32_t _numFramesInFlight = 0;
+
+  std::weak_ptr<const Device> _device;
+};
+
+MI_NAMESPACE_END(Vulk)
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <functional>
+#include <span>
+#include <vector>
+
+#include <Vulk/engine/RenderTask.h>
+
+#include <Vulk/ComputeShader.h>
+#include <Vulk/Pipeline.h>
+#include <Vulk/DescriptorSet.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+//
+// Base of the tasks running a compute pipeline. A `Type::Compute` task runs on the compute queue,
+// or on the graphics queue (which always supports compute) if the device context has no compute
+// queue.
+//
+// Subclasses prepare their inputs like the other render tasks and implement `run()` with
+// `submit()`, which binds the pipeline and a descriptor set of the given infos before recording the
+// dispatches. The infos are indexed by `DescriptorUpdateTemplate::index()` of the pipeline.
+//
+class ComputeTask : public RenderTask {
+ public:
+  ComputeTask(const DeviceContext& deviceContext,
+              const ComputeShader& compShader,
+              Type type = Type::Compute);
+  ~ComputeTask() override;
+
+  void prepareSynchronization(const std::vector<Semaphore::shared_ptr>& waits = {});
+
+  DescriptorSetLayout::shared_ptr descriptorSetLayout() override;
+  std::vector<DescriptorSetLayout::shared_ptr> descriptorSetLayouts() override;
+
+  [[nodiscard]] const Pipeline& pipeline() const { return *_pipeline; }
+
+  // Number of workgroups of `groupSize` invocations to cover `numInvocations`.
+  [[nodiscard]] static uint32_t groupCount(size_t numInvocations, uint32_t groupSize) {
+    return static_cast<uint32_t>((numInvocations + groupSize - 1) / groupSize);
+  }
+
+  //
+  // Override the sharable types and functions
+  //
+  MI_DEFINE_SHARED_PTR(ComputeTask, RenderTask);
+
+ protected:
+  using Recorder = std::function<void(const CommandBuffer&)>;
+
+  // Record the dispatches (and barriers) of `record` with the pipeline and a descriptor set of
+  // `infos`, one per binding of the set 0, bound. The commands wait for the semaphores of
+  // `prepareSynchronization()`.
+  std::pair<Semaphore::shared_ptr, Fence::shared_ptr> submit(
+      const char* label,
+      std::span<const DescriptorSet::Info> infos,
+      const Recorder& record);
+
+ protected:
+  Pipeline::shared_ptr _pipeline;
+
+  // Synchronizations
+  std::vector<Semaphore::shared_ptr> _waits;
+};
+
+MI_NAMESPACE_END(Vulk)
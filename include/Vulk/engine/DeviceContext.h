@@ -6,6 +6,8 @@
 #include <Vulk/Swapchain.h>
 #include <Vulk/Device.h>
 
+#include <Vulk/engine/Presenter.h>
+
 MI_NAMESPACE_BEGIN(Vulk)
 
 class DeviceContext : public Sharable<DeviceContext>, private NotCopyable {
@@ -23,13 +25,23 @@ class DeviceContext : public Sharable<DeviceContext>, private NotCopyable {
 
     CreateWindowSurfaceFunc createWindowSurface;
 
-    PhysicalDevice::QueueFamilies queueFamilies; // To specify the queue families to be created
-    std::vector<const char*> deviceExtensions;   // To specify the required device extensions
+    PhysicalDevice::QueueFamilies queueFamilies;   // To specify the queue families to be created
+    Device::QueuePriorities queuePriorities{1.0F}; // To specify the queues of each family
+    std::vector<const char*> deviceExtensions;     // To specify the required device extensions
     PhysicalDevice::HasDeviceFeaturesFunc hasPhysicalDeviceFeatures;
+    Device::SubmissionMode submissionMode = Device::SubmissionMode::Direct;
+    bool queueContentionTiming            = false; // See `Queue::contention()`
+    // Enable the descriptor indexing features of a `BindlessTextureTable`. Requires Vulkan 1.1.
+    bool descriptorIndexing = false;
+    // The file of the pipeline cache, loaded at creation and saved at destruction. Empty to keep
+    // the cache in memory only.
+    std::string pipelineCacheFile;
 
     Swapchain::ChooseSurfaceFormatFunc chooseSurfaceFormat;
     Swapchain::ChooseSurfaceExtentFunc chooseSurfaceExtent;
     Swapchain::ChoosePresentModeFunc choosePresentMode;
+    // The frames queued to a present thread (see `Presenter`). 0 to present on the render thread.
+    uint32_t presentQueueDepth = 0;
   };
 
  public:
@@ -47,6 +59,8 @@ class DeviceContext : public Sharable<DeviceContext>, private NotCopyable {
   [[nodiscard]] Surface& surface() { return *_surface; }
   [[nodiscard]] Device& device() { return *_device; }
   [[nodiscard]] Swapchain& swapchain() { return *_swapchain; }
+  // Null if the frames are presented on the render thread.
+  [[nodiscard]] Presenter* presenter() { return _presenter.get(); }
   [[nodiscard]] Queue& queue(Device::QueueFamilyType queueFamily);
   [[nodiscard]] CommandPool& commandPool(Device::QueueFamilyType queueFamily);
 
@@ -54,10 +68,16 @@ class DeviceContext : public Sharable<DeviceContext>, private NotCopyable {
   [[nodiscard]] const Surface& surface() const { return *_surface; }
   [[nodiscard]] const Device& device() const { return *_device; }
   [[nodiscard]] const Swapchain& swapchain() const { return *_swapchain; }
+  [[nodiscard]] const Presenter* presenter() const { return _presenter.get(); }
   [[nodiscard]] const Queue& queue(Device::QueueFamilyType queueFamily) const;
   [[nodiscard]] const CommandPool& commandPool(Device::QueueFamilyType queueFamily) const;
 
   [[nodiscard]] bool isQueueFamilySupported(Device::QueueFamilyType queueFamily) const;
+  [[nodiscard]] bool isDescriptorIndexingEnabled() const { return _descriptorIndexing; }
+  [[nodiscard]] bool isQueueFamilyDistinct(Device::QueueFamilyType queueFamily,
+                                           Device::QueueFamilyType other) const {
+    return _device->isQueueFamilyDistinct(queueFamily, other);
+  }
 
  protected:
   virtual void createInstance(int versionMajor,
@@ -69,7 +89,8 @@ class DeviceContext : public Sharable<DeviceContext>, private NotCopyable {
                                   const std::vector<const char*>& deviceExtensions,
                                   const PhysicalDevice::HasDeviceFeaturesFunc& hasDeviceFeatures);
   virtual void createDevice(const PhysicalDevice::QueueFamilies& requiredQueueFamilies,
-                            const std::vector<const char*>& deviceExtensions);
+                            const std::vector<const char*>& deviceExtensions,
+                            const Device::QueuePriorities& queuePriorities = {1.0F});
   virtual void createSwapchain(const Swapchain::ChooseSurfaceExtentFunc& chooseSurfaceExtent,
                                const Swapchain::ChooseSurfaceFormatFunc& chooseSurfaceFormat,
                                const Swapchain::ChoosePresentModeFunc& choosePresentMode);
@@ -80,8 +101,11 @@ class DeviceContext : public Sharable<DeviceContext>, private NotCopyable {
   Surface::shared_ptr _surface;
   Device::shared_ptr _device;
   Swapchain::shared_ptr _swapchain;
+  Presenter::shared_ptr _presenter;
 
   PhysicalDevice::QueueFamilies _queueFamilies;
+
+  bool _descriptorIndexing = false;
 };
 
 MI_NAMESPACE_END(Vulk)
@@ -6,6 +6,9 @@
 #include <Vulk/IndexBuffer.h>
 #include <Vulk/StagingBuffer.h>
 
+#include <Vulk/engine/MeshFile.h>
+
+#include <span>
 #include <vector>
 
 MI_NAMESPACE_BEGIN(Vulk)
@@ -32,6 +35,9 @@ class MeshDrawable : public Drawable {
   void create(const Device& device,
               const std::vector<vertex_type>& vertices,
               const std::vector<index_type>& indices);
+  // Upload the vertex and index blobs of `meshFile` directly from its file mapping. The index
+  // buffer keeps the index type of the file, which may be narrower than `index_type`.
+  void create(const Device& device, const MeshFile& meshFile);
   void destroy() override;
 
   [[nodiscard]] const VertexBuffer& vertexBuffer() const { return *_vertexBuffer; }
@@ -59,6 +65,22 @@ inline void MeshDrawable<V, I>::create(const Device& device,
   _numIndices  = indices.size();
 }
 
+template <typename V, typename I>
+inline void MeshDrawable<V, I>::create(const Device& device, const MeshFile& meshFile) {
+  MI_VERIFY(meshFile.isOpen());
+  MI_VERIFY(meshFile.vertexSize() == sizeof(vertex_type));
+  MI_VERIFY(meshFile.vertexLayout() == MeshFile::layoutKeyOf<vertex_type>());
+  MI_VERIFY(meshFile.indexSize() <= sizeof(index_type));
+
+  _vertexBuffer = VertexBuffer::make_shared(
+      device, meshFile.vertexData(), meshFile.numVertices(), meshFile.vertexSize());
+  _indexBuffer = IndexBuffer::make_shared(
+      device, meshFile.indexData(), meshFile.numIndices(), meshFile.indexType());
+
+  _numVertices = meshFile.numVertices();
+  _numIndices  = meshFile.numIndices();
+}
+
 template <typename V, typename I>
 inline void MeshDrawable<V, I>::destroy() {
   _vertexBuffer.reset();
@@ -82,7 +104,11 @@ class PointsDrawable : public Drawable {
   void create(const Device& device, const std::vector<vertex_type>& vertices);
   void destroy() override;
 
+  // The number of vertices may change; see `VertexBuffer::update`.
   void update(const std::vector<vertex_type>& vertices);
+  void update(std::span<const vertex_type> vertices, size_t firstVertex);
+  void updateRanges(const std::vector<vertex_type>& vertices,
+                    const std::vector<VertexBuffer::Range>& ranges);
 
   [[nodiscard]] const VertexBuffer& vertexBuffer() const { return *_vertexBuffer; }
 
@@ -110,6 +136,18 @@ inline void PointsDrawable<V>::destroy() {
 template <typename V>
 inline void PointsDrawable<V>::update(const std::vector<vertex_type>& vertices) {
   _vertexBuffer->update(vertices);
+  _numVertices = vertices.size();
+}
+
+template <typename V>
+inline void PointsDrawable<V>::update(std::span<const vertex_type> vertices, size_t firstVertex) {
+  _vertexBuffer->update(vertices, firstVertex);
+}
+
+template <typename V>
+inline void PointsDrawable<V>::updateRanges(const std::vector<vertex_type>& vertices,
+                                            const std::vector<VertexBuffer::Range>& ranges) {
+  _vertexBuffer->updateRanges(vertices, ranges);
 }
 
 MI_NAMESPACE_END(Vulk)
\ No newline at end of file
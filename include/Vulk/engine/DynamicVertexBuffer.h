@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+
+#include <Vulk/internal/base.h>
+#include <Vulk/internal/debug.h>
+
+#include <Vulk/Device.h>
+#include <Vulk/VertexBuffer.h>
+
+#include <Vulk/engine/FrameContext.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+//
+// A vertex buffer for geometry streamed from the CPU every frame. It has one host visible slot per
+// frame in flight, selected by `FrameContext::frameIndex()`. After
+// `FrameContext::waitFrameRendered()` the GPU is done with the slot of the frame, so the CPU can
+// write it without stalling or racing the frames still in flight.
+//
+class DynamicVertexBuffer : public Sharable<DynamicVertexBuffer>, private NotCopyable {
+ public:
+  DynamicVertexBuffer() = default;
+  template <typename Vertex>
+  DynamicVertexBuffer(const Device& device,
+                      const std::vector<Vertex>& vertices,
+                      uint32_t numSlots) {
+    create(device, vertices, numSlots);
+  }
+  ~DynamicVertexBuffer() override;
+
+  // All slots are initialized with `vertices`.
+  template <typename Vertex>
+  void create(const Device& device, const std::vector<Vertex>& vertices, uint32_t numSlots);
+  void destroy();
+
+  // Write `vertices` into the slot of `frameContext`, which becomes the current slot.
+  template <typename Vertex>
+  void update(const FrameContext& frameContext, const std::vector<Vertex>& vertices);
+
+  // The slot of `frameContext`. It's the one to bind for drawing the frame.
+  [[nodiscard]] const VertexBuffer& slot(const FrameContext& frameContext) const {
+    return slot(frameContext.frameIndex());
+  }
+  [[nodiscard]] const VertexBuffer& slot(uint32_t frameIndex) const;
+  // The slot last written by `update()`.
+  [[nodiscard]] const VertexBuffer& current() const { return *_slots[_currentSlot]; }
+
+  [[nodiscard]] uint32_t numSlots() const { return static_cast<uint32_t>(_slots.size()); }
+
+  [[nodiscard]] bool isCreated() const { return !_slots.empty(); }
+
+ private:
+  std::vector<VertexBuffer::shared_ptr> _slots;
+  uint32_t _currentSlot = 0;
+};
+
+template <typename Vertex>
+inline void DynamicVertexBuffer::create(const Device& device,
+                                        const std::vector<Vertex>& vertices,
+                                        uint32_t numSlots) {
+  MI_VERIFY(!isCreated());
+  MI_VERIFY(numSlots > 0);
+
+  _slots.reserve(numSlots);
+  for (uint32_t i = 0; i < numSlots; ++i) {
+    _slots.push_back(
+        VertexBuffer::make_shared(device, vertices, VertexBuffer::Property::HOST_VISIBLE));
+  }
+  _currentSlot = 0;
+}
+
+template <typename Vertex>
+inline void DynamicVertexBuffer::update(const FrameContext& frameContext,
+                                        const std::vector<Vertex>& vertices) {
+  MI_VERIFY(isCreated());
+
+  _currentSlot = frameContext.frameIndex() % numSlots();
+  // The slot is host visible so this is a plain memcpy; no staging or fence wait.
+  _slots[_currentSlot]->update(vertices);
+}
+
+MI_NAMESPACE_END(Vulk)
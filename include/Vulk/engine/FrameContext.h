@@ -7,6 +7,7 @@
 #include <Vulk/DescriptorPool.h>
 #include <Vulk/DescriptorSet.h>
 #include <Vulk/DescriptorSetLayout.h>
+#include <Vulk/DescriptorUpdateTemplate.h>
 #include <Vulk/Framebuffer.h>
 #include <Vulk/UniformBuffer.h>
 
@@ -15,8 +16,15 @@
 
 #include <Vulk/engine/DeviceContext.h>
 
+#include <array>
+#include <future>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+
 #include <tbb/concurrent_queue.h>
 #include <tbb/concurrent_hash_map.h>
+#include <tbb/enumerable_thread_specific.h>
 
 MI_NAMESPACE_BEGIN(Vulk)
 
@@ -38,20 +46,116 @@ class CommandBufferManager : public Sharable<CommandBufferManager>, private NotC
   tbb::concurrent_queue<CommandBuffer::shared_ptr> _acquiredCommandBuffers;
 };
 
-// Manager of descriptor sets that can be cached and re-cycled
-// TODO support caching
+// Manager of descriptor sets that can be cached and re-cycled. The sets can be acquired by several
+// threads; the allocations from the pools are serialized.
+//
+// The sets acquired with an update template are cached by the layout and the bound handles and
+// ranges. A set acquired again with the same infos in a later frame is returned as it is, skipping
+// both the allocation and the update. The sets not used for `kMaxUnusedFrames` frames are freed.
+//
+// The sets are allocated from chains of pools: when the pools of a chain are full, a new pool twice
+// as large as the last one is added. The pools of the sets acquired without a template are all
+// reset by `reset()`, and the cached sets are freed one by one from their own pools. The pools
+// left empty for `kMaxUnusedFrames` frames are destroyed, except the first one.
 class DescriptorSetManager : public Sharable<DescriptorSetManager>, private NotCopyable {
  public:
-  DescriptorSetManager(const Device& device, std::vector<DescriptorSetLayout::shared_ptr> layouts);
+  struct Statistics {
+    uint64_t numHits      = 0;
+    uint64_t numMisses    = 0;
+    uint64_t numEvictions = 0;
+
+    uint32_t numPools    = 0; // Of both chains
+    uint32_t poolMaxSets = 0; // The sets the pools of both chains can hold
+
+    // High-water marks, to size the first pools for the workload
+    uint32_t maxFrameSets  = 0; // The most sets acquired without a template in a frame
+    uint32_t maxCachedSets = 0; // The most sets in the cache at once
+  };
+
+  static constexpr uint64_t kMaxUnusedFrames = 8;
+
+ public:
+  // The first pools hold `initialMaxSets` sets of each of `layouts`.
+  DescriptorSetManager(const Device& device,
+                       std::vector<DescriptorSetLayout::shared_ptr> layouts,
+                       uint32_t initialMaxSets = 1);
   ~DescriptorSetManager();
 
+  // A new set, to be bound by the caller. It's freed at the next `reset()`.
   DescriptorSet::shared_ptr acquireSet(const DescriptorSetLayout& layout);
+  // A set updated from `infos` by `updateTemplate`, from the cache if possible. A cache hit
+  // doesn't allocate any memory. The sets referring to a destroyed buffer, image view or sampler
+  // are evicted, so a handle reused by a new object never hits them.
+  // Throw `std::invalid_argument` unless `infos` has one info per binding of `updateTemplate`.
+  DescriptorSet::shared_ptr acquireSet(const DescriptorUpdateTemplate& updateTemplate,
+                                       std::span<const DescriptorSet::Info> infos);
 
   void reset();
 
+  [[nodiscard]] Statistics statistics() const;
+
+ private:
+  struct CacheKey {
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    std::vector<uint64_t> contents; // The handles, offsets and ranges of the bindings in order
+    size_t hash = 0;
+
+    bool operator==(const CacheKey& other) const {
+      return layout == other.layout && contents == other.contents;
+    }
+  };
+  struct CacheKeyHash {
+    size_t operator()(const CacheKey& key) const { return key.hash; }
+  };
+  struct CacheEntry {
+    DescriptorSet::shared_ptr set;
+    uint32_t pool          = 0; // Index in the chain of the cached sets
+    uint64_t lastUsedFrame = 0;
+  };
+
+  struct Pool {
+    DescriptorPool::shared_ptr pool;
+    uint32_t maxSets       = 0;
+    uint32_t numSets       = 0; // Allocated and not freed
+    uint64_t lastUsedFrame = 0;
+  };
+  struct PoolChain {
+    bool setCanBeFreed = false;
+    std::vector<Pool> pools;
+  };
+
+  // Fill `_lookupKey`, whose storage is reused from a lookup to the next
+  void buildLookupKey(const DescriptorUpdateTemplate& updateTemplate,
+                      std::span<const DescriptorSet::Info> infos);
+
+  // The index of the first pool of `chain` with room for another set, after adding one if needed
+  uint32_t availablePool(PoolChain& chain);
+  // Destroy the empty pools at the end of `chain` which haven't been used for a while.
+  void trimPools(PoolChain& chain);
+
+  void evict(std::unordered_map<CacheKey, CacheEntry, CacheKeyHash>::iterator entry);
+  void evictUnused();
+  // Evict the sets referring to `_destroyedHandles`.
+  void evictDestroyed();
+
  private:
-  DescriptorPool::shared_ptr _descriptorPool;
-  tbb::concurrent_queue<DescriptorSet::shared_ptr> _acquiredDescriptorSets;
+  const Device& _device;
+  std::vector<VkDescriptorPoolSize> _poolSizes; // Of a set of each layout
+  uint32_t _initialMaxSets = 1;
+
+  mutable std::mutex _mutex;
+  // Declared before the sets so that they are destroyed after them
+  PoolChain _framePools;
+  PoolChain _cachePools{.setCanBeFreed = true};
+  std::vector<DescriptorSet::shared_ptr> _acquiredDescriptorSets;
+  std::unordered_map<CacheKey, CacheEntry, CacheKeyHash> _cache;
+  CacheKey _lookupKey;
+  std::vector<uint64_t> _destroyedHandles; // Since the last eviction, see `Device`
+  uint64_t _callbackId = 0;
+
+  uint64_t _frame = 0; // Incremented by `reset()`
+
+  Statistics _statistics;
 };
 
 // Manager of sync objects (semaphores and fences) that can be re-cycled
@@ -112,11 +216,27 @@ class FramebufferKeeper : public Sharable<FramebufferKeeper>, private NotCopyabl
 //
 class FrameContext : public Sharable<FrameContext>, private NotCopyable {
  public:
-  FrameContext(const DeviceContext& deviceContext, std::vector<RenderTask*> tasks);
+  // `frameIndex` is the index of the frame among the frames in flight. Per-frame resources outside
+  // of the context (e.g. the slots of a `DynamicVertexBuffer`) are selected by it. The first
+  // descriptor pools hold `initialMaxSets` sets of each layout of `tasks`, see the high-water marks
+  // of `descriptorSetStatistics()`.
+  FrameContext(const DeviceContext& deviceContext,
+               std::vector<RenderTask*> tasks,
+               uint32_t frameIndex     = 0,
+               uint32_t initialMaxSets = 1);
   virtual ~FrameContext() = default;
 
+  [[nodiscard]] uint32_t frameIndex() const { return _frameIndex; }
+
+  // The command buffers are allocated from a command pool of the calling thread, so threads can
+  // record the command buffers they acquire at the same time.
   [[nodiscard]] CommandBuffer::shared_ptr acquireCommandBuffer(Device::QueueFamilyType queueFamily);
   [[nodiscard]] DescriptorSet::shared_ptr acquireDescriptorSet(const DescriptorSetLayout& layout);
+  // Reuse the set written with the same infos in an earlier frame of the context, if any.
+  [[nodiscard]] DescriptorSet::shared_ptr acquireDescriptorSet(
+      const DescriptorUpdateTemplate& updateTemplate,
+      std::span<const DescriptorSet::Info> infos);
+  [[nodiscard]] DescriptorSetManager::Statistics descriptorSetStatistics() const;
 
   [[nodiscard]] Semaphore::shared_ptr acquireSemaphore();
   [[nodiscard]] Fence::shared_ptr acquireFence();
@@ -127,7 +247,12 @@ class FrameContext : public Sharable<FrameContext>, private NotCopyable {
 
 
   void setFrameRendered(const Fence::shared_ptr& fence) { _frameRendered = fence; }
-  void waitFrameRendered() const { _frameRendered->wait(); }
+  // The frame is handed to a `Presenter`, which sets the fence of the frame once it has submitted
+  // the present. `presented` is ready by then.
+  void setFramePresented(std::shared_future<void> presented) {
+    _framePresented = std::move(presented);
+  }
+  void waitFrameRendered() const;
 
   // Need to be called before each frame rendering to release the previous used resource such as
   // command buffers and descriptor sets.
@@ -136,14 +261,20 @@ class FrameContext : public Sharable<FrameContext>, private NotCopyable {
  private:
   const DeviceContext& _deviceContext;
 
-  std::vector<CommandBufferManager::shared_ptr> _commandBufferManagers{
-      Device::QueueFamilyType::NUM_QUEUE_FAMILY_TYPES};
+  // A command pool can't be used by several threads at the same time, hence a manager per thread.
+  using ThreadCommandBufferManagers =
+      tbb::enumerable_thread_specific<CommandBufferManager::shared_ptr>;
+  std::array<ThreadCommandBufferManagers, Device::QueueFamilyType::NUM_QUEUE_FAMILY_TYPES>
+      _commandBufferManagers;
   DescriptorSetManager::shared_ptr _descriptorSetManager;
   SyncObjectManager::shared_ptr _syncObjectManager;
   FramebufferKeeper::shared_ptr _framebufferKeeper;
   UniformBufferManager::shared_ptr _uniformBufferManager;
 
   Fence::shared_ptr _frameRendered;
+  std::shared_future<void> _framePresented;
+
+  uint32_t _frameIndex = 0;
 };
 
 MI_NAMESPACE_END(Vulk)
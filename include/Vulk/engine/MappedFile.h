@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <streambuf>
+#include <string>
+
+#include <Vulk/internal/base.h>
+#include <Vulk/internal/arch.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+//
+// A read-only memory mapping of a whole file. The file contents are paged in by the OS on demand
+// so no heap copy of the file is ever made. Use `advise()` to hint the expected access pattern and
+// `forEachChunk()` to stream large files with a bounded resident set.
+//
+class MappedFile : public Sharable<MappedFile>, private NotCopyable {
+ public:
+  enum class Access { Normal, Sequential, Random, WillNeed, DontNeed };
+
+  using ChunkFunc = std::function<void(size_t offset, const uint8_t* data, size_t size)>;
+
+  // A std::streambuf over the mapped bytes, for parsers that only accept std::istream.
+  class StreamBuf : public std::streambuf {
+   public:
+    explicit StreamBuf(const MappedFile& file);
+
+   protected:
+    pos_type seekoff(off_type off,
+                     std::ios_base::seekdir dir,
+                     std::ios_base::openmode which = std::ios_base::in) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::in) override;
+  };
+
+ public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string& filename, Access access = Access::Normal);
+  ~MappedFile() override;
+
+  void open(const std::string& filename, Access access = Access::Normal);
+  void close();
+
+  void advise(Access access) const { advise(access, 0, _size); }
+  void advise(Access access, size_t offset, size_t size) const;
+
+  // Calls `func` on consecutive chunks of `[offset, offset + size)`. The next chunk is prefetched
+  // while `func` consumes the current one, and the consumed chunk is released afterwards.
+  void forEachChunk(size_t chunkSize, const ChunkFunc& func) const {
+    forEachChunk(chunkSize, 0, _size, func);
+  }
+  void forEachChunk(size_t chunkSize, size_t offset, size_t size, const ChunkFunc& func) const;
+
+  [[nodiscard]] const uint8_t* data() const { return _data; }
+  [[nodiscard]] size_t size() const { return _size; }
+  [[nodiscard]] std::span<const uint8_t> bytes() const { return {_data, _size}; }
+
+  [[nodiscard]] const std::string& filename() const { return _filename; }
+
+  [[nodiscard]] bool isOpen() const { return _data != nullptr; }
+
+ private:
+  const uint8_t* _data = nullptr;
+  size_t _size         = 0; // in bytes
+
+  std::string _filename;
+
+#if defined(ARCH_OS_WINDOWS)
+  void* _file    = nullptr;
+  void* _mapping = nullptr;
+#endif
+};
+
+MI_NAMESPACE_END(Vulk)
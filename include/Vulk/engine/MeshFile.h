@@ -0,0 +1,138 @@
+#pragma once
+
+#include <volk/volk.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <Vulk/internal/base.h>
+
+#include <Vulk/engine/Bound.h>
+#include <Vulk/engine/MappedFile.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+//
+// A compact binary mesh: a fixed header followed by the vertex and index blobs, each aligned to
+// `BLOB_ALIGNMENT` bytes. The blobs are stored exactly as they are laid out in the GPU buffers so
+// loading is a single mmap plus upload. All values are little-endian.
+//
+class MeshFile : public Sharable<MeshFile>, private NotCopyable {
+ public:
+  using BBox = Bound<glm::vec3>;
+
+  static constexpr uint32_t MAGIC          = 0x48534D56; // "VMSH"
+  static constexpr uint32_t VERSION        = 2;
+  static constexpr uint64_t BLOB_ALIGNMENT = 16;
+
+  static constexpr const char* EXTENSION = ".vmesh";
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceKey; // 0 if the mesh was not converted from a source file
+    uint32_t vertexSize; // in bytes
+    uint32_t indexSize;  // in bytes
+    uint64_t numVertices;
+    uint64_t numIndices;
+    uint64_t vertexOffset; // from the beginning of the file
+    uint64_t indexOffset;  // from the beginning of the file
+    float bboxLower[3];
+    float bboxUpper[3];
+    uint32_t vertexLayout; // see `layoutKey()`
+    uint32_t reserved[3];
+  };
+
+ public:
+  MeshFile() = default;
+  explicit MeshFile(const std::string& filename);
+  ~MeshFile() override = default;
+
+  // Return false if the file doesn't exist or is not a valid mesh file.
+  bool open(const std::string& filename);
+  void close();
+
+  template <typename Vertex, typename Index>
+  static void write(const std::string& filename,
+                    const std::vector<Vertex>& vertices,
+                    const std::vector<Index>& indices,
+                    const BBox& bbox,
+                    uint64_t sourceKey = 0);
+  // The file is written to a temporary file first and renamed so readers never see a partial file.
+  static void write(const std::string& filename,
+                    const void* vertices,
+                    uint32_t vertexSize,
+                    uint32_t vertexLayout,
+                    uint64_t numVertices,
+                    const void* indices,
+                    uint32_t indexSize,
+                    uint64_t numIndices,
+                    const BBox& bbox,
+                    uint64_t sourceKey = 0);
+
+  // Key of a vertex layout, derived from the locations, formats and offsets of its attributes. A
+  // mesh can only be drawn with a vertex type of the same layout key.
+  [[nodiscard]] static uint32_t layoutKey(
+      const std::vector<VkVertexInputAttributeDescription>& attributes);
+  template <typename Vertex>
+  [[nodiscard]] static uint32_t layoutKeyOf() {
+    return layoutKey(Vertex::attributesDescription(0));
+  }
+
+  // Key of the source asset, derived from its absolute path and modification time. A cached mesh
+  // is stale if its key doesn't match the key of its source.
+  [[nodiscard]] static uint64_t sourceKey(const std::filesystem::path& source);
+  // Location of the cached mesh of `source` in `cacheDir`. The name only depends on the source
+  // path so a stale cache is overwritten in place.
+  [[nodiscard]] static std::filesystem::path cachePath(const std::filesystem::path& source,
+                                                       const std::filesystem::path& cacheDir);
+
+  [[nodiscard]] const void* vertexData() const { return _file.data() + header().vertexOffset; }
+  [[nodiscard]] const void* indexData() const { return _file.data() + header().indexOffset; }
+
+  [[nodiscard]] uint32_t vertexSize() const { return header().vertexSize; }
+  [[nodiscard]] uint32_t indexSize() const { return header().indexSize; }
+  [[nodiscard]] uint32_t vertexLayout() const { return header().vertexLayout; }
+  [[nodiscard]] VkIndexType indexType() const;
+
+  [[nodiscard]] size_t numVertices() const { return header().numVertices; }
+  [[nodiscard]] size_t numIndices() const { return header().numIndices; }
+
+  [[nodiscard]] BBox bbox() const;
+  [[nodiscard]] uint64_t sourceKey() const { return header().sourceKey; }
+
+  [[nodiscard]] const MappedFile& file() const { return _file; }
+
+  [[nodiscard]] bool isOpen() const { return _file.isOpen(); }
+
+ private:
+  [[nodiscard]] const Header& header() const {
+    return *reinterpret_cast<const Header*>(_file.data());
+  }
+  [[nodiscard]] bool isValid() const;
+
+ private:
+  MappedFile _file;
+};
+
+template <typename Vertex, typename Index>
+inline void MeshFile::write(const std::string& filename,
+                            const std::vector<Vertex>& vertices,
+                            const std::vector<Index>& indices,
+                            const BBox& bbox,
+                            uint64_t sourceKey) {
+  write(filename,
+        vertices.data(),
+        sizeof(Vertex),
+        layoutKeyOf<Vertex>(),
+        vertices.size(),
+        indices.data(),
+        sizeof(Index),
+        indices.size(),
+        bbox,
+        sourceKey);
+}
+
+MI_NAMESPACE_END(Vulk)
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Vulk/internal/base.h>
+
+#include <Vulk/engine/Bound.h>
+#include <Vulk/engine/Vertex.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+//
+// Import of OBJ models into indexed triangle meshes.
+//
+// The corners of all shapes are split into blocks that are deduplicated in parallel by TBB workers,
+// each with its own open-addressing hash table keyed by a strong hash of the packed vertex bytes.
+// The per-block unique vertices are then merged into the final vertex buffer in block order, so
+// the result is identical to a serial first-occurrence deduplication.
+//
+// The imported vertices can be quantized into `PackedVertex`, half the size of `Vertex`:
+// - positions are normalized into the bounding box and stored as snorm16; the inverse mapping,
+//   `dequantization()`, is to be applied as part of the model transformation,
+// - colors are stored as unorm8,
+// - texture coordinates are stored as half floats since they may repeat beyond [0, 1].
+//
+class MeshImporter {
+ public:
+  using Vertex = VertexPCT<glm::vec3, glm::vec3, glm::vec2>;
+  using Index  = uint32_t;
+
+  using PackedVertex = VertexPCT<snorm16x4, unorm8x4, half2>;
+  using BBox         = Bound<glm::vec3>;
+
+  struct Statistics {
+    size_t numCorners = 0;   // number of indices before deduplication
+    size_t numBlocks  = 0;   // number of blocks deduplicated in parallel
+    double parseTime  = 0.0; // in seconds
+    double dedupTime  = 0.0; // in seconds
+    double mergeTime  = 0.0; // in seconds
+  };
+
+ public:
+  // Return false and leave `vertices` and `indices` untouched if the file can't be parsed.
+  static bool importObj(const std::filesystem::path& objFile,
+                        std::vector<Vertex>& vertices,
+                        std::vector<Index>& indices,
+                        Statistics* statistics = nullptr);
+
+  // Quantize `vertices` whose positions are bounded by `bbox`.
+  [[nodiscard]] static std::vector<PackedVertex> quantize(const std::vector<Vertex>& vertices,
+                                                          const BBox& bbox);
+  // The transformation from the quantized positions back to the model space of `bbox`.
+  [[nodiscard]] static glm::mat4 dequantization(const BBox& bbox);
+
+  // The 64-bit hash used for deduplication. Equal vertices (bitwise, with -0.0 folded to 0.0) have
+  // equal hashes.
+  [[nodiscard]] static uint64_t hash(const Vertex& vertex);
+};
+
+MI_NAMESPACE_END(Vulk)
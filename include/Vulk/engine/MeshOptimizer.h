@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <Vulk/internal/base.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+//
+// Optimizations of indexed triangle meshes before they are uploaded:
+//
+// - Triangles are reordered for post-transform vertex cache efficiency (Forsyth's linear-speed
+//   vertex cache optimization).
+// - Clusters of triangles are reordered so that the ones facing outward are drawn first, reducing
+//   overdraw (Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+// - Vertices are reordered by their first use in the index buffer for vertex fetch locality.
+// - Indices can be narrowed to 16 bits if the number of vertices allows.
+//
+class MeshOptimizer {
+ public:
+  // The FIFO cache size used to estimate ACMR. Most GPUs have an effective cache size of 16~32.
+  static constexpr uint32_t ACMR_CACHE_SIZE = 16;
+  // How much the ACMR of a cluster may exceed the one of its patch of the mesh. Smaller clusters
+  // reduce the overdraw further at the cost of more cache misses.
+  static constexpr float OVERDRAW_THRESHOLD = 1.05F;
+
+  struct Statistics {
+    // Average cache miss ratio, i.e. transformed vertices per triangle
+    float acmrBefore = 0.0F;
+    float acmrAfter  = 0.0F;
+    // Vertices removed by the vertex fetch optimization
+    size_t numUnreferencedVertices = 0;
+  };
+
+ public:
+  // Run all optimizations on the mesh.
+  template <typename Vertex>
+  static void optimize(std::vector<Vertex>& vertices,
+                       std::vector<uint32_t>& indices,
+                       Statistics* statistics = nullptr);
+
+  static void optimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices);
+
+  // Reorder the clusters of triangles of `indices`, whose order should come from
+  // `optimizeVertexCache()`, by how much they face away from the center of the mesh. `Vertex`
+  // must have a `pos` of at least 3 components.
+  template <typename Vertex>
+  static void optimizeOverdraw(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+  // Reorder `vertices` by their first use in `indices` and drop unreferenced vertices. Return the
+  // number of vertices dropped.
+  template <typename Vertex>
+  static size_t optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+  // Average cache miss ratio of a simulated FIFO vertex cache of `cacheSize`: 3.0 is the worst
+  // and 0.5 is the best achievable for regular meshes.
+  [[nodiscard]] static float acmr(const std::vector<uint32_t>& indices,
+                                  size_t numVertices,
+                                  uint32_t cacheSize = ACMR_CACHE_SIZE);
+
+  [[nodiscard]] static bool canNarrow(size_t numVertices) {
+    return numVertices <= std::numeric_limits<uint16_t>::max() + size_t{1};
+  }
+  [[nodiscard]] static std::vector<uint16_t> narrow(const std::vector<uint32_t>& indices);
+
+ private:
+  // Rewrite `indices` in first-use order and return the old-to-new vertex remapping. Unreferenced
+  // vertices are mapped to `UNUSED`.
+  static std::vector<uint32_t> remapVertexFetch(std::vector<uint32_t>& indices,
+                                                size_t numVertices,
+                                                size_t& numReferencedVertices);
+
+  static void optimizeOverdraw(const std::vector<std::array<float, 3>>& positions,
+                               std::vector<uint32_t>& indices);
+
+  static constexpr uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+};
+
+template <typename Vertex>
+inline void MeshOptimizer::optimize(std::vector<Vertex>& vertices,
+                                    std::vector<uint32_t>& indices,
+                                    Statistics* statistics) {
+  if (statistics) {
+    statistics->acmrBefore = acmr(indices, vertices.size());
+  }
+
+  optimizeVertexCache(indices, vertices.size());
+  optimizeOverdraw(vertices, indices);
+  const size_t numDropped = optimizeVertexFetch(vertices, indices);
+
+  if (statistics) {
+    statistics->acmrAfter               = acmr(indices, vertices.size());
+    statistics->numUnreferencedVertices = numDropped;
+  }
+}
+
+template <typename Vertex>
+inline void MeshOptimizer::optimizeOverdraw(const std::vector<Vertex>& vertices,
+                                            std::vector<uint32_t>& indices) {
+  std::vector<std::array<float, 3>> positions(vertices.size());
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    const auto& pos = vertices[i].pos;
+    positions[i]    = {static_cast<float>(pos[0]),
+                       static_cast<float>(pos[1]),
+                       static_cast<float>(pos[2])};
+  }
+  optimizeOverdraw(positions, indices);
+}
+
+template <typename Vertex>
+inline size_t MeshOptimizer::optimizeVertexFetch(std::vector<Vertex>& vertices,
+                                                 std::vector<uint32_t>& indices) {
+  size_t numReferenced = 0;
+  const auto remap     = remapVertexFetch(indices, vertices.size(), numReferenced);
+
+  std::vector<Vertex> reordered(numReferenced);
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    if (remap[i] != UNUSED) {
+      reordered[remap[i]] = vertices[i];
+    }
+  }
+
+  const size_t numDropped = vertices.size() - numReferenced;
+  vertices                = std::move(reordered);
+  return numDropped;
+}
+
+MI_NAMESPACE_END(Vulk)
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include <tbb/concurrent_queue.h>
+
+#include <Vulk/internal/base.h>
+
+#include <Vulk/Fence.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+class FrameContext;
+
+//
+// A present thread taking the acquire and present of the swapchain images (and the blit to them)
+// off the render loop, so the CPU can prepare the next frame while a frame waits for the
+// presentation engine, e.g. the vblank in FIFO mode.
+//
+// The rendered frames wait in a bounded queue: a deeper queue favors the throughput, a shallower
+// one the input latency. `present()` blocks while the queue is full.
+//
+class Presenter : public Sharable<Presenter>, private NotCopyable {
+ public:
+  // Acquire a swapchain image, copy the frame to it and present it. Returns the fence signaled
+  // when the GPU is done with the frame.
+  using PresentFunc = std::function<Fence::shared_ptr()>;
+
+  struct Metrics {
+    // The frames queued or being presented. With a full queue, it's `Presenter::queueDepth()` + 1.
+    uint32_t queueDepth    = 0;
+    uint32_t maxQueueDepth = 0; // Counted like `queueDepth`
+    uint64_t numPresented  = 0;
+    // From `present()` to the return of the present of the frame
+    std::chrono::nanoseconds lastLatency{0};
+    std::chrono::nanoseconds averageLatency{0};
+    // The time `present()` blocked on a full queue
+    std::chrono::nanoseconds blockedTime{0};
+  };
+
+ public:
+  explicit Presenter(uint32_t queueDepth = 1);
+  ~Presenter() override;
+
+  // Queue the frame of `frameContext` to be presented by `present` on the present thread. The
+  // frame context is in use until then: `FrameContext::waitFrameRendered()` waits for it.
+  //
+  // An exception thrown by a present, e.g. `VK_ERROR_OUT_OF_DATE_KHR`, is rethrown by the next
+  // call.
+  void present(FrameContext& frameContext, PresentFunc present);
+
+  // Wait until all the queued frames are presented.
+  void flush() const;
+
+  [[nodiscard]] uint32_t queueDepth() const { return _queueDepth; }
+
+  [[nodiscard]] Metrics metrics() const;
+  void resetMetrics();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Frame {
+    FrameContext* context = nullptr; // Stops the present thread if null
+    PresentFunc present;
+    std::shared_ptr<std::promise<void>> presented;
+    Clock::time_point queuedAt;
+  };
+
+  void run();
+
+ private:
+  uint32_t _queueDepth;
+
+  std::thread _thread;
+  tbb::concurrent_bounded_queue<Frame> _frames;
+  mutable std::atomic<uint32_t> _pendingFrames = 0; // Queued or being presented
+
+  std::mutex _exceptionMutex;
+  std::exception_ptr _exception;
+
+  mutable std::mutex _metricsMutex;
+  Metrics _metrics;
+};
+
+MI_NAMESPACE_END(Vulk)
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <volk/volk.h>
+
+#include <cstdint>
+
+#include <Vulk/internal/base.h>
+
+#include <Vulk/engine/TypeTraits.h>
+
+// Defined in CMakeLists.txt:GLM_FORCE_DEPTH_ZERO_TO_ONE, GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+//
+// Encodings of packed vertex attribute components. `formats[N]` is the format of an attribute
+// of N components. The vertex input stage expands them to 32-bit floats so the shader inputs
+// remain `float`/`vecN`.
+//
+struct Half {
+  using storage_type = uint16_t;
+
+  static constexpr VkFormat formats[5] = {VK_FORMAT_UNDEFINED,
+                                          VK_FORMAT_R16_SFLOAT,
+                                          VK_FORMAT_R16G16_SFLOAT,
+                                          VK_FORMAT_R16G16B16_SFLOAT,
+                                          VK_FORMAT_R16G16B16A16_SFLOAT};
+
+  static storage_type encode(float value) { return glm::packHalf1x16(value); }
+  static float decode(storage_type value) { return glm::unpackHalf1x16(value); }
+};
+
+// [-1, 1] in 16 bits
+struct Snorm16 {
+  using storage_type = uint16_t;
+
+  static constexpr VkFormat formats[5] = {VK_FORMAT_UNDEFINED,
+                                          VK_FORMAT_R16_SNORM,
+                                          VK_FORMAT_R16G16_SNORM,
+                                          VK_FORMAT_R16G16B16_SNORM,
+                                          VK_FORMAT_R16G16B16A16_SNORM};
+
+  static storage_type encode(float value) { return glm::packSnorm1x16(value); }
+  static float decode(storage_type value) { return glm::unpackSnorm1x16(value); }
+};
+
+// [0, 1] in 16 bits
+struct Unorm16 {
+  using storage_type = uint16_t;
+
+  static constexpr VkFormat formats[5] = {VK_FORMAT_UNDEFINED,
+                                          VK_FORMAT_R16_UNORM,
+                                          VK_FORMAT_R16G16_UNORM,
+                                          VK_FORMAT_R16G16B16_UNORM,
+                                          VK_FORMAT_R16G16B16A16_UNORM};
+
+  static storage_type encode(float value) { return glm::packUnorm1x16(value); }
+  static float decode(storage_type value) { return glm::unpackUnorm1x16(value); }
+};
+
+// [-1, 1] in 8 bits
+struct Snorm8 {
+  using storage_type = uint8_t;
+
+  static constexpr VkFormat formats[5] = {VK_FORMAT_UNDEFINED,
+                                          VK_FORMAT_R8_SNORM,
+                                          VK_FORMAT_R8G8_SNORM,
+                                          VK_FORMAT_R8G8B8_SNORM,
+                                          VK_FORMAT_R8G8B8A8_SNORM};
+
+  static storage_type encode(float value) { return glm::packSnorm1x8(value); }
+  static float decode(storage_type value) { return glm::unpackSnorm1x8(value); }
+};
+
+// [0, 1] in 8 bits
+struct Unorm8 {
+  using storage_type = uint8_t;
+
+  static constexpr VkFormat formats[5] = {VK_FORMAT_UNDEFINED,
+                                          VK_FORMAT_R8_UNORM,
+                                          VK_FORMAT_R8G8_UNORM,
+                                          VK_FORMAT_R8G8B8_UNORM,
+                                          VK_FORMAT_R8G8B8A8_UNORM};
+
+  static storage_type encode(float value) { return glm::packUnorm1x8(value); }
+  static float decode(storage_type value) { return glm::unpackUnorm1x8(value); }
+};
+
+//
+// A vector of N components packed with `Encoding`. It can be used as a member of the vertex
+// templates in Vertex.h in place of the glm float vectors.
+//
+// Prefer 2- and 4-component vectors: 3-component 8/16-bit formats are rarely supported as vertex
+// buffer formats.
+//
+template <typename Encoding, glm::length_t N>
+struct Quantized {
+  using encoding_type = Encoding;
+  using storage_type  = typename Encoding::storage_type;
+  using vec_type      = glm::vec<N, float>;
+
+  static constexpr glm::length_t length = N;
+
+  storage_type data[N];
+
+  Quantized() = default;
+  explicit Quantized(const vec_type& value) {
+    for (glm::length_t i = 0; i < N; ++i) {
+      data[i] = Encoding::encode(value[i]);
+    }
+  }
+
+  [[nodiscard]] vec_type unpack() const {
+    vec_type value;
+    for (glm::length_t i = 0; i < N; ++i) {
+      value[i] = Encoding::decode(data[i]);
+    }
+    return value;
+  }
+
+  bool operator==(const Quantized& rhs) const = default;
+};
+
+using half2 = Quantized<Half, 2>;
+using half4 = Quantized<Half, 4>;
+
+using snorm16x2 = Quantized<Snorm16, 2>;
+using snorm16x4 = Quantized<Snorm16, 4>;
+using unorm16x2 = Quantized<Unorm16, 2>;
+using unorm16x4 = Quantized<Unorm16, 4>;
+
+using snorm8x4 = Quantized<Snorm8, 4>;
+using unorm8x4 = Quantized<Unorm8, 4>;
+
+template <typename Encoding, glm::length_t N>
+struct ImageTrait<Quantized<Encoding, N>> {
+  [[maybe_unused]] static constexpr VkFormat format    = Encoding::formats[N];
+  [[maybe_unused]] static constexpr uint32_t size      = sizeof(Quantized<Encoding, N>);
+  [[maybe_unused]] static constexpr uint32_t dimension = N;
+};
+
+static_assert(sizeof(half4) == 8 && sizeof(snorm16x2) == 4 && sizeof(unorm8x4) == 4);
+
+MI_NAMESPACE_END(Vulk)
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <volk/volk.h>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Vulk/internal/base.h>
+
+#include <Vulk/Buffer.h>
+#include <Vulk/CommandBuffer.h>
+#include <Vulk/DepthImage.h>
+#include <Vulk/DeviceMemory.h>
+#include <Vulk/Image2D.h>
+#include <Vulk/Semaphore.h>
+#include <Vulk/Fence.h>
+
+#include <Vulk/engine/DeviceContext.h>
+#include <Vulk/engine/FrameContext.h>
+#include <Vulk/engine/RenderTask.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+//
+// A frame graph of `RenderTask`s. The passes declare the resources they read and write, and
+// `compile()` derives the rest from them:
+//  - The passes are ordered by their dependencies, keeping the passes of the same queue together.
+//  - The consecutive passes of the same queue are recorded into one command buffer and submitted
+//    once. The `run()` of the tasks only records since the command buffer is already recording
+//    (see `CommandBuffer::beginRecording()`).
+//  - A memory barrier is recorded before a pass only for the hazards on the resources it declares,
+//    and a semaphore between the submissions of dependent passes.
+//  - The transient images with disjoint lifetimes share the same memory.
+//
+// The content of the transient images doesn't survive a frame, except for the outputs, which are
+// kept until the next frame. The graph is used by one frame in flight; create one per frame.
+//
+// The imported resources used by several queue families are the business of the tasks (e.g.
+// concurrent sharing or their own ownership transfers), while the transient images are transferred
+// by the graph.
+//
+class RenderGraph : public Sharable<RenderGraph>, private NotCopyable {
+ public:
+  using Resource = uint32_t;
+
+  class PassBuilder {
+   public:
+    // The pass accesses `resource` by `access` at `stages`. A write is ordered after all the
+    // previous accesses of the resource and a read after the previous write. If `layout` is not
+    // VK_IMAGE_LAYOUT_UNDEFINED, the image is transitioned to it before the pass.
+    void read(Resource resource,
+              VkPipelineStageFlags stages,
+              VkAccessFlags access,
+              VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED);
+    void write(Resource resource,
+               VkPipelineStageFlags stages,
+               VkAccessFlags access,
+               VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED);
+
+   private:
+    PassBuilder(RenderGraph& graph, uint32_t pass) : _graph(graph), _pass(pass) {}
+
+    RenderGraph& _graph;
+    uint32_t _pass;
+
+    friend class RenderGraph;
+  };
+
+  using SetupFunc = std::function<void(PassBuilder& builder)>;
+  // Called before the `run()` of the task to prepare it with the resources of the graph. The task
+  // shouldn't wait for any semaphore; the graph synchronizes the passes.
+  using PrepareFunc = std::function<void(const RenderGraph& graph)>;
+
+  struct Statistics {
+    uint32_t numPasses      = 0;
+    uint32_t numSubmissions = 0; // Per frame
+    uint32_t numBarriers    = 0; // Per frame, not counting the ones recorded by the tasks
+
+    VkDeviceSize transientMemory = 0; // Allocated for the transient images
+    VkDeviceSize unaliasedMemory = 0; // Required by the transient images without aliasing
+  };
+
+ public:
+  explicit RenderGraph(const DeviceContext& deviceContext);
+  ~RenderGraph() override;
+
+  // Transient images, created by `compile()`
+  Resource createImage(const std::string& name,
+                       VkFormat format,
+                       VkExtent2D extent,
+                       Image2D::Usage usage);
+  Resource createDepthImage(const std::string& name, VkFormat format, VkExtent2D extent);
+  // Resources owned by the caller, e.g. textures and vertex buffers
+  Resource importImage(const std::string& name, const Image& image);
+  Resource importBuffer(const std::string& name, const Buffer& buffer);
+
+  // Keep the content of the transient `resource` after the frame, e.g. to present it.
+  void markOutput(Resource resource);
+
+  // The `run()` of `task` must leave the command buffer of the graph recording, i.e. balance its
+  // `beginRecording()` and `endRecording()`.
+  void addPass(const std::string& name,
+               RenderTask& task,
+               const SetupFunc& setup,
+               PrepareFunc prepare);
+
+  void compile();
+
+  // Run the passes of a frame. The first submission waits for `waits`. The returned semaphore and
+  // fence are signaled when all the passes are done.
+  std::pair<Semaphore::shared_ptr, Fence::shared_ptr> execute(
+      FrameContext& frameContext,
+      const std::vector<Semaphore::shared_ptr>& waits = {});
+
+  // Prepare and record the passes on the threads of TBB, following their dependencies, instead of
+  // one after another on the calling thread. Each pass is recorded into a command buffer of its
+  // thread, and the command buffers are joined and submitted in order by the calling thread.
+  //
+  // The barriers and layout transitions of the graph are recorded before the passes, so the tasks
+  // must leave the images in the layouts they declare. The prepare functions run concurrently.
+  void setParallelRecording(bool enabled) { _parallelRecording = enabled; }
+  [[nodiscard]] bool isParallelRecording() const { return _parallelRecording; }
+
+  [[nodiscard]] const Image& image(Resource resource) const;
+  [[nodiscard]] const Image2D& image2D(Resource resource) const;
+  [[nodiscard]] const DepthImage& depthImage(Resource resource) const;
+  [[nodiscard]] const Buffer& buffer(Resource resource) const;
+
+  [[nodiscard]] const Statistics& statistics() const { return _statistics; }
+
+  [[nodiscard]] bool isCompiled() const { return _compiled; }
+
+  [[nodiscard]] const Device& device() const { return _deviceContext.device(); }
+
+ private:
+  enum class ResourceType { Image, DepthImage, ImportedImage, ImportedBuffer };
+
+  struct ResourceInfo {
+    std::string name;
+    ResourceType type;
+
+    // Of the transient images
+    VkFormat format      = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent    = {0, 0};
+    Image2D::Usage usage = Image2D::Usage::NONE;
+    bool output          = false;
+
+    Image::shared_ptr_const image;
+    Buffer::shared_ptr_const buffer;
+
+    // The first and last uses in the execution order, set by `compile()`
+    uint32_t first = 0;
+    uint32_t last  = 0;
+    // The transient images used before in the same memory, set by `compile()`
+    std::vector<Resource> aliases;
+
+    [[nodiscard]] bool isTransient() const {
+      return type == ResourceType::Image || type == ResourceType::DepthImage;
+    }
+  };
+
+  struct Access {
+    Resource resource;
+    VkPipelineStageFlags stages;
+    VkAccessFlags access;
+    VkImageLayout layout;
+    bool write;
+  };
+
+  struct Pass {
+    std::string name;
+    RenderTask* task;
+    PrepareFunc prepare;
+    std::vector<Access> accesses;
+
+    std::vector<uint32_t> dependencies; // The passes to run before, by index
+    uint32_t batch = 0;
+
+    // The barrier recorded before the pass, if any
+    VkPipelineStageFlags srcStages = 0;
+    VkAccessFlags srcAccess        = 0;
+    VkPipelineStageFlags dstStages = 0;
+    VkAccessFlags dstAccess        = 0;
+  };
+
+  struct OwnershipTransfer {
+    Resource resource;
+    uint32_t srcBatch;
+    uint32_t dstBatch;
+  };
+
+  // The passes submitted together on one queue
+  struct Batch {
+    RenderTask::Type type;
+    std::vector<uint32_t> passes;      // In the execution order
+    std::vector<uint32_t> waitBatches; // One semaphore from each of them
+  };
+
+  void addAccess(uint32_t pass, const Access& access);
+
+  void schedule();
+  void buildBatches();
+  void buildBarriers();
+  void allocateTransientImages();
+
+  // The stages of all the accesses of `pass` to `resource` and the access flags of its writes
+  [[nodiscard]] VkPipelineStageFlags stagesOf(uint32_t pass, Resource resource) const;
+  [[nodiscard]] VkAccessFlags writesOf(uint32_t pass, Resource resource) const;
+  // A chain of semaphores orders the batch `to` after the batch `from`.
+  [[nodiscard]] bool isBatchReachable(uint32_t from, uint32_t to) const;
+  [[nodiscard]] uint32_t queueFamilyIndex(const Batch& batch) const;
+
+  // The command buffers of each batch, in the order of submission
+  std::vector<std::vector<CommandBuffer::shared_ptr>> recordInSequence(
+      FrameContext& frameContext) const;
+  std::vector<std::vector<CommandBuffer::shared_ptr>> recordInParallel(
+      FrameContext& frameContext) const;
+
+  void recordAcquires(uint32_t batch, const CommandBuffer& commandBuffer) const;
+  void recordReleases(uint32_t batch, const CommandBuffer& commandBuffer) const;
+  [[nodiscard]] bool hasBarriers(const Pass& pass) const;
+  void recordBarriers(const Pass& pass, const CommandBuffer& commandBuffer) const;
+  void recordPass(const Pass& pass,
+                  FrameContext& frameContext,
+                  const CommandBuffer::shared_ptr& commandBuffer) const;
+
+ private:
+  const DeviceContext& _deviceContext;
+
+  std::vector<ResourceInfo> _resources;
+  std::vector<Pass> _passes;
+
+  // Set by `compile()`
+  std::vector<uint32_t> _order; // Indices of the passes in the execution order
+  std::vector<Batch> _batches;
+  std::vector<OwnershipTransfer> _transfers;
+  std::vector<DeviceMemory::shared_ptr> _memories;
+  Statistics _statistics;
+  bool _compiled = false;
+
+  bool _parallelRecording = false;
+};
+
+MI_NAMESPACE_END(Vulk)
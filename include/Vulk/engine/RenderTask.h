@@ -7,6 +7,7 @@
 #include <Vulk/CommandBuffer.h>
 #include <Vulk/Semaphore.h>
 #include <Vulk/Fence.h>
+#include <Vulk/QueryPool.h>
 
 
 MI_NAMESPACE_BEGIN(Vulk)
@@ -24,15 +25,35 @@ class RenderTask : public Sharable<RenderTask>, private NotCopyable {
 
   const Device& device() const { return _deviceContext.device(); }
 
+  // Record and submit the commands of the task. In a `RenderGraph` pass they are only recorded, and
+  // the returned semaphore and fence are never signaled (see `RenderGraph::addPass()`).
   virtual std::pair<Semaphore::shared_ptr, Fence::shared_ptr> run() = 0;
   [[nodiscard]] virtual DescriptorSetLayout::shared_ptr descriptorSetLayout() = 0;
+  // The layouts of all the sets the task acquires from the frame context, to size its pools
+  [[nodiscard]] virtual std::vector<DescriptorSetLayout::shared_ptr> descriptorSetLayouts() {
+    return {descriptorSetLayout()};
+  }
 
   // Before each frame pass, you need to call this function to set the active frame context.
-  void setFrameContext(FrameContext& frameContext);
+  // The commands are recorded into `commandBuffer` if given, e.g. one shared by the tasks of a
+  // `RenderGraph` submission, instead of a new one from `frameContext`.
+  void setFrameContext(FrameContext& frameContext,
+                       CommandBuffer::shared_ptr commandBuffer = nullptr);
+
+  [[nodiscard]] Type type() const { return _type; }
 
   [[nodiscard]] uint32_t id() const { return _id; }
 
+  // Write GPU timestamps into `queryPool[firstQuery]` and `queryPool[firstQuery + 1]` when the
+  // commands of `run()` start and finish. Pass nullptr to stop writing them.
+  void prepareTimestamps(const QueryPool* queryPool, uint32_t firstQuery = 0);
+
  protected:
+  // To be called by `run()` at the beginning and the end of the command recording. The queries
+  // are reset in the same command buffer.
+  void writeBeginTimestamp() const;
+  void writeEndTimestamp() const;
+
   const DeviceContext& _deviceContext;
   FrameContext* _frameContext;
 
@@ -41,6 +62,9 @@ class RenderTask : public Sharable<RenderTask>, private NotCopyable {
   static uint32_t _nextId; // The next id to assign to the next render task.
 
   CommandBuffer::shared_ptr _commandBuffer;
+
+  QueryPool::shared_ptr_const _timestamps;
+  uint32_t _firstTimestamp = 0;
 };
 
 
@@ -8,6 +8,8 @@
 #include <Vulk/ImageView.h>
 #include <Vulk/Sampler.h>
 
+#include <Vulk/engine/BindlessTextureTable.h>
+
 MI_NAMESPACE_BEGIN(Vulk)
 
 class Device;
@@ -26,7 +28,7 @@ class Texture2D : public Sharable<Texture2D>, private NotCopyable {
             Image2D::Usage usage    = Image2D::Usage::NONE,
             Filter filter           = {VK_FILTER_LINEAR},
             AddressMode addressMode = {VK_SAMPLER_ADDRESS_MODE_REPEAT});
-  ~Texture2D() override = default;
+  ~Texture2D() override;
 
   void create(const Device& device,
               VkFormat format,
@@ -88,6 +90,12 @@ class Texture2D : public Sharable<Texture2D>, private NotCopyable {
   ImageView& view() { return *_view; }
   Sampler& sampler() { return *_sampler; }
 
+  // Add the texture to `table`, which must be owned by a shared pointer. The texture is removed
+  // from the table when destroyed.
+  BindlessTextureTable::Slot registerTo(BindlessTextureTable& table);
+  [[nodiscard]] BindlessTextureTable::Slot bindlessSlot() const { return _bindlessSlot; }
+  [[nodiscard]] bool isRegistered() const { return !_bindlessTable.expired(); }
+
   // Note the input reference will lost the ownership of the data
   void setView(ImageView::shared_ptr view) { _view = view; }
   void setSampler(Sampler::shared_ptr sampler) { _sampler = sampler; }
@@ -115,10 +123,16 @@ class Texture2D : public Sharable<Texture2D>, private NotCopyable {
     return {binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, stage, nullptr};
   }
 
+ private:
+  void unregister();
+
  private:
   Image2D::shared_ptr _image;
   ImageView::shared_ptr _view;
   Sampler::shared_ptr _sampler;
+
+  BindlessTextureTable::weak_ptr _bindlessTable;
+  BindlessTextureTable::Slot _bindlessSlot;
 };
 
 MI_NAMESPACE_END(Vulk)
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <Vulk/StagingBuffer.h>
 
 #include <Vulk/engine/DeviceContext.h>
+#include <Vulk/engine/MappedFile.h>
 #include <Vulk/engine/Texture2D.h>
 
 #include <tuple>
@@ -27,6 +28,18 @@ class Toolbox {
                                         const uint8_t* data,
                                         uint32_t width,
                                         uint32_t height) const;
+  // Raw (uncompressed) texels are streamed from the file mapping into the staging memory.
+  Texture2D::shared_ptr createTexture2D(TextureFormat format,
+                                        const MappedFile& file,
+                                        size_t offset,
+                                        uint32_t width,
+                                        uint32_t height) const;
+
+  // Copy `[offset, offset + size)` of the file straight into a new staging buffer. Large files are
+  // streamed in chunks so only a bounded window of the file is resident at any time.
+  StagingBuffer::shared_ptr createStagingBuffer(const MappedFile& file,
+                                                size_t offset,
+                                                size_t size) const;
 
   Toolbox(const Toolbox& rhs)            = delete;
   Toolbox& operator=(const Toolbox& rhs) = delete;
@@ -38,6 +51,15 @@ class Toolbox {
       const char* imageFile) const;
   StagingBuffer::shared_ptr createStagingBuffer(const uint8_t* data, uint32_t size) const;
 
+  Texture2D::shared_ptr createTexture2D(TextureFormat format,
+                                        const StagingBuffer& stagingBuffer,
+                                        uint32_t width,
+                                        uint32_t height) const;
+
+  // Copy `stagingBuffer` into `image` on the transfer queue, then hand the image over to the
+  // graphics queue family in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+  void upload(Image& image, const StagingBuffer& stagingBuffer) const;
+
  private:
   const DeviceContext& _context;
 };
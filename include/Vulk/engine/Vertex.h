@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Vulk/engine/TypeTraits.h>
+#include <Vulk/engine/Quantized.h>
 
 #include <vector>
 
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
 #include <Vulk/internal/base.h>
 
 #define MI_INIT_VKPROC(cmd)                                                       \
@@ -39,4 +43,19 @@ bool contain(const Container& container, const Element& element) {
   return std::find(container.begin(), container.end(), element) != container.end();
 }
 
+// The non-dispatchable handles are pointers on 64-bit platforms and integers elsewhere.
+template <typename Handle>
+uint64_t handleBits(Handle handle) {
+  if constexpr (std::is_pointer_v<Handle>) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+  } else {
+    return static_cast<uint64_t>(handle);
+  }
+}
+
+// Mix `value` into the hash `seed`, as boost::hash_combine()
+inline void hashCombine(size_t& seed, uint64_t value) {
+  seed ^= std::hash<uint64_t>{}(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
 MI_NAMESPACE_END(Vulk)
\ No newline at end of file
@@ -1,13 +1,16 @@
 #include <Vulk/Buffer.h>
 
+#include <algorithm>
 #include <cstring>
 
 #include <Vulk/Device.h>
 #include <Vulk/DeviceMemory.h>
 #include <Vulk/CommandBuffer.h>
 #include <Vulk/Queue.h>
+#include <Vulk/QueuePool.h>
 #include <Vulk/StagingBuffer.h>
 #include <Vulk/internal/debug.h>
+#include <Vulk/internal/helpers.h>
 
 MI_NAMESPACE_BEGIN(Vulk)
 
@@ -64,6 +67,7 @@ void Buffer::destroy() {
   if (isAllocated()) {
     free();
   }
+  device().notifyHandleDestroyed(handleBits(_buffer));
   vkDestroyBuffer(device(), _buffer, nullptr);
 
   _buffer = VK_NULL_HANDLE;
@@ -90,27 +94,157 @@ void Buffer::load(const void* data, VkDeviceSize size, VkDeviceSize offset, bool
   MI_VERIFY(offset + size <= _size);
 
   if (staging) {
-    const auto& commandPool = device().commandPool(Device::QueueFamilyType::Transfer);
-
-    CommandBuffer::shared_ptr commandBuffer = CommandBuffer::make_shared(commandPool);
     StagingBuffer::shared_ptr stagingBuffer = StagingBuffer::make_shared(device(), size);
-    Fence::shared_ptr fence                 = Fence::make_shared(device());
-
     stagingBuffer->copyFromHost(data, size);
-    stagingBuffer->copyToBuffer(*commandBuffer, *this, {0, offset, size}, *fence);
-
-    // The commandBuffer now should be submitted and in the pending state
-    MI_ASSERT(commandBuffer->state() == CommandBuffer::State::Pending);
-    fence->wait();
+    upload(*stagingBuffer, {{0, offset, size}});
   } else {
     std::memcpy(map(offset, size), data, size);
     unmap();
   }
+  _hasContent = true;
+}
+
+void Buffer::loadRegions(const void* data, std::vector<VkBufferCopy> regions, bool staging) {
+  MI_VERIFY(isAllocated());
+
+  // Coalesce the regions which are contiguous in both the source and the destination.
+  std::sort(regions.begin(), regions.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.dstOffset < rhs.dstOffset;
+  });
+  std::vector<VkBufferCopy> coalesced;
+  coalesced.reserve(regions.size());
+  for (const auto& region : regions) {
+    if (region.size == 0) {
+      continue;
+    }
+    MI_VERIFY(region.dstOffset + region.size <= _size);
+
+    if (!coalesced.empty()) {
+      auto& last = coalesced.back();
+      if (last.dstOffset + last.size >= region.dstOffset &&
+          region.dstOffset - last.dstOffset == region.srcOffset - last.srcOffset) {
+        last.size = std::max(last.size, region.dstOffset + region.size - last.dstOffset);
+        continue;
+      }
+    }
+    coalesced.push_back(region);
+  }
+  if (coalesced.empty()) {
+    return;
+  }
+
+  const auto* src = static_cast<const uint8_t*>(data);
+
+  if (staging) {
+    VkDeviceSize stagingSize = 0;
+    for (const auto& region : coalesced) {
+      stagingSize += region.size;
+    }
+
+    StagingBuffer::shared_ptr stagingBuffer = StagingBuffer::make_shared(device(), stagingSize);
+
+    // Pack the regions back to back in the staging buffer.
+    VkDeviceSize stagingOffset = 0;
+    for (auto& region : coalesced) {
+      stagingBuffer->copyFromHost(src + region.srcOffset, stagingOffset, region.size);
+      region.srcOffset = stagingOffset;
+      stagingOffset += region.size;
+    }
+    upload(*stagingBuffer, coalesced);
+  } else {
+    const VkDeviceSize first = coalesced.front().dstOffset;
+    const VkDeviceSize last  = coalesced.back().dstOffset + coalesced.back().size;
+
+    auto* dst = static_cast<uint8_t*>(map(first, last - first));
+    for (const auto& region : coalesced) {
+      std::memcpy(dst + (region.dstOffset - first), src + region.srcOffset, region.size);
+    }
+    unmap();
+  }
+  _hasContent = true;
+}
+
+void Buffer::upload(const StagingBuffer& stagingBuffer, const std::vector<VkBufferCopy>& regions) {
+  const auto& device = this->device();
+
+  const auto& transferQueue   = device.queuePool().queue(QueuePool::Workload::Streaming);
+  const auto ownerQueueFamily = device.queueFamilyIndex(_ownerQueueFamily);
+
+  const bool transferred =
+      ownerQueueFamily && *ownerQueueFamily != transferQueue.queueFamilyIndex();
+  const bool wholeBuffer =
+      regions.size() == 1 && regions.front().dstOffset == 0 && regions.front().size == _size;
+
+  // Without a release by the owner, the transfer family takes the buffer with undefined contents,
+  // which is only fine if the copy overwrites all of it.
+  CommandBuffer::shared_ptr release;
+  Semaphore::shared_ptr released;
+  if (transferred && _hasContent && !wholeBuffer) {
+    released = Semaphore::make_shared(device);
+    release  = CommandBuffer::make_shared(device.commandPool(_ownerQueueFamily));
+    release->recordCommands([&](const CommandBuffer& buffer) {
+      buffer.releaseBuffer(*this,
+                           VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                           VK_ACCESS_MEMORY_WRITE_BIT,
+                           transferQueue.queueFamilyIndex());
+    });
+    release->submitCommands({}, {released.get()});
+  }
+
+  const auto& commandPool                 = device.commandPool(Device::QueueFamilyType::Transfer);
+  CommandBuffer::shared_ptr commandBuffer = CommandBuffer::make_shared(commandPool);
+  Fence::shared_ptr fence                 = Fence::make_shared(device);
+
+  commandBuffer->beginRecording(CommandBuffer::Usage::OneTimeSubmit);
+  {
+    if (released) {
+      commandBuffer->acquireBuffer(*this,
+                                   *ownerQueueFamily,
+                                   VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                   VK_ACCESS_TRANSFER_WRITE_BIT);
+    }
+    stagingBuffer.copyToBuffer(*commandBuffer, *this, regions);
+    if (ownerQueueFamily) {
+      commandBuffer->releaseBuffer(*this,
+                                   VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                   VK_ACCESS_TRANSFER_WRITE_BIT,
+                                   *ownerQueueFamily);
+    }
+  }
+  commandBuffer->endRecording();
+
+  if (!transferred) {
+    commandBuffer->submitCommandsTo(transferQueue, {}, {}, *fence);
+    fence->wait();
+    return;
+  }
+
+  // The owner acquires the buffer once the copy is done. Its later commands on the same queue are
+  // in the destination scope of the acquire.
+  Semaphore::shared_ptr copied = Semaphore::make_shared(device);
+  std::vector<Semaphore*> waits;
+  if (released) {
+    waits.push_back(released.get());
+  }
+  commandBuffer->submitCommandsTo(transferQueue, waits, {copied.get()});
+
+  const auto& ownerCommandPool          = device.commandPool(_ownerQueueFamily);
+  CommandBuffer::shared_ptr acquisition = CommandBuffer::make_shared(ownerCommandPool);
+  acquisition->recordCommands([&](const CommandBuffer& buffer) {
+    buffer.acquireBuffer(*this,
+                         transferQueue.queueFamilyIndex(),
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+  });
+  acquisition->submitCommands({copied.get()}, {}, *fence);
+
+  fence->wait();
 }
 
 void Buffer::free() {
   MI_VERIFY(isAllocated());
-  _memory = nullptr;
+  _memory     = nullptr;
+  _hasContent = false;
 }
 
 void Buffer::bind(DeviceMemory& memory, VkDeviceSize offset) {
@@ -5,6 +5,7 @@
 
 #include <Vulk/CommandPool.h>
 #include <Vulk/Device.h>
+#include <Vulk/Queue.h>
 #include <Vulk/Pipeline.h>
 #include <Vulk/RenderPass.h>
 #include <Vulk/Framebuffer.h>
@@ -89,8 +90,16 @@ void CommandBuffer::endRecording() const {
 void CommandBuffer::submitCommands(const std::vector<Semaphore*>& waits,
                                    const std::vector<Semaphore*>& signals,
                                    const Fence& fence) const {
+  submitCommandsTo(queue(), waits, signals, fence);
+}
+
+void CommandBuffer::submitCommandsTo(const Queue& queue,
+                                     const std::vector<Semaphore*>& waits,
+                                     const std::vector<Semaphore*>& signals,
+                                     const Fence& fence) const {
+  MI_VERIFY(queue.queueFamilyIndex() == this->queue().queueFamilyIndex());
   if (_recordingStack == 0) {
-    queue().submitCommands(*this, waits, signals, fence);
+    queue.submitCommands(*this, waits, signals, fence);
     _state = State::Pending;
   }
 }
@@ -127,7 +136,7 @@ void CommandBuffer::endRenderpass() const {
 }
 
 void CommandBuffer::bindPipeline(const Pipeline& pipeline) const {
-  vkCmdBindPipeline(_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+  vkCmdBindPipeline(_buffer, pipeline.bindPoint(), pipeline);
 }
 
 void CommandBuffer::setViewport(const glm::vec2& upperLeft,
@@ -148,7 +157,7 @@ void CommandBuffer::setViewport(const glm::vec2& upperLeft,
   vkCmdSetScissor(_buffer, 0, 1, &scissor);
 }
 
-void CommandBuffer::bindVertexBuffer(const VertexBuffer& buffer,
+void CommandBuffer::bindVertexBuffer(const Buffer& buffer,
                                      uint32_t binding,
                                      uint64_t offset) const {
   VkBuffer vertexBuffers[] = {buffer};
@@ -161,9 +170,20 @@ void CommandBuffer::bindIndexBuffer(const IndexBuffer& buffer, uint64_t offset)
 }
 
 void CommandBuffer::bindDescriptorSet(const Pipeline& pipeline,
-                                      const DescriptorSet& descriptorSet) const {
+                                      const DescriptorSet& descriptorSet,
+                                      uint32_t set) const {
+  MI_VERIFY(set < pipeline.numDescriptorSets());
   vkCmdBindDescriptorSets(
-      _buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout(), 0, 1, descriptorSet, 0, nullptr);
+      _buffer, pipeline.bindPoint(), pipeline.layout(), set, 1, descriptorSet, 0, nullptr);
+}
+
+void CommandBuffer::pushConstants(const Pipeline& pipeline,
+                                  const void* data,
+                                  uint32_t size,
+                                  uint32_t offset) const {
+  const auto& range = pipeline.pushConstantRange();
+  MI_VERIFY(offset + size <= range.size);
+  vkCmdPushConstants(_buffer, pipeline.layout(), range.stageFlags, offset, size, data);
 }
 
 void CommandBuffer::draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex) const {
@@ -176,6 +196,89 @@ void CommandBuffer::drawIndexed(uint32_t indexCount,
   vkCmdDrawIndexed(_buffer, indexCount, instanceCount, firstIndex, 0, 0);
 }
 
+void CommandBuffer::dispatch(uint32_t groupCountX,
+                             uint32_t groupCountY,
+                             uint32_t groupCountZ) const {
+  vkCmdDispatch(_buffer, groupCountX, groupCountY, groupCountZ);
+}
+
+void CommandBuffer::dispatchIndirect(const Buffer& buffer, VkDeviceSize offset) const {
+  vkCmdDispatchIndirect(_buffer, buffer, offset);
+}
+
+void CommandBuffer::copyBuffer(const Buffer& src, const Buffer& dst, VkDeviceSize size) const {
+  const VkBufferCopy region{0, 0, size};
+  vkCmdCopyBuffer(_buffer, src, dst, 1, &region);
+}
+
+void CommandBuffer::memoryBarrier(VkPipelineStageFlags srcStage,
+                                  VkAccessFlags srcAccess,
+                                  VkPipelineStageFlags dstStage,
+                                  VkAccessFlags dstAccess) const {
+  VkMemoryBarrier barrier{};
+  barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier.srcAccessMask = srcAccess;
+  barrier.dstAccessMask = dstAccess;
+
+  vkCmdPipelineBarrier(_buffer, srcStage, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void CommandBuffer::bufferBarrier(const Buffer& buffer,
+                                  VkPipelineStageFlags srcStage,
+                                  VkAccessFlags srcAccess,
+                                  VkPipelineStageFlags dstStage,
+                                  VkAccessFlags dstAccess,
+                                  uint32_t srcQueueFamily,
+                                  uint32_t dstQueueFamily) const {
+  VkBufferMemoryBarrier barrier{};
+  barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  barrier.srcAccessMask       = srcAccess;
+  barrier.dstAccessMask       = dstAccess;
+  barrier.srcQueueFamilyIndex = srcQueueFamily;
+  barrier.dstQueueFamilyIndex = dstQueueFamily;
+  barrier.buffer              = buffer;
+  barrier.offset              = 0;
+  barrier.size                = VK_WHOLE_SIZE;
+
+  vkCmdPipelineBarrier(_buffer, srcStage, dstStage, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+void CommandBuffer::releaseBuffer(const Buffer& buffer,
+                                  VkPipelineStageFlags srcStage,
+                                  VkAccessFlags srcAccess,
+                                  uint32_t dstQueueFamily) const {
+  const uint32_t queueFamily = queue().queueFamilyIndex();
+  if (queueFamily == dstQueueFamily) {
+    return;
+  }
+  // The destination scope is ignored by a release; the acquire provides it.
+  bufferBarrier(buffer,
+                srcStage,
+                srcAccess,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                0,
+                queueFamily,
+                dstQueueFamily);
+}
+
+void CommandBuffer::acquireBuffer(const Buffer& buffer,
+                                  uint32_t srcQueueFamily,
+                                  VkPipelineStageFlags dstStage,
+                                  VkAccessFlags dstAccess) const {
+  const uint32_t queueFamily = queue().queueFamilyIndex();
+  if (queueFamily == srcQueueFamily) {
+    return;
+  }
+  // The source scope is ignored by an acquire; the semaphore wait provides it.
+  bufferBarrier(buffer,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                0,
+                dstStage,
+                dstAccess,
+                srcQueueFamily,
+                queueFamily);
+}
+
 void CommandBuffer::beginLabel(const char* label, const glm::vec4& color) const {
   if (vkCmdBeginDebugUtilsLabelEXT) {
     VkDebugUtilsLabelEXT labelInfo{};
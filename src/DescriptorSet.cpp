@@ -2,6 +2,7 @@
 
 #include <Vulk/DescriptorPool.h>
 #include <Vulk/DescriptorSetLayout.h>
+#include <Vulk/DescriptorUpdateTemplate.h>
 #include <Vulk/Device.h>
 #include <Vulk/internal/debug.h>
 
@@ -72,21 +73,37 @@ void DescriptorSet::bind(const std::vector<Binding>& bindings) const {
 
     MI_VERIFY(bindings[i].name == layoutBindings[i].name &&
               bindings[i].type == layoutBindings[i].type);
-    if (layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
-      MI_VERIFY(bindings[i].bufferInfo != nullptr);
-      writes[i].pBufferInfo = bindings[i].bufferInfo;
-    } else if (layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
-      MI_VERIFY(bindings[i].imageInfo != nullptr);
-      writes[i].pImageInfo = bindings[i].imageInfo;
+    switch (layoutBinding.descriptorType) {
+      case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+      case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        MI_VERIFY(bindings[i].bufferInfo != nullptr);
+        writes[i].pBufferInfo = bindings[i].bufferInfo;
+        break;
+      // The image view of a storage image has no sampler and is in VK_IMAGE_LAYOUT_GENERAL.
+      case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+      case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        MI_VERIFY(bindings[i].imageInfo != nullptr);
+        writes[i].pImageInfo = bindings[i].imageInfo;
+        break;
+      default:
+        // We only support these types for now.
+        // TODO: support other types.
+        MI_ASSERT_MSG(false,
+                      "Unsupported descriptor type %d of [%s]",
+                      layoutBinding.descriptorType,
+                      bindings[i].name.c_str());
     }
-
-    // We only support these two types for now.
-    // TODO: support other types.
-    MI_ASSERT(layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
-              layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
   }
 
   vkUpdateDescriptorSets(pool->device(), writes.size(), writes.data(), 0, nullptr);
 }
 
+void DescriptorSet::update(const DescriptorUpdateTemplate& updateTemplate,
+                           const Info* infos) const {
+  MI_VERIFY(isAllocated());
+  MI_ASSERT(_layout.lock().get() == &updateTemplate.layout());
+
+  vkUpdateDescriptorSetWithTemplate(updateTemplate.device(), _set, updateTemplate, infos);
+}
+
 MI_NAMESPACE_END(Vulk)
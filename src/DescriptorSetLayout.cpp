@@ -1,26 +1,33 @@
 #include <Vulk/DescriptorSetLayout.h>
 
 #include <Vulk/Device.h>
+#include <Vulk/LayoutCache.h>
 #include <Vulk/ShaderModule.h>
 #include <Vulk/internal/debug.h>
 
 #include <map>
 #include <vector>
 #include <algorithm>
+#include <iterator>
 
 MI_NAMESPACE_BEGIN(Vulk)
 
-DescriptorSetLayout::DescriptorSetLayout(const Device& device, std::vector<const ShaderModule*> shaders) {
-  create(device, std::move(shaders));
+DescriptorSetLayout::DescriptorSetLayout(const Device& device,
+                                         std::vector<const ShaderModule*> shaders,
+                                         uint32_t set) {
+  create(device, std::move(shaders), set);
 }
 
 DescriptorSetLayout::DescriptorSetLayout(const Device& device,
                                          const VertexShader& vertShader,
-                                         const FragmentShader& fragShader) {
-  create(device, vertShader, fragShader);
+                                         const FragmentShader& fragShader,
+                                         uint32_t set) {
+  create(device, vertShader, fragShader, set);
 }
-DescriptorSetLayout::DescriptorSetLayout(const Device& device, const ComputeShader& compShader) {
-  create(device, compShader);
+DescriptorSetLayout::DescriptorSetLayout(const Device& device,
+                                         const ComputeShader& compShader,
+                                         uint32_t set) {
+  create(device, compShader, set);
 }
 
 DescriptorSetLayout::~DescriptorSetLayout() {
@@ -29,9 +36,12 @@ DescriptorSetLayout::~DescriptorSetLayout() {
   }
 }
 
-void DescriptorSetLayout::create(const Device& device, std::vector<const ShaderModule*> shaders) {
+void DescriptorSetLayout::create(const Device& device,
+                                 std::vector<const ShaderModule*> shaders,
+                                 uint32_t set) {
   MI_VERIFY(!isCreated());
   _device = device.get_weak();
+  _set    = set;
 
   size_t numBindings = 0;
   for (auto* shader : shaders) {
@@ -39,11 +49,12 @@ void DescriptorSetLayout::create(const Device& device, std::vector<const ShaderM
   }
   _bindings.reserve(numBindings);
 
-  // Append all bindings from all shaders to `_bindings`
+  // Append the bindings of `set` from all shaders to `_bindings`
   for (auto* shader : shaders) {
-    _bindings.insert(std::end(_bindings),
-                     std::begin(shader->descriptorSetLayoutBindings()),
-                     std::end(shader->descriptorSetLayoutBindings()));
+    std::copy_if(std::begin(shader->descriptorSetLayoutBindings()),
+                 std::end(shader->descriptorSetLayoutBindings()),
+                 std::back_inserter(_bindings),
+                 [set](const auto& binding) { return binding.set == set; });
   }
 
   // Sort the bindings in the order the binding number
@@ -72,6 +83,12 @@ void DescriptorSetLayout::create(const Device& device, std::vector<const ShaderM
     vkBindings.push_back(layoutBinding.vkBinding);
   }
 
+  if (device.hasCaches()) {
+    _layout = device.layoutCache().descriptorSetLayout(vkBindings);
+    _shared = true;
+    return;
+  }
+
   VkDescriptorSetLayoutCreateInfo layoutInfo{};
   layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
   layoutInfo.bindingCount = static_cast<uint32_t>(vkBindings.size());
@@ -82,19 +99,28 @@ void DescriptorSetLayout::create(const Device& device, std::vector<const ShaderM
 
 void DescriptorSetLayout::create(const Device& device,
                                  const VertexShader& vertShader,
-                                 const FragmentShader& fragShader) {
+                                 const FragmentShader& fragShader,
+                                 uint32_t set) {
   create(device,
-         std::vector<const ShaderModule*>{(ShaderModule*)&vertShader, (ShaderModule*)&fragShader});
+         std::vector<const ShaderModule*>{(ShaderModule*)&vertShader, (ShaderModule*)&fragShader},
+         set);
 }
-void DescriptorSetLayout::create(const Device& device, const ComputeShader& compShader) {
-  create(device, std::vector<const ShaderModule*>{(ShaderModule*)&compShader});
+void DescriptorSetLayout::create(const Device& device,
+                                 const ComputeShader& compShader,
+                                 uint32_t set) {
+  create(device, std::vector<const ShaderModule*>{(ShaderModule*)&compShader}, set);
 }
 
 void DescriptorSetLayout::destroy() {
   MI_VERIFY(isCreated());
 
-  vkDestroyDescriptorSetLayout(device(), _layout, nullptr);
+  // A shared layout is destroyed by the cache.
+  if (!_shared) {
+    vkDestroyDescriptorSetLayout(device(), _layout, nullptr);
+  }
   _layout = VK_NULL_HANDLE;
+  _set    = 0;
+  _shared = false;
   _bindings.clear();
   _poolSizes.clear();
   _device.reset();
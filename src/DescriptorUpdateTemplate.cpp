@@ -0,0 +1,97 @@
+#include <Vulk/DescriptorUpdateTemplate.h>
+
+#include <Vulk/internal/debug.h>
+
+#include <Vulk/Device.h>
+#include <Vulk/DescriptorSet.h>
+#include <Vulk/DescriptorSetLayout.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(const DescriptorSetLayout& layout) {
+  create(layout);
+}
+
+DescriptorUpdateTemplate::~DescriptorUpdateTemplate() {
+  if (isCreated()) {
+    destroy();
+  }
+}
+
+void DescriptorUpdateTemplate::create(const DescriptorSetLayout& layout) {
+  MI_VERIFY(!isCreated());
+  MI_VERIFY_MSG(vkCreateDescriptorUpdateTemplate != nullptr,
+                "Descriptor update templates require Vulkan 1.1");
+
+  const auto& device = layout.device();
+  _device            = device.get_weak();
+  _layout            = layout.get_weak();
+
+  const auto& bindings = layout.bindings();
+  MI_VERIFY(!bindings.empty());
+
+  std::vector<VkDescriptorUpdateTemplateEntry> entries(bindings.size());
+  _types.resize(bindings.size());
+  for (size_t i = 0; i < bindings.size(); ++i) {
+    const auto& binding = bindings[i].vkBinding;
+    switch (binding.descriptorType) {
+      case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+      case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+      case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+      case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        break;
+      default:
+        // The same types as `DescriptorSet::bind()`
+        MI_VERIFY_MSG(false,
+                      "Unsupported descriptor type %d of [%s]",
+                      binding.descriptorType,
+                      bindings[i].name.c_str());
+    }
+    _types[i] = binding.descriptorType;
+
+    entries[i].dstBinding      = binding.binding;
+    entries[i].dstArrayElement = 0;
+    entries[i].descriptorCount = 1;
+    entries[i].descriptorType  = binding.descriptorType;
+    entries[i].offset          = i * sizeof(DescriptorSet::Info);
+    entries[i].stride          = sizeof(DescriptorSet::Info);
+  }
+
+  VkDescriptorUpdateTemplateCreateInfo createInfo{};
+  createInfo.sType                      = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+  createInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+  createInfo.pDescriptorUpdateEntries   = entries.data();
+  createInfo.templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+  createInfo.descriptorSetLayout        = layout;
+
+  MI_VERIFY_VK_RESULT(vkCreateDescriptorUpdateTemplate(device, &createInfo, nullptr, &_template));
+}
+
+void DescriptorUpdateTemplate::destroy() {
+  MI_VERIFY(isCreated());
+
+  vkDestroyDescriptorUpdateTemplate(device(), _template, nullptr);
+
+  _template = VK_NULL_HANDLE;
+  _types.clear();
+  _layout.reset();
+  _device.reset();
+}
+
+uint32_t DescriptorUpdateTemplate::index(const std::string& name, const std::string& type) const {
+  const auto& bindings = layout().bindings();
+  for (size_t i = 0; i < bindings.size(); ++i) {
+    if (bindings[i].name == name) {
+      MI_VERIFY_MSG(bindings[i].type == type,
+                    "The binding [%s] is of type [%s] instead of [%s]",
+                    name.c_str(),
+                    bindings[i].type.c_str(),
+                    type.c_str());
+      return static_cast<uint32_t>(i);
+    }
+  }
+  MI_VERIFY_MSG(false, "No binding [%s] in the descriptor set layout", name.c_str());
+  return kInvalidIndex;
+}
+
+MI_NAMESPACE_END(Vulk)
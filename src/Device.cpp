@@ -1,5 +1,6 @@
 #include <Vulk/Device.h>
 
+#include <algorithm>
 #include <set>
 #include <utility>
 
@@ -8,6 +9,11 @@
 #include <Vulk/Instance.h>
 #include <Vulk/PhysicalDevice.h>
 #include <Vulk/Queue.h>
+#include <Vulk/QueuePool.h>
+#include <Vulk/ImageViewCache.h>
+#include <Vulk/FramebufferCache.h>
+#include <Vulk/LayoutCache.h>
+#include <Vulk/PipelineCache.h>
 #include <Vulk/CommandPool.h>
 
 MI_NAMESPACE_BEGIN(Vulk)
@@ -15,8 +21,9 @@ MI_NAMESPACE_BEGIN(Vulk)
 Device::Device(const PhysicalDevice& physicalDevice,
                const PhysicalDevice::QueueFamilies& requiredQueueFamilies,
                const std::vector<const char*>& extensions,
+               const QueuePriorities& queuePriorities,
                const DeviceCreateInfoOverride& override) {
-  create(physicalDevice, requiredQueueFamilies, extensions, override);
+  create(physicalDevice, requiredQueueFamilies, extensions, queuePriorities, override);
 }
 
 Device::~Device() {
@@ -28,8 +35,10 @@ Device::~Device() {
 void Device::create(const PhysicalDevice& physicalDevice,
                     const PhysicalDevice::QueueFamilies& requiredQueueFamilies,
                     const std::vector<const char*>& extensions,
+                    const QueuePriorities& queuePriorities,
                     const DeviceCreateInfoOverride& override) {
   MI_VERIFY(!isCreated());
+  MI_VERIFY(!queuePriorities.empty());
   _physicalDevice = physicalDevice.get_weak();
 
   const auto& supportedQueueFamilies = physicalDevice.queueFamilies();
@@ -57,18 +66,28 @@ void Device::create(const PhysicalDevice& physicalDevice,
   }
 
   // Create the device.
+  uint32_t count = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &count, nullptr);
+  std::vector<VkQueueFamilyProperties> queueFamilyProperties(count);
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &count, queueFamilyProperties.data());
+
+  _queuePriorities = queuePriorities;
+
   std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-  float queuePriority = 1.0F;
   std::set<uint32_t> uniqueQueueFamilies;
   for (const auto& queueFamily : _queueFamilies) {
     uniqueQueueFamilies.insert(queueFamily.index);
   }
   for (uint32_t queueFamily : uniqueQueueFamilies) {
+    const auto queueCount = std::min(static_cast<uint32_t>(_queuePriorities.size()),
+                                     queueFamilyProperties[queueFamily].queueCount);
+    _queueCounts[queueFamily] = queueCount;
+
     VkDeviceQueueCreateInfo queueCreateInfo{};
     queueCreateInfo.sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
     queueCreateInfo.queueFamilyIndex = queueFamily;
-    queueCreateInfo.queueCount       = 1; // TODO For now we only allow one queue per family.
-    queueCreateInfo.pQueuePriorities = &queuePriority;
+    queueCreateInfo.queueCount       = queueCount;
+    queueCreateInfo.pQueuePriorities = _queuePriorities.data();
     queueCreateInfo.flags            = 0; // We have to set it to 0 for now.
     queueCreateInfos.push_back(queueCreateInfo);
   }
@@ -105,9 +124,16 @@ void Device::create(const PhysicalDevice& physicalDevice,
 
 void Device::initQueues() {
   MI_VERIFY(isCreated());
+  for (const auto& [familyIndex, queueCount] : _queueCounts) {
+    auto& queues = _familyQueues[familyIndex];
+    for (uint32_t i = 0; i < queueCount; ++i) {
+      queues.push_back(Queue::make_shared(*this, familyIndex, i, _queuePriorities[i]));
+    }
+  }
   for (const auto& queueFamily : _queueFamilies) {
-    _queues[queueFamily.type] = Queue::make_shared(*this, queueFamily.type, queueFamily.index);
+    _queues[queueFamily.type] = _familyQueues[queueFamily.index].front();
   }
+  _queuePool = QueuePool::make_shared(*this);
 }
 
 void Device::initCommandPools() {
@@ -117,6 +143,18 @@ void Device::initCommandPools() {
   }
 }
 
+void Device::initCaches() {
+  MI_VERIFY(isCreated());
+  _framebufferCache = FramebufferCache::make_shared(*this);
+  _imageViewCache   = ImageViewCache::make_shared(*this);
+  _layoutCache      = LayoutCache::make_shared(*this);
+}
+
+void Device::initPipelineCache(const std::string& filename) {
+  MI_VERIFY(isCreated());
+  _pipelineCache = PipelineCache::make_shared(*this, filename);
+}
+
 Queue& Device::queue(QueueFamilyType queueFamilyType) {
   MI_VERIFY(isCreated());
   MI_VERIFY(_queues[queueFamilyType]);
@@ -129,6 +167,38 @@ const Queue& Device::queue(QueueFamilyType queueFamilyType) const {
   return *_queues[queueFamilyType];
 }
 
+const std::vector<std::shared_ptr<Queue>>& Device::queues(QueueFamilyType queueFamilyType) const {
+  MI_VERIFY(isCreated());
+  MI_VERIFY(_queues[queueFamilyType]);
+  return _familyQueues.at(_queues[queueFamilyType]->queueFamilyIndex());
+}
+
+void Device::forEachQueue(const std::function<void(const Queue&)>& func) const {
+  for (const auto& [familyIndex, queues] : _familyQueues) {
+    for (const auto& queue : queues) {
+      func(*queue);
+    }
+  }
+}
+
+void Device::setSubmissionMode(SubmissionMode mode) {
+  MI_VERIFY(isCreated());
+  for (auto& [familyIndex, queues] : _familyQueues) {
+    for (auto& queue : queues) {
+      queue->setSubmissionMode(mode);
+    }
+  }
+}
+
+void Device::setQueueContentionTiming(bool enabled) {
+  MI_VERIFY(isCreated());
+  for (auto& [familyIndex, queues] : _familyQueues) {
+    for (auto& queue : queues) {
+      queue->setContentionTiming(enabled);
+    }
+  }
+}
+
 std::optional<uint32_t> Device::queueFamilyIndex(QueueFamilyType queueFamilyType) const {
   MI_VERIFY(isCreated());
   if (!_queues[queueFamilyType]) {
@@ -148,6 +218,12 @@ std::vector<uint32_t> Device::queueFamilyIndices() const {
   return {indices.begin(), indices.end()};
 }
 
+bool Device::isQueueFamilyDistinct(QueueFamilyType type, QueueFamilyType other) const {
+  const auto index      = queueFamilyIndex(type);
+  const auto otherIndex = queueFamilyIndex(other);
+  return index && otherIndex && *index != *otherIndex;
+}
+
 CommandPool& Device::commandPool(QueueFamilyType queueFamilyType) {
   MI_VERIFY(isCreated());
   MI_VERIFY(_commandPools[queueFamilyType]);
@@ -160,11 +236,38 @@ const CommandPool& Device::commandPool(QueueFamilyType queueFamilyType) const {
   return *_commandPools[queueFamilyType];
 }
 
+uint64_t Device::addHandleDestroyedCallback(HandleDestroyedCallback callback) const {
+  std::scoped_lock lock(_callbackMutex);
+  const auto id = _nextCallbackId++;
+  _handleDestroyedCallbacks.emplace(id, std::move(callback));
+  return id;
+}
+
+void Device::removeHandleDestroyedCallback(uint64_t id) const {
+  std::scoped_lock lock(_callbackMutex);
+  _handleDestroyedCallbacks.erase(id);
+}
+
+void Device::notifyHandleDestroyed(uint64_t handle) const {
+  std::scoped_lock lock(_callbackMutex);
+  for (const auto& [id, callback] : _handleDestroyedCallbacks) {
+    callback(handle);
+  }
+}
+
 void Device::destroy() {
   MI_VERIFY(isCreated());
 
+  // The cached framebuffers refer to the cached views.
+  _framebufferCache.reset();
+  _imageViewCache.reset();
+  _layoutCache.reset();
+  _pipelineCache.reset(); // Saved to its file
   _commandPools.clear();
+  _queuePool.reset();
   _queues.clear();
+  _familyQueues.clear();
+  _queueCounts.clear();
 
   vkDestroyDevice(_device, nullptr);
 
@@ -174,7 +277,9 @@ void Device::destroy() {
 
 void Device::waitIdle() const {
   MI_VERIFY(isCreated());
-  vkDeviceWaitIdle(_device);
+  // vkDeviceWaitIdle() needs all the queues to be externally synchronized and their submission
+  // threads to be flushed. Waiting for the queues one by one does both.
+  forEachQueue([](const Queue& queue) { queue.waitIdle(); });
 }
 
 const Instance& Device::instance() const {
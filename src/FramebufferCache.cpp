@@ -0,0 +1,61 @@
+#include <Vulk/FramebufferCache.h>
+
+#include <Vulk/internal/debug.h>
+
+#include <Vulk/Device.h>
+#include <Vulk/Image.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+FramebufferCache::FramebufferCache(const Device& device) : _device(device.get_weak()) {
+}
+
+FramebufferCache::~FramebufferCache() {
+  clear();
+}
+
+Framebuffer::shared_ptr FramebufferCache::framebuffer(
+    const RenderPass::shared_ptr& renderPass,
+    const ImageView::shared_ptr& colorAttachment,
+    const ImageView::shared_ptr& depthStencilAttachment) {
+  MI_VERIFY(renderPass && colorAttachment);
+
+  const VkImageView color = *colorAttachment;
+  const VkImageView depth =
+      depthStencilAttachment ? static_cast<VkImageView>(*depthStencilAttachment) : VK_NULL_HANDLE;
+  const auto extent = colorAttachment->image().extent();
+  const auto key    = Key{*renderPass, color, depth, extent.width, extent.height};
+
+  std::scoped_lock lock(_mutex);
+  auto& framebuffer = _framebuffers[key];
+  if (!framebuffer) {
+    framebuffer =
+        Framebuffer::make_shared(device(), renderPass, colorAttachment, depthStencilAttachment);
+  }
+  return framebuffer;
+}
+
+void FramebufferCache::invalidate(const ImageView& view) {
+  const VkImageView handle = view;
+
+  std::scoped_lock lock(_mutex);
+  for (auto it = _framebuffers.begin(); it != _framebuffers.end();) {
+    if (std::get<1>(it->first) == handle || std::get<2>(it->first) == handle) {
+      it = _framebuffers.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void FramebufferCache::clear() {
+  std::scoped_lock lock(_mutex);
+  _framebuffers.clear();
+}
+
+size_t FramebufferCache::size() const {
+  std::scoped_lock lock(_mutex);
+  return _framebuffers.size();
+}
+
+MI_NAMESPACE_END(Vulk)
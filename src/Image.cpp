@@ -6,6 +6,7 @@
 #include <Vulk/internal/helpers.h>
 
 #include <Vulk/Device.h>
+#include <Vulk/ImageViewCache.h>
 #include <Vulk/CommandBuffer.h>
 #include <Vulk/Queue.h>
 #include <Vulk/StagingBuffer.h>
@@ -119,6 +120,11 @@ void Image::create(const Device& device, const VkImageCreateInfo& imageInfo) {
 void Image::destroy() {
   MI_VERIFY(isCreated());
 
+  // The cached views of the image would be found for a new image reusing the handle.
+  if (device().hasCaches()) {
+    device().imageViewCache().invalidate(*this);
+  }
+
   if (isAllocated()) {
     free();
   }
@@ -285,27 +291,8 @@ void Image::transitToNewLayout(const CommandBuffer& commandBuffer,
 
   commandBuffer.beginRecording(CommandBuffer::Usage::OneTimeSubmit);
   {
-    auto oldLayout = _layout;
-
-    VkImageMemoryBarrier barrier{};
-    barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout                       = oldLayout;
-    barrier.newLayout                       = newLayout;
-    barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image                           = *this;
-    barrier.subresourceRange.baseMipLevel   = 0;
-    barrier.subresourceRange.levelCount     = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount     = 1;
-    barrier.subresourceRange.aspectMask     = selectAspectMask(newLayout);
-
-    auto [srcStage, srcAccess] = selectStageAccess(oldLayout);
-    barrier.srcAccessMask      = srcAccess;
-    auto [dstStage, dstAccess] = selectStageAccess(newLayout);
-    barrier.dstAccessMask      = dstAccess;
-
-    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    recordBarrier(
+        commandBuffer, _layout, newLayout, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
   }
   commandBuffer.endRecording();
   commandBuffer.submitCommands(waits, signals, fence);
@@ -315,6 +302,67 @@ void Image::transitToNewLayout(const CommandBuffer& commandBuffer,
   _layout = newLayout;
 }
 
+void Image::releaseOwnership(const CommandBuffer& commandBuffer,
+                             VkImageLayout newLayout,
+                             uint32_t dstQueueFamily) const {
+  const uint32_t queueFamily = commandBuffer.queue().queueFamilyIndex();
+  if (queueFamily == dstQueueFamily) {
+    transitToNewLayout(commandBuffer, newLayout);
+    return;
+  }
+  recordBarrier(commandBuffer, _layout, newLayout, queueFamily, dstQueueFamily);
+  _releasedLayout = _layout;
+  _released       = true;
+  _layout         = newLayout;
+}
+
+void Image::acquireOwnership(const CommandBuffer& commandBuffer, uint32_t srcQueueFamily) const {
+  const uint32_t queueFamily = commandBuffer.queue().queueFamilyIndex();
+  if (queueFamily == srcQueueFamily) {
+    return;
+  }
+  MI_VERIFY_MSG(_released, "Acquiring an image never released by queue family %u", srcQueueFamily);
+  recordBarrier(commandBuffer, _releasedLayout, _layout, srcQueueFamily, queueFamily);
+  _released = false;
+}
+
+void Image::recordBarrier(const CommandBuffer& commandBuffer,
+                          VkImageLayout oldLayout,
+                          VkImageLayout newLayout,
+                          uint32_t srcQueueFamily,
+                          uint32_t dstQueueFamily) const {
+  VkImageMemoryBarrier barrier{};
+  barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.oldLayout                       = oldLayout;
+  barrier.newLayout                       = newLayout;
+  barrier.srcQueueFamilyIndex             = srcQueueFamily;
+  barrier.dstQueueFamilyIndex             = dstQueueFamily;
+  barrier.image                           = *this;
+  barrier.subresourceRange.baseMipLevel   = 0;
+  barrier.subresourceRange.levelCount     = 1;
+  barrier.subresourceRange.baseArrayLayer = 0;
+  barrier.subresourceRange.layerCount     = 1;
+  barrier.subresourceRange.aspectMask     = selectAspectMask(newLayout);
+
+  auto [srcStage, srcAccess] = selectStageAccess(oldLayout);
+  auto [dstStage, dstAccess] = selectStageAccess(newLayout);
+  if (srcQueueFamily != dstQueueFamily) {
+    // A release ignores the destination scope and an acquire ignores the source scope; the
+    // semaphore between them provides it.
+    if (srcQueueFamily == commandBuffer.queue().queueFamilyIndex()) {
+      dstStage  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+      dstAccess = VK_ACCESS_NONE;
+    } else {
+      srcStage  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+      srcAccess = VK_ACCESS_NONE;
+    }
+  }
+  barrier.srcAccessMask = srcAccess;
+  barrier.dstAccessMask = dstAccess;
+
+  vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
 VkImageViewType Image::imageViewType() const {
   switch (_type) {
     case VK_IMAGE_TYPE_1D: return VK_IMAGE_VIEW_TYPE_1D;
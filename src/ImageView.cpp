@@ -1,6 +1,7 @@
 #include <Vulk/ImageView.h>
 
 #include <Vulk/internal/debug.h>
+#include <Vulk/internal/helpers.h>
 
 #include <Vulk/Device.h>
 #include <Vulk/Image.h>
@@ -29,13 +30,20 @@ ImageView::~ImageView() {
 void ImageView::create(const Device& device,
                        const Image2D& image,
                        ImageViewCreateInfoOverride createInfoOverride) {
-  auto aspect = VK_IMAGE_ASPECT_COLOR_BIT;
-  create(device, image, aspect, createInfoOverride);
+  create(device, image, aspectMask(image), createInfoOverride);
 }
 
 void ImageView::create(const Device& device,
                        const DepthImage& image,
                        ImageViewCreateInfoOverride createInfoOverride) {
+  create(device, image, aspectMask(image), createInfoOverride);
+}
+
+VkImageAspectFlags ImageView::aspectMask(const Image2D& /*image*/) {
+  return VK_IMAGE_ASPECT_COLOR_BIT;
+}
+
+VkImageAspectFlags ImageView::aspectMask(const DepthImage& image) {
   VkImageAspectFlags aspect = 0;
   if (image.hasDepthBits()) {
     aspect |= VK_IMAGE_ASPECT_DEPTH_BIT;
@@ -43,7 +51,7 @@ void ImageView::create(const Device& device,
   if (image.hasStencilBits()) {
     aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
   }
-  create(device, image, aspect, createInfoOverride);
+  return aspect;
 }
 
 void ImageView::create(const Device& device,
@@ -74,6 +82,7 @@ void ImageView::create(const Device& device,
 
 void ImageView::destroy() {
   MI_VERIFY(isCreated());
+  device().notifyHandleDestroyed(handleBits(_view));
   vkDestroyImageView(device(), _view, nullptr);
 
   _view = VK_NULL_HANDLE;
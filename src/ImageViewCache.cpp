@@ -0,0 +1,80 @@
+#include <Vulk/ImageViewCache.h>
+
+#include <utility>
+#include <vector>
+
+#include <Vulk/internal/debug.h>
+
+#include <Vulk/Device.h>
+#include <Vulk/Image.h>
+#include <Vulk/Image2D.h>
+#include <Vulk/DepthImage.h>
+#include <Vulk/FramebufferCache.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+ImageViewCache::ImageViewCache(const Device& device) : _device(device.get_weak()) {
+}
+
+ImageViewCache::~ImageViewCache() {
+  clear();
+}
+
+template <typename ImageType>
+ImageView::shared_ptr ImageViewCache::findOrCreate(const ImageType& image) {
+  MI_VERIFY(image.isCreated());
+  const auto key = keyOf(image, ImageView::aspectMask(image));
+
+  std::scoped_lock lock(_mutex);
+  auto& view = _views[key];
+  if (!view) {
+    view = ImageView::make_shared(device(), image);
+  }
+  return view;
+}
+
+ImageView::shared_ptr ImageViewCache::view(const Image2D& image) {
+  return findOrCreate(image);
+}
+
+ImageView::shared_ptr ImageViewCache::view(const DepthImage& image) {
+  return findOrCreate(image);
+}
+
+void ImageViewCache::invalidate(const Image& image) {
+  std::vector<ImageView::shared_ptr> views;
+  {
+    std::scoped_lock lock(_mutex);
+    const VkImage handle = image;
+    for (auto it = _views.begin(); it != _views.end();) {
+      if (std::get<0>(it->first) == handle) {
+        views.push_back(std::move(it->second));
+        it = _views.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  // The framebuffers are invalidated first since they refer to the views.
+  for (const auto& view : views) {
+    device().framebufferCache().invalidate(*view);
+  }
+}
+
+void ImageViewCache::clear() {
+  std::scoped_lock lock(_mutex);
+  _views.clear();
+}
+
+size_t ImageViewCache::size() const {
+  std::scoped_lock lock(_mutex);
+  return _views.size();
+}
+
+ImageViewCache::Key ImageViewCache::keyOf(const Image& image, VkImageAspectFlags aspectMask) {
+  // The subresource range of the views created by `ImageView`
+  return {image, image.format(), image.imageViewType(), aspectMask, 0, 1, 0, 1};
+}
+
+MI_NAMESPACE_END(Vulk)
@@ -1,11 +1,32 @@
 #include <Vulk/IndexBuffer.h>
 
+#include <Vulk/internal/debug.h>
+
 MI_NAMESPACE_BEGIN(Vulk)
 
 IndexBuffer::IndexBuffer(const Device& device, VkDeviceSize size, bool hostVisible) {
   create(device, size, hostVisible);
 }
 
+IndexBuffer::IndexBuffer(const Device& device,
+                         const void* indices,
+                         size_t numIndices,
+                         VkIndexType indexType,
+                         bool hostVisible) {
+  create(device, indices, numIndices, indexType, hostVisible);
+}
+
+void IndexBuffer::create(const Device& device,
+                         const void* indices,
+                         size_t numIndices,
+                         VkIndexType indexType,
+                         bool hostVisible) {
+  _indexType        = indexType;
+  VkDeviceSize size = IndexBuffer::indexSize(indexType) * numIndices;
+  create(device, size, hostVisible);
+  load(indices, size, 0, !hostVisible);
+}
+
 void IndexBuffer::create(const Device& device, VkDeviceSize size, bool hostVisible) {
   VkBufferUsageFlags usage         = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
   VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
@@ -20,4 +41,15 @@ void IndexBuffer::create(const Device& device, VkDeviceSize size, bool hostVisib
   Buffer::allocate(properties);
 }
 
+uint32_t IndexBuffer::indexSize(VkIndexType indexType) {
+  switch (indexType) {
+    case VK_INDEX_TYPE_UINT8_EXT: return 1;
+    case VK_INDEX_TYPE_UINT16: return 2;
+    case VK_INDEX_TYPE_UINT32: return 4;
+    default:
+      MI_VERIFY_MSG(false, "Unsupported index type %d", indexType);
+      return 0;
+  }
+}
+
 MI_NAMESPACE_END(Vulk)
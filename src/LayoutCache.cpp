@@ -0,0 +1,107 @@
+#include <Vulk/LayoutCache.h>
+
+#include <Vulk/internal/debug.h>
+#include <Vulk/internal/helpers.h>
+
+#include <Vulk/Device.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+LayoutCache::LayoutCache(const Device& device) : _device(device.get_weak()) {
+}
+
+LayoutCache::~LayoutCache() {
+  clear();
+}
+
+VkDescriptorSetLayout LayoutCache::descriptorSetLayout(
+    std::span<const VkDescriptorSetLayoutBinding> bindings) {
+  Key key;
+  key.contents.reserve(bindings.size() * 4);
+  for (const auto& binding : bindings) {
+    MI_VERIFY_MSG(binding.pImmutableSamplers == nullptr,
+                  "The layouts with immutable samplers can't be cached.");
+    key.contents.push_back(binding.binding);
+    key.contents.push_back(binding.descriptorType);
+    key.contents.push_back(binding.descriptorCount);
+    key.contents.push_back(binding.stageFlags);
+  }
+  hash(key);
+
+  std::scoped_lock lock(_mutex);
+  auto& layout = _descriptorSetLayouts[std::move(key)];
+  if (layout == VK_NULL_HANDLE) {
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings    = bindings.data();
+
+    MI_VERIFY_VK_RESULT(vkCreateDescriptorSetLayout(device(), &layoutInfo, nullptr, &layout));
+  }
+  return layout;
+}
+
+VkPipelineLayout LayoutCache::pipelineLayout(std::span<const VkDescriptorSetLayout> setLayouts,
+                                             const VkPushConstantRange& pushConstantRange) {
+  Key key;
+  key.contents.reserve(setLayouts.size() + 3);
+  for (const auto setLayout : setLayouts) {
+    key.contents.push_back(handleBits(setLayout));
+  }
+  key.contents.push_back(pushConstantRange.stageFlags);
+  key.contents.push_back(pushConstantRange.offset);
+  key.contents.push_back(pushConstantRange.size);
+  hash(key);
+
+  std::scoped_lock lock(_mutex);
+  auto& layout = _pipelineLayouts[std::move(key)];
+  if (layout == VK_NULL_HANDLE) {
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts    = setLayouts.data();
+    if (pushConstantRange.size > 0) {
+      pipelineLayoutInfo.pushConstantRangeCount = 1;
+      pipelineLayoutInfo.pPushConstantRanges    = &pushConstantRange;
+    }
+
+    MI_VERIFY_VK_RESULT(vkCreatePipelineLayout(device(), &pipelineLayoutInfo, nullptr, &layout));
+  }
+  return layout;
+}
+
+void LayoutCache::clear() {
+  std::scoped_lock lock(_mutex);
+  if (_descriptorSetLayouts.empty() && _pipelineLayouts.empty()) {
+    return;
+  }
+
+  // The pipeline layouts refer to the set layouts.
+  for (const auto& [key, layout] : _pipelineLayouts) {
+    vkDestroyPipelineLayout(device(), layout, nullptr);
+  }
+  for (const auto& [key, layout] : _descriptorSetLayouts) {
+    vkDestroyDescriptorSetLayout(device(), layout, nullptr);
+  }
+  _pipelineLayouts.clear();
+  _descriptorSetLayouts.clear();
+}
+
+size_t LayoutCache::numDescriptorSetLayouts() const {
+  std::scoped_lock lock(_mutex);
+  return _descriptorSetLayouts.size();
+}
+
+size_t LayoutCache::numPipelineLayouts() const {
+  std::scoped_lock lock(_mutex);
+  return _pipelineLayouts.size();
+}
+
+void LayoutCache::hash(Key& key) {
+  key.hash = 0;
+  for (const auto word : key.contents) {
+    hashCombine(key.hash, word);
+  }
+}
+
+MI_NAMESPACE_END(Vulk)
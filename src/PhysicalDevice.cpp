@@ -110,8 +110,16 @@ void PhysicalDevice::reset() {
 
 std::shared_ptr<Device> PhysicalDevice::createDevice(
     const QueueFamilies& requiredQueueFamilies,
-    const std::vector<const char*>& extensions) const {
-  return Device::make_shared(*this, requiredQueueFamilies, extensions);
+    const std::vector<const char*>& extensions,
+    const std::vector<float>& queuePriorities) const {
+  return Device::make_shared(*this, requiredQueueFamilies, extensions, queuePriorities);
+}
+
+VkPhysicalDeviceProperties PhysicalDevice::properties() const {
+  MI_VERIFY(isInstantiated());
+  VkPhysicalDeviceProperties properties{};
+  vkGetPhysicalDeviceProperties(_device, &properties);
+  return properties;
 }
 
 void PhysicalDevice::initQueueFamilies(const Surface& surface) {
@@ -141,6 +149,7 @@ PhysicalDevice::QueueFamilies PhysicalDevice::findQueueFamilies(VkPhysicalDevice
     std::vector<VkQueueFamilyProperties> props(count);
     vkGetPhysicalDeviceQueueFamilyProperties(device, &count, props.data());
 
+    std::optional<uint32_t> transferFallback;
     for (size_t i = 0; i < props.size(); ++i) {
       QueueFlags queueFlags{props[i].queueFlags};
       if (!queueFamilies.graphics &&
@@ -155,9 +164,15 @@ PhysicalDevice::QueueFamilies PhysicalDevice::findQueueFamilies(VkPhysicalDevice
           queueFlags.contain(VK_QUEUE_GRAPHICS_BIT) && queueFlags.contain(VK_QUEUE_COMPUTE_BIT)) {
         queueFamilies.graphicsAndCompute = i;
       }
-      if (!queueFamilies.transfer && queueFlags.contain(VK_QUEUE_TRANSFER_BIT)) {
+      if (!queueFamilies.transfer && queueFlags.contain(VK_QUEUE_TRANSFER_BIT) &&
+          !queueFlags.contain(VK_QUEUE_GRAPHICS_BIT) && !queueFlags.contain(VK_QUEUE_COMPUTE_BIT)) {
+        // Transfer-only families are usually backed by the DMA engines, which copy in parallel
+        // with the graphics and compute work.
         queueFamilies.transfer = i;
       }
+      if (!transferFallback && queueFlags.contain(VK_QUEUE_TRANSFER_BIT)) {
+        transferFallback = i;
+      }
 
       if (surface != VK_NULL_HANDLE && !queueFamilies.present) {
         VkBool32 presentSupport = 0U;
@@ -167,6 +182,10 @@ PhysicalDevice::QueueFamilies PhysicalDevice::findQueueFamilies(VkPhysicalDevice
         }
       }
     }
+
+    if (!queueFamilies.transfer) {
+      queueFamilies.transfer = transferFallback;
+    }
   }
 
   if (!queueFamilies.graphics) {
@@ -175,6 +194,10 @@ PhysicalDevice::QueueFamilies PhysicalDevice::findQueueFamilies(VkPhysicalDevice
   if (!queueFamilies.compute) {
     queueFamilies.compute = queueFamilies.graphicsAndCompute;
   }
+  if (!queueFamilies.transfer) {
+    // Graphics and compute queues support transfers even if they don't report the bit.
+    queueFamilies.transfer = queueFamilies.graphicsAndCompute;
+  }
 
   return queueFamilies;
 }
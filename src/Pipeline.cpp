@@ -1,16 +1,48 @@
 #include <Vulk/Pipeline.h>
 
+#include <algorithm>
+#include <chrono>
 #include <utility>
 
 #include <Vulk/internal/debug.h>
 
 #include <Vulk/Device.h>
+#include <Vulk/LayoutCache.h>
+#include <Vulk/PipelineCache.h>
 #include <Vulk/RenderPass.h>
 #include <Vulk/ShaderModule.h>
 #include <Vulk/VertexShader.h>
 #include <Vulk/FragmentShader.h>
 #include <Vulk/ComputeShader.h>
 
+namespace {
+
+// One range for all the stages, so the push constants of a block are at the same offset in all of
+// them
+VkPushConstantRange pushConstantRangeOf(const std::vector<const Vulk::ShaderModule*>& shaders) {
+  VkPushConstantRange range{};
+  for (const auto* shader : shaders) {
+    if (shader->pushConstantSize() > 0) {
+      range.stageFlags |= shader->stage();
+      range.size = std::max(range.size, shader->pushConstantSize());
+    }
+  }
+  return range;
+}
+
+VkPipelineCache pipelineCacheOf(const Vulk::Device& device) {
+  return device.hasPipelineCache() ? static_cast<VkPipelineCache>(device.pipelineCache())
+                                   : VK_NULL_HANDLE;
+}
+
+void addCreationTime(const Vulk::Device& device, std::chrono::steady_clock::time_point start) {
+  if (device.hasPipelineCache()) {
+    device.pipelineCache().addCreationTime(std::chrono::steady_clock::now() - start);
+  }
+}
+
+} // namespace
+
 MI_NAMESPACE_BEGIN(Vulk)
 
 Pipeline::Configuration::Configuration() {
@@ -24,6 +56,10 @@ Pipeline::Pipeline(const Device &device,
   create(device, renderPass, vertShader, fragShader, config);
 }
 
+Pipeline::Pipeline(const Device &device, const ComputeShader &compShader) {
+  create(device, compShader);
+}
+
 Pipeline::~Pipeline() {
   if (isCreated()) {
     destroy();
@@ -36,7 +72,8 @@ void Pipeline::create(const Device &device,
                       const FragmentShader &fragShader,
                       const Configuration &config) {
   MI_VERIFY(!isCreated());
-  _device = device.get_weak();
+  _device    = device.get_weak();
+  _bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 
   VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
   vertShaderStageInfo.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -141,15 +178,7 @@ void Pipeline::create(const Device &device,
   dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
   dynamicState.pDynamicStates    = dynamicStates.data();
 
-  MI_VERIFY(!_descriptorSetLayout || !_descriptorSetLayout->isCreated());
-  _descriptorSetLayout = DescriptorSetLayout::make_shared(device, vertShader, fragShader);
-
-  VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-  pipelineLayoutInfo.sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-  pipelineLayoutInfo.setLayoutCount = 1;
-  pipelineLayoutInfo.pSetLayouts    = *_descriptorSetLayout;
-
-  MI_VERIFY_VK_RESULT(vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &_layout));
+  createLayout(device, {&vertShader, &fragShader}, config.externalSetLayouts);
 
   VkGraphicsPipelineCreateInfo pipelineInfo{};
   pipelineInfo.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -170,13 +199,16 @@ void Pipeline::create(const Device &device,
   pipelineInfo.subpass            = 0;
   pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-  MI_VERIFY_VK_RESULT(
-      vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_pipeline));
+  const auto start = std::chrono::steady_clock::now();
+  MI_VERIFY_VK_RESULT(vkCreateGraphicsPipelines(
+      device, pipelineCacheOf(device), 1, &pipelineInfo, nullptr, &_pipeline));
+  addCreationTime(device, start);
 }
 
 void Pipeline::create(const Device &device, const ComputeShader &compShader) {
   MI_VERIFY(!isCreated());
-  _device = device.get_weak();
+  _device    = device.get_weak();
+  _bindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
 
   VkPipelineShaderStageCreateInfo compShaderStageInfo{};
   compShaderStageInfo.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -184,30 +216,82 @@ void Pipeline::create(const Device &device, const ComputeShader &compShader) {
   compShaderStageInfo.module = compShader;
   compShaderStageInfo.pName  = compShader.entry();
 
-  MI_VERIFY(!_descriptorSetLayout || !_descriptorSetLayout->isCreated());
-  _descriptorSetLayout = DescriptorSetLayout::make_shared(device, compShader);
-
-  VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-  pipelineLayoutInfo.sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-  pipelineLayoutInfo.setLayoutCount = 1;
-  pipelineLayoutInfo.pSetLayouts    = *_descriptorSetLayout;
-
-  MI_VERIFY_VK_RESULT(vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &_layout));
+  createLayout(device, {&compShader});
 
   VkComputePipelineCreateInfo pipelineInfo{};
   pipelineInfo.sType  = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
   pipelineInfo.stage  = compShaderStageInfo;
   pipelineInfo.layout = _layout;
 
-  MI_VERIFY_VK_RESULT(
-      vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_pipeline));
+  const auto start = std::chrono::steady_clock::now();
+  MI_VERIFY_VK_RESULT(vkCreateComputePipelines(
+      device, pipelineCacheOf(device), 1, &pipelineInfo, nullptr, &_pipeline));
+  addCreationTime(device, start);
+}
+
+void Pipeline::createLayout(const Device &device,
+                            const std::vector<const ShaderModule *> &shaders,
+                            const std::map<uint32_t, VkDescriptorSetLayout> &externalSetLayouts) {
+  MI_VERIFY(_descriptorSetLayouts.empty());
+
+  // There is always set 0, even without bindings, as the tasks return its layout (see
+  // `RenderTask::descriptorSetLayout()`).
+  uint32_t numSets = 1;
+  for (const auto* shader : shaders) {
+    numSets = std::max(numSets, shader->numDescriptorSets());
+  }
+  if (!externalSetLayouts.empty()) {
+    numSets = std::max(numSets, externalSetLayouts.rbegin()->first + 1);
+  }
+
+  std::vector<VkDescriptorSetLayout> setLayouts(numSets);
+  _descriptorSetLayouts.resize(numSets);
+  _descriptorUpdateTemplates.resize(numSets);
+  for (uint32_t set = 0; set < numSets; ++set) {
+    if (auto external = externalSetLayouts.find(set); external != externalSetLayouts.end()) {
+      setLayouts[set] = external->second;
+      continue;
+    }
+    auto layout = DescriptorSetLayout::make_shared(device, shaders, set);
+    if (!layout->bindings().empty()) {
+      _descriptorUpdateTemplates[set] = DescriptorUpdateTemplate::make_shared(*layout);
+    }
+    setLayouts[set]            = *layout;
+    _descriptorSetLayouts[set] = std::move(layout);
+  }
+  _pushConstantRange = pushConstantRangeOf(shaders);
+
+  // The cache keys on the handles of the set layouts, which must live as long as it does. The
+  // external ones may be destroyed and their handles reused, so those pipelines own their layout.
+  if (device.hasCaches() && externalSetLayouts.empty()) {
+    _layout       = device.layoutCache().pipelineLayout(setLayouts, _pushConstantRange);
+    _sharedLayout = true;
+    return;
+  }
+
+  VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+  pipelineLayoutInfo.sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  pipelineLayoutInfo.setLayoutCount = numSets;
+  pipelineLayoutInfo.pSetLayouts    = setLayouts.data();
+  if (_pushConstantRange.size > 0) {
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges    = &_pushConstantRange;
+  }
+
+  MI_VERIFY_VK_RESULT(vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &_layout));
 }
 
 void Pipeline::destroy() {
   MI_VERIFY(isCreated());
   vkDestroyPipeline(device(), _pipeline, nullptr);
-  vkDestroyPipelineLayout(device(), _layout, nullptr);
-  _descriptorSetLayout.reset();
+  if (!_sharedLayout) {
+    vkDestroyPipelineLayout(device(), _layout, nullptr);
+  }
+  _layout       = VK_NULL_HANDLE;
+  _sharedLayout = false;
+  _descriptorUpdateTemplates.clear();
+  _descriptorSetLayouts.clear();
+  _pushConstantRange = {};
 
   _pipeline = VK_NULL_HANDLE;
   _device.reset();
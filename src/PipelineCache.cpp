@@ -0,0 +1,131 @@
+#include <Vulk/PipelineCache.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <Vulk/internal/debug.h>
+
+#include <Vulk/Device.h>
+#include <Vulk/PhysicalDevice.h>
+
+#include <Vulk/engine/MappedFile.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+PipelineCache::PipelineCache(const Device& device, const std::string& filename) {
+  create(device, filename);
+}
+
+PipelineCache::~PipelineCache() {
+  if (isCreated()) {
+    destroy();
+  }
+}
+
+void PipelineCache::create(const Device& device, const std::string& filename) {
+  MI_VERIFY(!isCreated());
+  _device   = device.get_weak();
+  _filename = filename;
+
+  MappedFile file;
+  if (!_filename.empty() && std::filesystem::exists(_filename)) {
+    file.open(_filename, MappedFile::Access::Sequential);
+    if (file.isOpen() && !isCompatible(file.data(), file.size())) {
+      MI_LOG_WARNING("Ignored the pipeline cache '%s' of another device or driver",
+                     _filename.c_str());
+      file.close();
+    }
+  }
+
+  VkPipelineCacheCreateInfo cacheInfo{};
+  cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  if (file.isOpen()) {
+    cacheInfo.initialDataSize = file.size();
+    cacheInfo.pInitialData    = file.data();
+    _loadedSize               = file.size();
+  }
+
+  MI_VERIFY_VK_RESULT(vkCreatePipelineCache(device, &cacheInfo, nullptr, &_cache));
+}
+
+void PipelineCache::destroy() {
+  MI_VERIFY(isCreated());
+
+  if (!_filename.empty() && !save()) {
+    MI_LOG_WARNING("Failed to save the pipeline cache '%s'", _filename.c_str());
+  }
+  vkDestroyPipelineCache(device(), _cache, nullptr);
+
+  _cache = VK_NULL_HANDLE;
+  _filename.clear();
+  _loadedSize = 0;
+  _numPipelines.store(0);
+  _creationTime.store(0);
+  _device.reset();
+}
+
+bool PipelineCache::save() const {
+  MI_VERIFY(isCreated());
+  MI_VERIFY(!_filename.empty());
+
+  size_t size = 0;
+  if (vkGetPipelineCacheData(device(), _cache, &size, nullptr) != VK_SUCCESS) {
+    return false;
+  }
+  std::vector<char> data(size);
+  if (vkGetPipelineCacheData(device(), _cache, &size, data.data()) != VK_SUCCESS) {
+    return false;
+  }
+
+  // Written aside and renamed over the file, which is atomic, so the file is never half-written.
+  const auto tmpFilename = _filename + ".tmp";
+  std::error_code error;
+  {
+    std::ofstream out{tmpFilename, std::ios::binary | std::ios::trunc};
+    out.write(data.data(), static_cast<std::streamsize>(size));
+    // Closed before the check, so that the errors of the final flush are caught too.
+    out.close();
+    if (out.fail()) {
+      std::filesystem::remove(tmpFilename, error);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tmpFilename, _filename, error);
+  if (error) {
+    std::filesystem::remove(tmpFilename, error);
+    return false;
+  }
+  return true;
+}
+
+void PipelineCache::addCreationTime(std::chrono::nanoseconds time) {
+  _numPipelines.fetch_add(1);
+  _creationTime.fetch_add(time.count());
+}
+
+PipelineCache::Statistics PipelineCache::statistics() const {
+  Statistics statistics;
+  statistics.loadedSize   = _loadedSize;
+  statistics.numPipelines = _numPipelines.load();
+  statistics.creationTime = std::chrono::nanoseconds{_creationTime.load()};
+  return statistics;
+}
+
+bool PipelineCache::isCompatible(const void* data, size_t size) const {
+  VkPipelineCacheHeaderVersionOne header{};
+  if (size < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, data, sizeof(header));
+
+  const auto properties = device().physicalDevice().properties();
+  return header.headerSize >= sizeof(header) && header.headerSize <= size &&
+         header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+         std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+MI_NAMESPACE_END(Vulk)
@@ -0,0 +1,83 @@
+#include <Vulk/QueryPool.h>
+
+#include <algorithm>
+
+#include <Vulk/internal/debug.h>
+
+#include <Vulk/Device.h>
+#include <Vulk/CommandBuffer.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+QueryPool::QueryPool(const Device& device, VkQueryType type, uint32_t count) {
+  create(device, type, count);
+}
+
+QueryPool::~QueryPool() {
+  if (isCreated()) {
+    destroy();
+  }
+}
+
+void QueryPool::create(const Device& device, VkQueryType type, uint32_t count) {
+  MI_VERIFY(!isCreated());
+  _device = device.get_weak();
+  _type   = type;
+  _count  = count;
+
+  VkQueryPoolCreateInfo poolInfo{};
+  poolInfo.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  poolInfo.queryType  = type;
+  poolInfo.queryCount = count;
+
+  MI_VERIFY_VK_RESULT(vkCreateQueryPool(device, &poolInfo, nullptr, &_pool));
+}
+
+void QueryPool::destroy() {
+  MI_VERIFY(isCreated());
+  vkDestroyQueryPool(device(), _pool, nullptr);
+
+  _pool  = VK_NULL_HANDLE;
+  _count = 0;
+  _device.reset();
+}
+
+void QueryPool::reset(const CommandBuffer& commandBuffer, uint32_t first, uint32_t count) const {
+  MI_VERIFY(isCreated() && first < _count);
+  vkCmdResetQueryPool(commandBuffer, _pool, first, std::min(count, _count - first));
+}
+
+void QueryPool::writeTimestamp(const CommandBuffer& commandBuffer,
+                               VkPipelineStageFlagBits stage,
+                               uint32_t query) const {
+  MI_VERIFY(isCreated() && _type == VK_QUERY_TYPE_TIMESTAMP && query < _count);
+  vkCmdWriteTimestamp(commandBuffer, stage, _pool, query);
+}
+
+bool QueryPool::results(uint32_t first,
+                        uint32_t count,
+                        std::vector<uint64_t>& values,
+                        bool wait) const {
+  MI_VERIFY(isCreated() && first + count <= _count);
+
+  values.resize(count);
+  VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT;
+  if (wait) {
+    flags |= VK_QUERY_RESULT_WAIT_BIT;
+  }
+  const VkResult status = vkGetQueryPoolResults(device(),
+                                                _pool,
+                                                first,
+                                                count,
+                                                values.size() * sizeof(uint64_t),
+                                                values.data(),
+                                                sizeof(uint64_t),
+                                                flags);
+  if (status == VK_NOT_READY) {
+    return false;
+  }
+  MI_VERIFY_VK_RESULT(status);
+  return true;
+}
+
+MI_NAMESPACE_END(Vulk)
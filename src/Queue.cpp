@@ -6,10 +6,13 @@
 #include <Vulk/Fence.h>
 #include <Vulk/internal/debug.h>
 
+#include <future>
+#include <string>
+
 MI_NAMESPACE_BEGIN(Vulk)
 
-Queue::Queue(const Device& device, Device::QueueFamilyType queueFamily, uint32_t queueFamilyIndex)
-    : _queueFamily(queueFamily), _queueFamilyIndex(queueFamilyIndex) {
+Queue::Queue(const Device& device, uint32_t queueFamilyIndex, uint32_t queueIndex, float priority)
+    : _queueFamilyIndex(queueFamilyIndex), _queueIndex(queueIndex), _priority(priority) {
   // According to doc: vkGetDeviceQueue must only be used to get queues that
   // were created with the flags parameter of VkDeviceQueueCreateInfo set to
   // zero. To get queues that were created with a non-zero flags parameter use
@@ -19,55 +22,227 @@ Queue::Queue(const Device& device, Device::QueueFamilyType queueFamily, uint32_t
 
   // `queueIndex` must be less than the value of `VkDeviceQueueCreateInfo::queueCount`
   // for the queue family indicated by queueFamilyIndex when device was created.
-  // It was `1` hence we have to use `0` as queueIndex.
-  _queueIndex = 0;
   vkGetDeviceQueue(device, queueFamilyIndex, _queueIndex, &_queue);
 }
 
 Queue::~Queue() {
+  if (_submissionThread.joinable()) {
+    stopSubmissionThread();
+  }
 }
 
 void Queue::submitCommands(const CommandBuffer& commandBuffer,
                            const std::vector<Semaphore*>& waits,
                            const std::vector<Semaphore*>& signals,
                            const Fence& fence) const {
+  submitCommands(std::vector<const CommandBuffer*>{&commandBuffer}, waits, signals, fence);
+}
+
+void Queue::submitCommands(const std::vector<const CommandBuffer*>& commandBuffers,
+                           const std::vector<Semaphore*>& waits,
+                           const std::vector<Semaphore*>& signals,
+                           const Fence& fence) const {
+  flushSignals(waits);
+
+  // The handles are copied since the submission may run after the caller returns.
+  SubmitBatch batch;
+  batch.fence = fence;
+
+  batch.commandBuffers.reserve(commandBuffers.size());
+  for (const auto* commandBuffer : commandBuffers) {
+    batch.commandBuffers.push_back(*commandBuffer);
+  }
+
+  batch.waitSemaphores.reserve(waits.size());
+  batch.waitStages.reserve(waits.size());
+  for (const auto& wait : waits) {
+    batch.waitSemaphores.push_back(*wait);
+    batch.waitStages.push_back(
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT); // TODO: how about other stages such as
+                                             // VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+  }
+  batch.signalSemaphores.reserve(signals.size());
+  for (const auto& signal : signals) {
+    batch.signalSemaphores.push_back(*signal);
+    signal->setSignalingQueue(this);
+  }
+
+  execute([this, batch = std::move(batch)]() { submit(batch); }, true);
+}
+
+void Queue::submit(const SubmitBatch& batch) const {
   VkSubmitInfo submitInfo{};
   submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers    = commandBuffer;
-
-  std::vector<VkSemaphore> waitSemaphores;
-  std::vector<VkPipelineStageFlags> waitStages;
-  if (!waits.empty()) {
-    waitSemaphores.reserve(waits.size());
-    for (const auto& wait : waits) {
-      waitSemaphores.push_back(*wait);
-      waitStages.push_back(
-          VK_PIPELINE_STAGE_ALL_COMMANDS_BIT); // TODO: how about other stages such as
-                                               // VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
-    }
+  submitInfo.commandBufferCount = static_cast<uint32_t>(batch.commandBuffers.size());
+  submitInfo.pCommandBuffers    = batch.commandBuffers.data();
 
-    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
-    submitInfo.pWaitSemaphores    = waitSemaphores.data();
-    submitInfo.pWaitDstStageMask  = waitStages.data();
+  if (!batch.waitSemaphores.empty()) {
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(batch.waitSemaphores.size());
+    submitInfo.pWaitSemaphores    = batch.waitSemaphores.data();
+    submitInfo.pWaitDstStageMask  = batch.waitStages.data();
   }
-  std::vector<VkSemaphore> signalSemaphores;
-  if (!signals.empty()) {
-    signalSemaphores.reserve(signals.size());
-    for (const auto& signal : signals) {
-      signalSemaphores.push_back(*signal);
-    }
+  if (!batch.signalSemaphores.empty()) {
+    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(batch.signalSemaphores.size());
+    submitInfo.pSignalSemaphores    = batch.signalSemaphores.data();
+  }
+
+  MI_VERIFY_VK_RESULT(vkQueueSubmit(_queue, 1, &submitInfo, batch.fence));
+}
 
-    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
-    submitInfo.pSignalSemaphores    = signalSemaphores.data();
+VkResult Queue::present(const VkPresentInfoKHR& presentInfo) const {
+  if (_submissionMode == SubmissionMode::Direct) {
+    std::scoped_lock lock(_mutex);
+    return vkQueuePresentKHR(_queue, &presentInfo);
   }
-  MI_VERIFY_VK_RESULT(vkQueueSubmit(_queue, 1, &submitInfo, fence));
+
+  // `presentInfo` outlives the present since we wait for its result.
+  std::promise<VkResult> result;
+  execute([&]() { result.set_value(vkQueuePresentKHR(_queue, &presentInfo)); });
+  return result.get_future().get();
 }
 
 void Queue::waitIdle() const {
+  flush();
+
+  std::scoped_lock lock(_mutex);
   vkQueueWaitIdle(_queue);
 }
 
+void Queue::execute(std::function<void()> work, bool isSubmission) const {
+  const bool timing = isSubmission && _contentionTiming;
+
+  if (_submissionMode == SubmissionMode::Direct) {
+    std::unique_lock lock(_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      const auto start = timing ? Clock::now() : Clock::time_point{};
+      lock.lock();
+      if (timing) {
+        addContention(Clock::now() - start, true);
+      }
+    } else if (timing) {
+      addContention(Clock::duration::zero(), false);
+    }
+    work();
+    return;
+  }
+
+  Work item;
+  if (timing) {
+    // Wrap the work to time it from now until the submission thread picks it up.
+    const bool contended = _enqueuedWork.load() > _completedWork.load();
+    item.run = [this, work = std::move(work), contended, queuedAt = Clock::now()]() {
+      addContention(Clock::now() - queuedAt, contended);
+      work();
+    };
+  } else {
+    item.run = std::move(work);
+  }
+  enqueue(std::move(item));
+}
+
+void Queue::enqueue(Work item) const {
+  {
+    // The submission thread is either before its check of `_work` or waiting for the notification.
+    std::scoped_lock lock(_workMutex);
+    _enqueuedWork.fetch_add(1);
+    _work.push(std::move(item));
+  }
+  _workAvailable.notify_one();
+}
+
+void Queue::flush() const {
+  if (_submissionMode == SubmissionMode::Direct) {
+    return;
+  }
+  MI_VERIFY(std::this_thread::get_id() != _submissionThread.get_id());
+
+  // The submission thread notifies after each work it has run.
+  const auto ticket = _enqueuedWork.load();
+  auto completed    = _completedWork.load();
+  while (completed < ticket) {
+    _completedWork.wait(completed);
+    completed = _completedWork.load();
+  }
+}
+
+void Queue::flushSignals(const std::vector<Semaphore*>& waits) const {
+  for (const auto* wait : waits) {
+    const auto* queue = wait->takeSignalingQueue();
+    if (queue != nullptr && queue != this) {
+      queue->flush();
+    }
+  }
+}
+
+void Queue::setSubmissionMode(SubmissionMode mode) {
+  if (mode == _submissionMode) {
+    return;
+  }
+
+  if (mode == SubmissionMode::Threaded) {
+    _submissionMode   = mode;
+    _submissionThread = std::thread([this]() { runSubmissionThread(); });
+  } else {
+    stopSubmissionThread();
+    _submissionMode = mode;
+  }
+}
+
+void Queue::runSubmissionThread() const {
+  while (true) {
+    {
+      std::unique_lock lock(_workMutex);
+      _workAvailable.wait(lock, [this]() { return !_work.empty(); });
+    }
+
+    Work item;
+    while (_work.try_pop(item)) {
+      if (!item.run) {
+        _completedWork.fetch_add(1);
+        _completedWork.notify_all();
+        return;
+      }
+      {
+        std::scoped_lock lock(_mutex);
+        item.run();
+      }
+      _completedWork.fetch_add(1);
+      _completedWork.notify_all();
+    }
+  }
+}
+
+void Queue::stopSubmissionThread() {
+  MI_VERIFY(_submissionThread.joinable());
+
+  // The stop request is queued after the pending work, so the work is run before the thread ends.
+  enqueue(Work{});
+  _submissionThread.join();
+}
+
+void Queue::addContention(Clock::duration waitTime, bool contended) const {
+  _numSubmissions.fetch_add(1, std::memory_order_relaxed);
+  if (contended) {
+    _numContended.fetch_add(1, std::memory_order_relaxed);
+  }
+  const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(waitTime);
+  _waitTime.fetch_add(nanoseconds.count(), std::memory_order_relaxed);
+}
+
+auto Queue::contention() const -> Contention {
+  Contention contention;
+  contention.numSubmissions = _numSubmissions.load(std::memory_order_relaxed);
+  contention.numContended   = _numContended.load(std::memory_order_relaxed);
+  contention.waitTime = std::chrono::nanoseconds(_waitTime.load(std::memory_order_relaxed));
+  return contention;
+}
+
+void Queue::resetContention() {
+  _numSubmissions = 0;
+  _numContended   = 0;
+  _waitTime       = 0;
+}
+
 void Queue::beginLabel(const char* label, const glm::vec4& color) const {
   if (vkQueueBeginDebugUtilsLabelEXT) {
     VkDebugUtilsLabelEXT labelInfo{};
@@ -77,7 +252,12 @@ void Queue::beginLabel(const char* label, const glm::vec4& color) const {
     labelInfo.color[1]   = color.g;
     labelInfo.color[2]   = color.b;
     labelInfo.color[3]   = color.a;
-    vkQueueBeginDebugUtilsLabelEXT(_queue, &labelInfo);
+
+    // The label string may be gone by the time the submission thread runs it.
+    execute([this, labelInfo, name = std::string(label)]() mutable {
+      labelInfo.pLabelName = name.c_str();
+      vkQueueBeginDebugUtilsLabelEXT(_queue, &labelInfo);
+    });
   }
 }
 void Queue::insertLabel(const char* label, const glm::vec4& color) const {
@@ -89,12 +269,16 @@ void Queue::insertLabel(const char* label, const glm::vec4& color) const {
     labelInfo.color[1]   = color.g;
     labelInfo.color[2]   = color.b;
     labelInfo.color[3]   = color.a;
-    vkQueueInsertDebugUtilsLabelEXT(_queue, &labelInfo);
+
+    execute([this, labelInfo, name = std::string(label)]() mutable {
+      labelInfo.pLabelName = name.c_str();
+      vkQueueInsertDebugUtilsLabelEXT(_queue, &labelInfo);
+    });
   }
 }
 void Queue::endLabel() const {
   if (vkQueueEndDebugUtilsLabelEXT) {
-    vkQueueEndDebugUtilsLabelEXT(_queue);
+    execute([this]() { vkQueueEndDebugUtilsLabelEXT(_queue); });
   }
 }
 auto Queue::scopedLabel(const char* label, const glm::vec4& color) const
@@ -0,0 +1,53 @@
+#include <Vulk/QueuePool.h>
+
+#include <Vulk/internal/debug.h>
+
+#include <Vulk/Queue.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+QueuePool::QueuePool(const Device& device) : _device(device.get_weak()) {
+}
+
+const Queue& QueuePool::queue(Workload workload) const {
+  switch (workload) {
+    case Workload::Streaming:
+      return sideQueue(Device::QueueFamilyType::Transfer, Device::QueueFamilyType::Graphics);
+    case Workload::AsyncCompute:
+      return sideQueue(Device::QueueFamilyType::Compute, Device::QueueFamilyType::Graphics);
+    case Workload::Background: {
+      // The lowest priority queue; the last one of equal priorities is the least used.
+      const auto& queues = device().queues(Device::QueueFamilyType::Graphics);
+      const Queue* background = queues.front().get();
+      for (const auto& queue : queues) {
+        if (queue->priority() <= background->priority()) {
+          background = queue.get();
+        }
+      }
+      return *background;
+    }
+  }
+  MI_ASSERT_MSG(false, "Unknown workload %d", static_cast<int>(workload));
+  return device().queue(Device::QueueFamilyType::Graphics);
+}
+
+const Queue& QueuePool::threadQueue(Device::QueueFamilyType queueFamilyType) const {
+  const auto& queues = device().queues(queueFamilyType);
+
+  std::scoped_lock lock(_mutex);
+  const auto slot = static_cast<uint32_t>(_threadSlots.size());
+  const auto [it, _] = _threadSlots.try_emplace(std::this_thread::get_id(), slot);
+  return *queues[it->second % queues.size()];
+}
+
+const Queue& QueuePool::sideQueue(Device::QueueFamilyType queueFamilyType,
+                                  Device::QueueFamilyType mainType) const {
+  const auto& device = this->device();
+  const auto& queues = device.queues(queueFamilyType);
+  if (queues.size() > 1 && !device.isQueueFamilyDistinct(queueFamilyType, mainType)) {
+    return *queues[1];
+  }
+  return *queues.front();
+}
+
+MI_NAMESPACE_END(Vulk)
@@ -1,6 +1,7 @@
 #include <Vulk/Sampler.h>
 
 #include <Vulk/internal/debug.h>
+#include <Vulk/internal/helpers.h>
 
 #include <Vulk/Device.h>
 #include <Vulk/PhysicalDevice.h>
@@ -54,6 +55,7 @@ void Sampler::create(const Device& device,
 
 void Sampler::destroy() {
   MI_VERIFY(isCreated());
+  device().notifyHandleDestroyed(handleBits(_sampler));
   vkDestroySampler(device(), _sampler, nullptr);
 
   _sampler = VK_NULL_HANDLE;
@@ -1,11 +1,12 @@
 #include <Vulk/ShaderModule.h>
 
-#include <fstream>
+#include <algorithm>
 #include <vector>
 #include <iostream>
 
 #include <Vulk/Device.h>
 #include <Vulk/engine/TypeTraits.h>
+#include <Vulk/engine/MappedFile.h>
 #include <Vulk/internal/debug.h>
 
 #include <spirv_reflect.h>
@@ -31,6 +32,17 @@ bool gEnablePrintReflection = false;
         default: return {};
       }
     }
+    if (binding.type_description->op == SpvOpTypeImage) {
+      switch (binding.image.dim) {
+        case SpvDim1D: return "image1D";
+        case SpvDim2D: return "image2D";
+        case SpvDim3D: return "image3D";
+        case SpvDimCube: return "imageCube";
+        case SpvDimRect: return "image2DRect";
+        case SpvDimBuffer: return "imageBuffer";
+        default: return {};
+      }
+    }
   }
   return {};
 }
@@ -174,32 +186,6 @@ std::string ToStringQualifier(SpvReflectDecorationFlags qualifier) {
   os << "    qualifier : " << ToStringQualifier(variable.decoration_flags) << "\n";
 }
 
-std::vector<char> readFile(const std::string& filename) {
-  std::ifstream inputFile(filename, std::ios::binary | std::ios::ate);
-
-  MI_VERIFY_MSG(inputFile, "Failed to open file '%s'", filename.c_str());
-
-  std::streamsize fileSize = inputFile.tellg();
-  std::streamsize padding4 = (4 - fileSize % 4);
-  if (padding4 > 0) {
-    fileSize += padding4;
-  }
-
-  inputFile.seekg(0, std::ios::beg);
-
-  std::vector<char> charVector;
-  charVector.reserve(fileSize);
-
-  // Make sure the codes data are aligned to 4 bytes. The padding should be filled with 0.
-  charVector.assign(std::istreambuf_iterator<char>(inputFile), {});
-  for (std::streamsize i = 0; i < padding4; ++i) {
-    charVector.push_back(0);
-  }
-  charVector.resize(fileSize - padding4);
-
-  inputFile.close();
-  return charVector;
-}
 } // namespace
 
 MI_NAMESPACE_BEGIN(Vulk)
@@ -219,24 +205,36 @@ ShaderModule::~ShaderModule() {
 }
 
 void ShaderModule::create(const Device& device, const std::vector<char>& codes, bool reflection) {
+  create(device, codes.data(), codes.size(), reflection);
+}
+
+void ShaderModule::create(const Device& device,
+                          const void* codes,
+                          size_t codeSize,
+                          bool reflection) {
   MI_VERIFY(!isCreated());
+  // SPIR-V words must be 4-byte aligned; file mappings are always page aligned.
+  MI_VERIFY(codeSize % 4 == 0 && reinterpret_cast<uintptr_t>(codes) % 4 == 0);
   _device = device.get_weak();
   _entry  = "main";
 
   if (reflection) {
-    reflectShader(codes);
+    reflectShader(codes, codeSize);
   }
 
   VkShaderModuleCreateInfo createInfo{};
   createInfo.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-  createInfo.codeSize = codes.size();
-  createInfo.pCode    = reinterpret_cast<const uint32_t*>(codes.data());
+  createInfo.codeSize = codeSize;
+  createInfo.pCode    = static_cast<const uint32_t*>(codes);
 
   MI_VERIFY_VK_RESULT(vkCreateShaderModule(device, &createInfo, nullptr, &_shader));
 }
 
 void ShaderModule::create(const Device& device, const char* shaderFile, bool reflection) {
-  create(device, readFile(shaderFile), reflection);
+  // The SPIR-V words are consumed straight from the file mapping without a heap copy.
+  MappedFile file{shaderFile, MappedFile::Access::Sequential};
+  MI_VERIFY_MSG(file.isOpen(), "Failed to open file '%s'", shaderFile);
+  create(device, file.data(), file.size(), reflection);
 }
 
 void ShaderModule::destroy() {
@@ -251,15 +249,17 @@ void ShaderModule::addDescriptorSetLayoutBinding(const std::string& name,
                                                  const std::string& type,
                                                  uint32_t binding,
                                                  VkDescriptorType descriptorType,
-                                                 VkShaderStageFlags stageFlags) {
+                                                 VkShaderStageFlags stageFlags,
+                                                 uint32_t set) {
   _descriptorSetLayoutBindings.push_back(
-      {name, type, {binding, descriptorType, 1, stageFlags, nullptr}});
+      {name, type, set, {binding, descriptorType, 1, stageFlags, nullptr}});
 }
 
-void ShaderModule::reflectShader(const std::vector<char>& codes) {
+void ShaderModule::reflectShader(const void* codes, size_t codeSize) {
   SpvReflectShaderModule module = {};
-  MI_VERIFY_SPVREFLECT_RESULT(spvReflectCreateShaderModule(codes.size(), codes.data(), &module));
+  MI_VERIFY_SPVREFLECT_RESULT(spvReflectCreateShaderModule(codeSize, codes, &module));
   _entry = module.entry_point_name;
+  _stage = static_cast<VkShaderStageFlags>(module.shader_stage);
 
   if (gEnablePrintReflection) {
     std::cout << "Module:\n";
@@ -268,6 +268,7 @@ void ShaderModule::reflectShader(const std::vector<char>& codes) {
 
   reflectDescriptorSets(module);
   reflectVertexInputs(module);
+  reflectPushConstants(module);
 
   if (gEnablePrintReflection) {
     // OutputVariables
@@ -307,6 +308,7 @@ void ShaderModule::reflectDescriptorSets(const SpvReflectShaderModule& module) {
 
   for (const auto* descriptorSet : descriptorSets) {
     DescriptorSetLayoutBinding layoutBinding;
+    layoutBinding.set = descriptorSet->set;
     for (uint32_t bindingIdx = 0; bindingIdx < descriptorSet->binding_count; ++bindingIdx) {
       const auto& descriptorBinding = *(descriptorSet->bindings[bindingIdx]);
       layoutBinding.name            = descriptorBinding.name;
@@ -326,6 +328,27 @@ void ShaderModule::reflectDescriptorSets(const SpvReflectShaderModule& module) {
   }
 }
 
+uint32_t ShaderModule::numDescriptorSets() const {
+  uint32_t numSets = 0;
+  for (const auto& binding : _descriptorSetLayoutBindings) {
+    numSets = std::max(numSets, binding.set + 1);
+  }
+  return numSets;
+}
+
+void ShaderModule::reflectPushConstants(const SpvReflectShaderModule& module) {
+  uint32_t count = 0;
+  MI_VERIFY_SPVREFLECT_RESULT(spvReflectEnumeratePushConstantBlocks(&module, &count, nullptr));
+  std::vector<SpvReflectBlockVariable*> blocks(count);
+  MI_VERIFY_SPVREFLECT_RESULT(
+      spvReflectEnumeratePushConstantBlocks(&module, &count, blocks.data()));
+
+  _pushConstantSize = 0;
+  for (const auto* block : blocks) {
+    _pushConstantSize = std::max(_pushConstantSize, block->offset + block->size);
+  }
+}
+
 void ShaderModule::reflectVertexInputs(const SpvReflectShaderModule& module) {
   uint32_t count = 0;
   MI_VERIFY_SPVREFLECT_RESULT(spvReflectEnumerateInputVariables(&module, &count, nullptr));
@@ -346,7 +369,8 @@ void ShaderModule::reflectVertexInputs(const SpvReflectShaderModule& module) {
     // - Each vertex's attribute are laid out in ascending order by location.
     // - The format of each attribute matches its usage in the shader;
     //   float4 -> VK_FORMAT_R32G32B32A32_FLOAT, etc. No attribute compression
-    //   is applied.
+    //   is applied. Use `VertexShader::overrideVertexInputLayout` for packed
+    //   attributes.
     // - All attributes are provided per-vertex, not per-instance.
     constexpr uint32_t bindingIdx = 0;
 
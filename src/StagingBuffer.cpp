@@ -21,13 +21,13 @@ StagingBuffer::StagingBuffer(const Device& device, VkDeviceSize size, const void
 void StagingBuffer::create(const Device& device, VkDeviceSize size) {
   Buffer::create(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
   Buffer::allocate(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  // Host coherent memory can stay mapped; it's implicitly unmapped when the memory is freed.
+  _mappedData = static_cast<uint8_t*>(map());
 }
 
 void StagingBuffer::copyFromHost(const void* src, VkDeviceSize offset, VkDeviceSize size) {
-  MI_VERIFY(size <= this->size());
-  void* data = map(offset, size);
-  std::memcpy(data, src, size);
-  unmap();
+  MI_VERIFY(offset + size <= this->size());
+  std::memcpy(_mappedData + offset, src, size);
 }
 
 void StagingBuffer::copyToBuffer(const CommandBuffer& commandBuffer,
@@ -53,6 +53,21 @@ void StagingBuffer::copyToBuffer(const CommandBuffer& commandBuffer,
   copyToBuffer(commandBuffer, dst, {0, 0, size}, waits, signals, fence);
 }
 
+void StagingBuffer::copyToBuffer(const CommandBuffer& commandBuffer,
+                                 Buffer& dst,
+                                 const std::vector<VkBufferCopy>& regions,
+                                 const std::vector<Semaphore*>& waits,
+                                 const std::vector<Semaphore*>& signals,
+                                 const Fence& fence) const {
+  commandBuffer.beginRecording(CommandBuffer::Usage::OneTimeSubmit);
+  {
+    vkCmdCopyBuffer(
+        commandBuffer, *this, dst, static_cast<uint32_t>(regions.size()), regions.data());
+  }
+  commandBuffer.endRecording();
+  commandBuffer.submitCommands(waits, signals, fence);
+}
+
 void StagingBuffer::copyToImage(const CommandBuffer& commandBuffer,
                                 Image& dst,
                                 const VkBufferImageCopy& roi,
@@ -14,12 +14,15 @@ void StorageBuffer::create(const Device& device, VkDeviceSize size, Property pro
     properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
   } else {
     properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-    usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
   }
 
   if (property & Property::AS_VERTEX_BUFFER) {
     usage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
   }
+  if (property & Property::AS_INDIRECT_BUFFER) {
+    usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+  }
 
   Buffer::create(device, size, usage);
   Buffer::allocate(properties);
@@ -13,6 +13,7 @@
 #include <Vulk/Fence.h>
 #include <Vulk/Queue.h>
 #include <Vulk/Exception.h>
+#include <Vulk/ImageViewCache.h>
 
 MI_NAMESPACE_BEGIN(Vulk)
 
@@ -59,16 +60,12 @@ void Swapchain::create(const Device& device,
   createInfo.imageArrayLayers = 1;
   createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
-  auto queueFamilyIndices = device.queueFamilyIndices();
-  if (queueFamilyIndices.size() == 1) {
-    createInfo.imageSharingMode      = VK_SHARING_MODE_EXCLUSIVE;
-    createInfo.queueFamilyIndexCount = 0;       // Optional
-    createInfo.pQueueFamilyIndices   = nullptr; // Optional
-  } else {
-    createInfo.imageSharingMode      = VK_SHARING_MODE_CONCURRENT;
-    createInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndices.size());
-    createInfo.pQueueFamilyIndices   = queueFamilyIndices.data();
-  }
+  // The images are exclusive even if rendering and presenting are on different queue families;
+  // the ownership is transferred to the present queue family by `Image::releaseOwnership()`.
+  // Concurrent sharing may disable the compression of the images on some hardware.
+  createInfo.imageSharingMode      = VK_SHARING_MODE_EXCLUSIVE;
+  createInfo.queueFamilyIndexCount = 0;       // Optional
+  createInfo.pQueueFamilyIndices   = nullptr; // Optional
 
   createInfo.preTransform   = capabilities.currentTransform;
   createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
@@ -120,6 +117,14 @@ void Swapchain::destroy() {
 
   deactivateActiveImage();
 
+  // The images are external and not destroyed by `Image::destroy()`, which drops the cached views.
+  // The next swapchain may reuse their handles.
+  if (device().hasCaches()) {
+    for (const auto& image : _images) {
+      device().imageViewCache().invalidate(*image);
+    }
+  }
+
   // Be careful about changing the destroying order.
   _imageViews.clear();
   _images.clear();
@@ -165,6 +170,10 @@ void Swapchain::acquireNextImage(const Semaphore& signal, const Fence& fence) co
   if (result != VK_SUCCESS) {
     throw Exception{result, "Failed to acquire swapchain image."};
   }
+
+  // The image was last owned by the present queue family. Its content isn't preserved, so it can be
+  // written by another queue family without acquiring the ownership back.
+  _images[_activeImageIndex]->discardContent();
 }
 
 void Swapchain::present(const std::vector<Semaphore*>& waits) const {
@@ -186,7 +195,9 @@ void Swapchain::present(const std::vector<Semaphore*>& waits) const {
 
   presentInfo.pImageIndices = &_activeImageIndex;
 
-  auto result = vkQueuePresentKHR(device().queue(Device::QueueFamilyType::Present), &presentInfo);
+  const auto& queue = device().queue(Device::QueueFamilyType::Present);
+  queue.flushSignals(waits);
+  auto result = queue.present(presentInfo);
 
   if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
     _requiredRecreate = true;
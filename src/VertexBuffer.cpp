@@ -1,12 +1,35 @@
 #include <Vulk/VertexBuffer.h>
 
+#include <algorithm>
+
 MI_NAMESPACE_BEGIN(Vulk)
 
 VertexBuffer::VertexBuffer(const Device& device, VkDeviceSize size, Property property) {
   create(device, size, property);
 }
 
+VertexBuffer::VertexBuffer(const Device& device,
+                           const void* vertices,
+                           size_t numVertices,
+                           size_t vertexSize,
+                           Property property) {
+  create(device, vertices, numVertices, vertexSize, property);
+}
+
+void VertexBuffer::create(const Device& device,
+                          const void* vertices,
+                          size_t numVertices,
+                          size_t vertexSize,
+                          Property property) {
+  _numVertices      = numVertices;
+  VkDeviceSize size = vertexSize * _numVertices;
+  create(device, size, property);
+  load(vertices, size, 0, !memory().isHostVisible());
+}
+
 void VertexBuffer::create(const Device& device, VkDeviceSize size, Property property) {
+  _property = property;
+
   VkBufferUsageFlags usage         = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
   VkMemoryPropertyFlags properties = 0;
 
@@ -25,4 +48,18 @@ void VertexBuffer::create(const Device& device, VkDeviceSize size, Property prop
   Buffer::allocate(properties);
 }
 
+void VertexBuffer::reserve(VkDeviceSize size) {
+  MI_VERIFY(isCreated());
+  if (size <= this->size()) {
+    return;
+  }
+
+  // Grow geometrically so a steadily growing buffer is reallocated O(log n) times.
+  const auto newSize = std::max(size, 2 * this->size());
+  const auto device  = _device.lock();
+
+  Buffer::destroy();
+  create(*device, newSize, _property);
+}
+
 MI_NAMESPACE_END(Vulk)
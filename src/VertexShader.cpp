@@ -1,6 +1,10 @@
 #include <Vulk/VertexShader.h>
 
 #include <Vulk/Device.h>
+#include <Vulk/engine/TypeTraits.h>
+#include <Vulk/internal/debug.h>
+
+#include <algorithm>
 
 MI_NAMESPACE_BEGIN(Vulk)
 
@@ -27,6 +31,35 @@ void VertexShader::addVertexInputAttributes(std::vector<VertexInputAttribute> at
   _vertexInputAttributes.insert(_vertexInputAttributes.end(), attributes.begin(), attributes.end());
 }
 
+void VertexShader::overrideVertexInputLayout(
+    const VkVertexInputBindingDescription& binding,
+    const std::vector<VkVertexInputAttributeDescription>& attributes) {
+  for (auto& attribute : _vertexInputAttributes) {
+    auto& vkAttr = attribute.vkDescription;
+
+    auto iter = std::find_if(attributes.begin(), attributes.end(), [&vkAttr](const auto& attr) {
+      return attr.location == vkAttr.location;
+    });
+    MI_VERIFY_MSG(iter != attributes.end(),
+                  "Vertex input '%s' (location %u) is missing in the vertex layout",
+                  attribute.name.c_str(),
+                  vkAttr.location);
+    if (iter == attributes.end()) {
+      continue;
+    }
+    MI_VERIFY_MSG(iter->offset + formatsizeof(iter->format) <= binding.stride,
+                  "Vertex input '%s' (location %u) overflows the vertex stride",
+                  attribute.name.c_str(),
+                  vkAttr.location);
+
+    vkAttr.binding = binding.binding;
+    vkAttr.format  = iter->format;
+    vkAttr.offset  = iter->offset;
+  }
+
+  _vertexInputBindings = {binding};
+}
+
 void VertexShader::addDescriptorSetLayoutBinding(const std::string& name,
                                                  const std::string& type,
                                                  uint32_t binding,
@@ -0,0 +1,243 @@
+#include <Vulk/engine/BindlessTextureTable.h>
+
+#include <array>
+#include <stdexcept>
+
+#include <Vulk/internal/debug.h>
+
+#include <Vulk/CommandBuffer.h>
+#include <Vulk/Device.h>
+#include <Vulk/Pipeline.h>
+
+#include <Vulk/engine/Texture2D.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+BindlessTextureTable::BindlessTextureTable(const DeviceContext& deviceContext,
+                                           uint32_t maxImages,
+                                           uint32_t maxSamplers,
+                                           uint32_t numFramesInFlight) {
+  create(deviceContext, maxImages, maxSamplers, numFramesInFlight);
+}
+
+BindlessTextureTable::~BindlessTextureTable() {
+  if (isCreated()) {
+    destroy();
+  }
+}
+
+void BindlessTextureTable::create(const DeviceContext& deviceContext,
+                                  uint32_t maxImages,
+                                  uint32_t maxSamplers,
+                                  uint32_t numFramesInFlight) {
+  MI_VERIFY(!isCreated());
+  MI_VERIFY_MSG(deviceContext.isDescriptorIndexingEnabled(),
+                "A bindless texture table requires the descriptor indexing of the device context.");
+
+  const auto& device = deviceContext.device();
+  _device            = device.get_weak();
+  _maxImages         = maxImages;
+  _maxSamplers       = maxSamplers;
+  _numFramesInFlight = numFramesInFlight;
+
+  const std::array<VkDescriptorSetLayoutBinding, 2> bindings = {{
+      {kImageBinding, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxImages, VK_SHADER_STAGE_ALL, nullptr},
+      {kSamplerBinding, VK_DESCRIPTOR_TYPE_SAMPLER, maxSamplers, VK_SHADER_STAGE_ALL, nullptr},
+  }};
+  // The slots not added yet are never accessed, and the ones added while the table is bound by
+  // pending command buffers are not used by them.
+  const VkDescriptorBindingFlagsEXT bindingFlags =
+      VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+      VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT |
+      VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+  const std::array<VkDescriptorBindingFlagsEXT, 2> flags = {bindingFlags, bindingFlags};
+
+  VkDescriptorSetLayoutBindingFlagsCreateInfoEXT flagsInfo{};
+  flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+  flagsInfo.bindingCount  = static_cast<uint32_t>(flags.size());
+  flagsInfo.pBindingFlags = flags.data();
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo{};
+  layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  layoutInfo.pNext        = &flagsInfo;
+  layoutInfo.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings    = bindings.data();
+
+  MI_VERIFY_VK_RESULT(vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &_layout));
+
+  const std::array<VkDescriptorPoolSize, 2> poolSizes = {{
+      {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxImages},
+      {VK_DESCRIPTOR_TYPE_SAMPLER, maxSamplers},
+  }};
+
+  VkDescriptorPoolCreateInfo poolInfo{};
+  poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  poolInfo.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+  poolInfo.maxSets       = 1;
+  poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+  poolInfo.pPoolSizes    = poolSizes.data();
+
+  MI_VERIFY_VK_RESULT(vkCreateDescriptorPool(device, &poolInfo, nullptr, &_pool));
+
+  VkDescriptorSetAllocateInfo allocInfo{};
+  allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  allocInfo.descriptorPool     = _pool;
+  allocInfo.descriptorSetCount = 1;
+  allocInfo.pSetLayouts        = &_layout;
+
+  MI_VERIFY_VK_RESULT(vkAllocateDescriptorSets(device, &allocInfo, &_set));
+}
+
+void BindlessTextureTable::destroy() {
+  MI_VERIFY(isCreated());
+
+  // The set is freed with the pool.
+  vkDestroyDescriptorPool(device(), _pool, nullptr);
+  vkDestroyDescriptorSetLayout(device(), _layout, nullptr);
+
+  _set    = VK_NULL_HANDLE;
+  _pool   = VK_NULL_HANDLE;
+  _layout = VK_NULL_HANDLE;
+
+  _textures.clear();
+  _samplers.clear();
+  _freeImages.clear();
+  _freeSamplers.clear();
+  _numImages   = 0;
+  _numSamplers = 0;
+  _retired.clear();
+  _frame = 0;
+
+  _device.reset();
+}
+
+BindlessTextureTable::Slot BindlessTextureTable::add(const Texture2D& texture) {
+  MI_VERIFY(isCreated());
+
+  const VkImageView view  = texture.view();
+  const VkSampler sampler = texture.sampler();
+
+  std::scoped_lock lock(_mutex);
+
+  if (auto found = _textures.find(view); found != _textures.end()) {
+    return found->second.slot;
+  }
+
+  Entry entry;
+  entry.sampler    = sampler;
+  entry.slot.image = allocateIndex(_freeImages, _numImages, _maxImages);
+
+  auto& samplerEntry = _samplers[sampler];
+  if (samplerEntry.numUsers == 0) {
+    try {
+      samplerEntry.index = allocateIndex(_freeSamplers, _numSamplers, _maxSamplers);
+    } catch (...) {
+      _samplers.erase(sampler);
+      _freeImages.push_back(entry.slot.image);
+      throw;
+    }
+  }
+  ++samplerEntry.numUsers;
+  entry.slot.sampler = samplerEntry.index;
+
+  VkDescriptorImageInfo imageInfo{};
+  imageInfo.imageView   = view;
+  imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  VkDescriptorImageInfo samplerInfo{};
+  samplerInfo.sampler = sampler;
+
+  std::array<VkWriteDescriptorSet, 2> writes{};
+  writes[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  writes[0].dstSet          = _set;
+  writes[0].dstBinding      = kImageBinding;
+  writes[0].dstArrayElement = entry.slot.image;
+  writes[0].descriptorCount = 1;
+  writes[0].descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  writes[0].pImageInfo      = &imageInfo;
+
+  writes[1].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  writes[1].dstSet          = _set;
+  writes[1].dstBinding      = kSamplerBinding;
+  writes[1].dstArrayElement = entry.slot.sampler;
+  writes[1].descriptorCount = 1;
+  writes[1].descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLER;
+  writes[1].pImageInfo      = &samplerInfo;
+
+  // The sampler is already written if it's shared with another texture.
+  const auto numWrites = samplerEntry.numUsers == 1 ? 2U : 1U;
+  vkUpdateDescriptorSets(device(), numWrites, writes.data(), 0, nullptr);
+
+  _textures.emplace(view, entry);
+  return entry.slot;
+}
+
+void BindlessTextureTable::remove(const Texture2D& texture) {
+  MI_VERIFY(isCreated());
+
+  std::scoped_lock lock(_mutex);
+
+  auto found = _textures.find(texture.view());
+  if (found == _textures.end()) {
+    return;
+  }
+  const auto entry = found->second;
+  _textures.erase(found);
+
+  // The descriptors are left as they are; the frames recorded from now on don't index them, and
+  // they're not rewritten before the ones in flight are done.
+  Retired retired;
+  retired.frame = _frame + _numFramesInFlight;
+  retired.image = entry.slot.image;
+
+  auto& samplerEntry = _samplers[entry.sampler];
+  if (--samplerEntry.numUsers == 0) {
+    retired.sampler = samplerEntry.index;
+    _samplers.erase(entry.sampler);
+  }
+  _retired.push_back(retired);
+}
+
+void BindlessTextureTable::nextFrame() {
+  std::scoped_lock lock(_mutex);
+
+  ++_frame;
+  while (!_retired.empty() && _retired.front().frame <= _frame) {
+    const auto& retired = _retired.front();
+    _freeImages.push_back(retired.image);
+    if (retired.sampler) {
+      _freeSamplers.push_back(*retired.sampler);
+    }
+    _retired.pop_front();
+  }
+}
+
+void BindlessTextureTable::bind(const CommandBuffer& commandBuffer,
+                                const Pipeline& pipeline) const {
+  MI_VERIFY(isCreated());
+  vkCmdBindDescriptorSets(
+      commandBuffer, pipeline.bindPoint(), pipeline.layout(), kSet, 1, &_set, 0, nullptr);
+}
+
+uint32_t BindlessTextureTable::numTextures() const {
+  std::scoped_lock lock(_mutex);
+  return static_cast<uint32_t>(_textures.size());
+}
+
+uint32_t BindlessTextureTable::allocateIndex(std::vector<uint32_t>& freeIndices,
+                                             uint32_t& numIndices,
+                                             uint32_t maxIndices) {
+  if (!freeIndices.empty()) {
+    const auto index = freeIndices.back();
+    freeIndices.pop_back();
+    return index;
+  }
+  // Past `maxIndices`, the descriptors would be written out of the arrays.
+  if (numIndices >= maxIndices) {
+    throw std::length_error("The bindless texture table is full.");
+  }
+  return numIndices++;
+}
+
+MI_NAMESPACE_END(Vulk)
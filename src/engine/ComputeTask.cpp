@@ -0,0 +1,90 @@
+#include <Vulk/engine/ComputeTask.h>
+
+#include <Vulk/internal/debug.h>
+
+#include <Vulk/QueuePool.h>
+
+namespace {
+
+Vulk::RenderTask::Type queueTypeOf(const Vulk::DeviceContext& deviceContext,
+                                   Vulk::RenderTask::Type type) {
+  if (type == Vulk::RenderTask::Type::Compute &&
+      !deviceContext.isQueueFamilySupported(Vulk::Device::QueueFamilyType::Compute)) {
+    return Vulk::RenderTask::Type::Graphics;
+  }
+  return type;
+}
+
+} // namespace
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+ComputeTask::ComputeTask(const DeviceContext& deviceContext,
+                         const ComputeShader& compShader,
+                         Type type)
+    : RenderTask(deviceContext, queueTypeOf(deviceContext, type)) {
+  MI_VERIFY(_type != Type::Transfer);
+  _pipeline = Pipeline::make_shared(device(), compShader);
+}
+
+ComputeTask::~ComputeTask() {
+}
+
+void ComputeTask::prepareSynchronization(const std::vector<Semaphore::shared_ptr>& waits) {
+  _waits = waits;
+}
+
+DescriptorSetLayout::shared_ptr ComputeTask::descriptorSetLayout() {
+  return _pipeline->descriptorSetLayout();
+}
+
+std::vector<DescriptorSetLayout::shared_ptr> ComputeTask::descriptorSetLayouts() {
+  return _pipeline->descriptorSetLayouts();
+}
+
+std::pair<Semaphore::shared_ptr, Fence::shared_ptr> ComputeTask::submit(
+    const char* label,
+    std::span<const DescriptorSet::Info> infos,
+    const Recorder& record) {
+  auto fence  = _frameContext->acquireFence();
+  auto signal = _frameContext->acquireSemaphore();
+
+  std::vector<Semaphore*> waits;
+  waits.reserve(_waits.size());
+  for (const auto& semaphore : _waits) {
+    waits.push_back(semaphore.get());
+  }
+
+  // No set for a shader without bindings
+  DescriptorSet::shared_ptr descriptorSet;
+  if (const auto& updateTemplate = _pipeline->descriptorUpdateTemplate()) {
+    descriptorSet = _frameContext->acquireDescriptorSet(*updateTemplate, infos);
+  }
+
+  _commandBuffer->beginRecording();
+  {
+    auto scopedLabel = _commandBuffer->scopedLabel(label);
+    writeBeginTimestamp();
+
+    _commandBuffer->bindPipeline(*_pipeline);
+    if (descriptorSet) {
+      _commandBuffer->bindDescriptorSet(*_pipeline, *descriptorSet);
+    }
+
+    record(*_commandBuffer);
+
+    writeEndTimestamp();
+  }
+  _commandBuffer->endRecording();
+  if (_type == Type::Compute) {
+    // Keep the async compute off the compute queue shared with other submissions, if there is one.
+    const auto& queue = device().queuePool().queue(QueuePool::Workload::AsyncCompute);
+    _commandBuffer->submitCommandsTo(queue, waits, {signal.get()}, *fence);
+  } else {
+    _commandBuffer->submitCommands(waits, {signal.get()}, *fence);
+  }
+
+  return {signal, fence};
+}
+
+MI_NAMESPACE_END(Vulk)
@@ -44,16 +44,29 @@ void DeviceContext::create(const CreateInfo& createInfo) {
                  createInfo.instanceExtensions,
                  createInfo.validationLevel);
   createSurface(createInfo.createWindowSurface);
+
+  auto deviceExtensions = createInfo.deviceExtensions;
+  _descriptorIndexing   = createInfo.descriptorIndexing;
+  if (_descriptorIndexing) {
+    deviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+  }
   pickPhysicalDevice(
-      createInfo.queueFamilies, createInfo.deviceExtensions, createInfo.hasPhysicalDeviceFeatures);
-  createDevice(createInfo.queueFamilies, createInfo.deviceExtensions);
+      createInfo.queueFamilies, deviceExtensions, createInfo.hasPhysicalDeviceFeatures);
+  createDevice(createInfo.queueFamilies, deviceExtensions, createInfo.queuePriorities);
+  _device->initPipelineCache(createInfo.pipelineCacheFile);
+  _device->setQueueContentionTiming(createInfo.queueContentionTiming);
+  _device->setSubmissionMode(createInfo.submissionMode);
   createSwapchain(
       createInfo.chooseSurfaceExtent, createInfo.chooseSurfaceFormat, createInfo.choosePresentMode);
+  if (createInfo.presentQueueDepth > 0) {
+    _presenter = Presenter::make_shared(createInfo.presentQueueDepth);
+  }
 
   _queueFamilies = createInfo.queueFamilies;
 }
 
 void DeviceContext::destroy() {
+  _presenter.reset();
   _swapchain->destroy();
   _device->destroy();
   _surface->destroy();
@@ -79,10 +92,57 @@ void DeviceContext::pickPhysicalDevice(
 }
 
 void DeviceContext::createDevice(const PhysicalDevice::QueueFamilies& requiredQueueFamilies,
-                                 const std::vector<const char*>& deviceExtensions) {
-  _device = _instance->physicalDevice().createDevice(requiredQueueFamilies, deviceExtensions);
+                                 const std::vector<const char*>& deviceExtensions,
+                                 const Device::QueuePriorities& queuePriorities) {
+  const auto& physicalDevice = _instance->physicalDevice();
+  if (_descriptorIndexing) {
+    // The features used by a `BindlessTextureTable`
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT supported{};
+    supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &supported;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+    MI_VERIFY_MSG(supported.shaderSampledImageArrayNonUniformIndexing &&
+                      supported.descriptorBindingSampledImageUpdateAfterBind &&
+                      supported.descriptorBindingUpdateUnusedWhilePending &&
+                      supported.descriptorBindingPartiallyBound && supported.runtimeDescriptorArray,
+                  "The physical device doesn't support the features of descriptor indexing.");
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    indexingFeatures.shaderSampledImageArrayNonUniformIndexing    = VK_TRUE;
+    indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    indexingFeatures.descriptorBindingUpdateUnusedWhilePending    = VK_TRUE;
+    indexingFeatures.descriptorBindingPartiallyBound              = VK_TRUE;
+    indexingFeatures.runtimeDescriptorArray                       = VK_TRUE;
+
+    auto enableFeatures = [&indexingFeatures](VkDeviceCreateInfo* createInfo,
+                                              VkPhysicalDeviceFeatures* /*features*/,
+                                              std::vector<VkDeviceQueueCreateInfo>* /*queues*/) {
+      indexingFeatures.pNext = const_cast<void*>(createInfo->pNext);
+      createInfo->pNext      = &indexingFeatures;
+    };
+    _device = Device::make_shared(
+        physicalDevice, requiredQueueFamilies, deviceExtensions, queuePriorities, enableFeatures);
+  } else {
+    _device = physicalDevice.createDevice(requiredQueueFamilies, deviceExtensions, queuePriorities);
+  }
   _device->initQueues();
   _device->initCommandPools();
+  _device->initCaches();
+
+  // -1 if the queue family is not enabled. Queues of the same index share the hardware queue. Only
+  // logged in debug builds.
+  [[maybe_unused]] const auto familyOf = [this](Device::QueueFamilyType type) {
+    const auto index = _device->queueFamilyIndex(type);
+    return index ? static_cast<int>(*index) : -1;
+  };
+  MI_LOG_INFO("Queue families: graphics %d, compute %d, transfer %d, present %d",
+              familyOf(Device::QueueFamilyType::Graphics),
+              familyOf(Device::QueueFamilyType::Compute),
+              familyOf(Device::QueueFamilyType::Transfer),
+              familyOf(Device::QueueFamilyType::Present));
 }
 
 void DeviceContext::createSwapchain(const Swapchain::ChooseSurfaceExtentFunc& chooseSurfaceExtent,
@@ -105,6 +165,10 @@ void DeviceContext::createSwapchain(const Swapchain::ChooseSurfaceExtentFunc& ch
 }
 
 void DeviceContext::waitIdle() const {
+  // The frames queued to the present thread are not submitted yet.
+  if (_presenter) {
+    _presenter->flush();
+  }
   _device->waitIdle();
 }
 
@@ -136,6 +200,7 @@ bool DeviceContext::isQueueFamilySupported(Device::QueueFamilyType queueFamily)
     case Device::QueueFamilyType::Compute:
       return _queueFamilies.hasCompute() || _queueFamilies.hasGraphicsAndCompute();
     case Device::QueueFamilyType::Transfer: return _queueFamilies.hasTransfer();
+    case Device::QueueFamilyType::Present: return _queueFamilies.hasPresent();
     default: break;
   }
   return false;
@@ -0,0 +1,22 @@
+#include <Vulk/engine/DynamicVertexBuffer.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+DynamicVertexBuffer::~DynamicVertexBuffer() {
+  if (isCreated()) {
+    destroy();
+  }
+}
+
+void DynamicVertexBuffer::destroy() {
+  MI_VERIFY(isCreated());
+  _slots.clear();
+  _currentSlot = 0;
+}
+
+const VertexBuffer& DynamicVertexBuffer::slot(uint32_t frameIndex) const {
+  MI_VERIFY(isCreated());
+  return *_slots[frameIndex % numSlots()];
+}
+
+MI_NAMESPACE_END(Vulk)
@@ -4,6 +4,12 @@
 #include <Vulk/DescriptorSetLayout.h>
 
 #include <Vulk/internal/debug.h>
+#include <Vulk/internal/helpers.h>
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <unordered_set>
 
 MI_NAMESPACE_BEGIN(Vulk)
 
@@ -22,11 +28,10 @@ CommandBufferManager::~CommandBufferManager() {
 }
 
 CommandBuffer::shared_ptr CommandBufferManager::acquireBuffer() {
-  if (_availableCommandBuffers.empty()) {
-    _availableCommandBuffers.push(CommandBuffer::make_shared(*_commandPool));
-  }
   CommandBuffer::shared_ptr buffer;
-  _availableCommandBuffers.try_pop(buffer);
+  if (!_availableCommandBuffers.try_pop(buffer)) {
+    buffer = CommandBuffer::make_shared(*_commandPool);
+  }
   _acquiredCommandBuffers.push(buffer);
   return buffer;
 }
@@ -45,51 +50,224 @@ void CommandBufferManager::reset() {
 // DescriptorSetManager
 //
 DescriptorSetManager::DescriptorSetManager(const Device& device,
-                                           std::vector<DescriptorSetLayout::shared_ptr> layouts) {
-  std::vector<VkDescriptorPoolSize> poolSizes;
+                                           std::vector<DescriptorSetLayout::shared_ptr> layouts,
+                                           uint32_t initialMaxSets)
+    : _device(device) {
   for (const auto& layout : layouts) {
     for (const auto& poolSize : layout->poolSizes()) {
-      poolSizes.push_back(poolSize);
+      _poolSizes.push_back(poolSize);
     }
   }
-  _descriptorPool = DescriptorPool::make_shared(device, poolSizes, 1);
+  // Each task acquires one descriptor set of each of its layouts per frame.
+  const auto numLayouts = static_cast<uint32_t>(std::max<size_t>(layouts.size(), 1));
+  _initialMaxSets       = numLayouts * std::max(initialMaxSets, 1U);
+
+  _callbackId = _device.addHandleDestroyedCallback([this](uint64_t handle) {
+    std::scoped_lock lock(_mutex);
+    if (!_cache.empty()) {
+      _destroyedHandles.push_back(handle);
+    }
+  });
 }
 
 DescriptorSetManager::~DescriptorSetManager() {
+  _device.removeHandleDestroyedCallback(_callbackId);
+
+  // Free the sets before the pools
+  _acquiredDescriptorSets.clear();
+  _cache.clear();
 }
 
 DescriptorSet::shared_ptr DescriptorSetManager::acquireSet(const DescriptorSetLayout& layout) {
-  auto set = DescriptorSet::make_shared(*_descriptorPool, layout);
-  _acquiredDescriptorSets.push(set);
+  std::scoped_lock lock(_mutex);
+
+  auto& pool = _framePools.pools[availablePool(_framePools)];
+  ++pool.numSets;
+
+  auto set = DescriptorSet::make_shared(*pool.pool, layout);
+  _acquiredDescriptorSets.push_back(set);
+
+  const auto numFrameSets  = static_cast<uint32_t>(_acquiredDescriptorSets.size());
+  _statistics.maxFrameSets = std::max(_statistics.maxFrameSets, numFrameSets);
+  return set;
+}
+
+DescriptorSet::shared_ptr DescriptorSetManager::acquireSet(
+    const DescriptorUpdateTemplate& updateTemplate,
+    std::span<const DescriptorSet::Info> infos) {
+  // The lookup and the update read one info per binding.
+  if (infos.size() != updateTemplate.numBindings()) {
+    throw std::invalid_argument("The number of infos doesn't match the bindings of the template");
+  }
+
+  std::scoped_lock lock(_mutex);
+
+  if (!_destroyedHandles.empty()) {
+    evictDestroyed();
+  }
+
+  buildLookupKey(updateTemplate, infos);
+  if (auto found = _cache.find(_lookupKey); found != _cache.end()) {
+    ++_statistics.numHits;
+    found->second.lastUsedFrame = _frame;
+    return found->second.set;
+  }
+  ++_statistics.numMisses;
+
+  const auto poolIndex = availablePool(_cachePools);
+  auto& pool           = _cachePools.pools[poolIndex];
+  ++pool.numSets;
+
+  auto set = DescriptorSet::make_shared(*pool.pool, updateTemplate.layout());
+  set->update(updateTemplate, infos.data());
+  _cache.emplace(_lookupKey, CacheEntry{set, poolIndex, _frame});
+
+  const auto numCachedSets  = static_cast<uint32_t>(_cache.size());
+  _statistics.maxCachedSets = std::max(_statistics.maxCachedSets, numCachedSets);
   return set;
 }
 
 void DescriptorSetManager::reset() {
+  std::scoped_lock lock(_mutex);
+
+  // The frame is done with the sets (see `FrameContext::waitFrameRendered()`); free them.
   _acquiredDescriptorSets.clear();
-  _descriptorPool->reset();
+  for (auto& pool : _framePools.pools) {
+    if (pool.numSets > 0) {
+      pool.pool->reset();
+      pool.numSets = 0;
+    }
+  }
+
+  ++_frame;
+  evictUnused();
+  if (!_destroyedHandles.empty()) {
+    evictDestroyed();
+  }
+
+  trimPools(_framePools);
+  trimPools(_cachePools);
+}
+
+DescriptorSetManager::Statistics DescriptorSetManager::statistics() const {
+  std::scoped_lock lock(_mutex);
+
+  auto statistics = _statistics;
+  for (const auto* chain : {&_framePools, &_cachePools}) {
+    statistics.numPools += static_cast<uint32_t>(chain->pools.size());
+    for (const auto& pool : chain->pools) {
+      statistics.poolMaxSets += pool.maxSets;
+    }
+  }
+  return statistics;
+}
+
+uint32_t DescriptorSetManager::availablePool(PoolChain& chain) {
+  for (uint32_t i = 0; i < chain.pools.size(); ++i) {
+    auto& pool = chain.pools[i];
+    if (pool.numSets < pool.maxSets) {
+      pool.lastUsedFrame = _frame;
+      return i;
+    }
+  }
+
+  Pool pool;
+  pool.maxSets       = chain.pools.empty() ? _initialMaxSets : chain.pools.back().maxSets * 2;
+  pool.pool          = DescriptorPool::make_shared(
+      _device, _poolSizes, pool.maxSets, chain.setCanBeFreed);
+  pool.lastUsedFrame = _frame;
+  chain.pools.push_back(std::move(pool));
+  return static_cast<uint32_t>(chain.pools.size() - 1);
+}
+
+void DescriptorSetManager::trimPools(PoolChain& chain) {
+  // Only the last pools are destroyed, so the indices of the others stay valid.
+  while (chain.pools.size() > 1) {
+    const auto& pool = chain.pools.back();
+    if (pool.numSets > 0 || _frame - pool.lastUsedFrame <= kMaxUnusedFrames) {
+      break;
+    }
+    chain.pools.pop_back();
+  }
+}
+
+void DescriptorSetManager::buildLookupKey(const DescriptorUpdateTemplate& updateTemplate,
+                                          std::span<const DescriptorSet::Info> infos) {
+  auto& key  = _lookupKey;
+  key.layout = updateTemplate.layout();
+  key.contents.clear();
+  for (uint32_t i = 0; i < infos.size(); ++i) {
+    const auto& info = infos[i];
+    switch (updateTemplate.descriptorType(i)) {
+      case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+      case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        key.contents.push_back(handleBits(info.buffer.buffer));
+        key.contents.push_back(info.buffer.offset);
+        key.contents.push_back(info.buffer.range);
+        break;
+      default:
+        key.contents.push_back(handleBits(info.image.sampler));
+        key.contents.push_back(handleBits(info.image.imageView));
+        key.contents.push_back(info.image.imageLayout);
+    }
+  }
+
+  key.hash = std::hash<uint64_t>{}(handleBits(key.layout));
+  for (auto word : key.contents) {
+    hashCombine(key.hash, word);
+  }
+}
+
+void DescriptorSetManager::evict(
+    std::unordered_map<CacheKey, CacheEntry, CacheKeyHash>::iterator entry) {
+  --_cachePools.pools[entry->second.pool].numSets;
+  _cache.erase(entry);
+  ++_statistics.numEvictions;
+}
+
+void DescriptorSetManager::evictUnused() {
+  for (auto entry = _cache.begin(); entry != _cache.end();) {
+    if (_frame - entry->second.lastUsedFrame > kMaxUnusedFrames) {
+      evict(entry++);
+    } else {
+      ++entry;
+    }
+  }
+}
+
+void DescriptorSetManager::evictDestroyed() {
+  const std::unordered_set<uint64_t> destroyed(_destroyedHandles.begin(), _destroyedHandles.end());
+  _destroyedHandles.clear();
+
+  // An offset or a range equal to a destroyed handle only evicts a set that is still valid.
+  auto refersToDestroyed = [&](uint64_t word) { return destroyed.contains(word); };
+  for (auto entry = _cache.begin(); entry != _cache.end();) {
+    if (std::ranges::any_of(entry->first.contents, refersToDestroyed)) {
+      evict(entry++);
+    } else {
+      ++entry;
+    }
+  }
 }
 
 //
 // SyncObjectManager
 //
 Semaphore::shared_ptr SyncObjectManager::acquireSemaphore() {
-  if (_availableSemaphores.empty()) {
-    _availableSemaphores.push(Semaphore::make_shared(_device));
-  }
-
+  // Another thread may take the last available one between a check and a pop, so just try it.
   Semaphore::shared_ptr semaphore;
-  _availableSemaphores.try_pop(semaphore);
+  if (!_availableSemaphores.try_pop(semaphore)) {
+    semaphore = Semaphore::make_shared(_device);
+  }
   _acquiredSemaphores.push(semaphore);
   return semaphore;
 }
 
 Fence::shared_ptr SyncObjectManager::acquireFence() {
-  if (_availableFences.empty()) {
-    _availableFences.push(Fence::make_shared(_device));
-  }
-
   Fence::shared_ptr fence;
-  _availableFences.try_pop(fence);
+  if (!_availableFences.try_pop(fence)) {
+    fence = Fence::make_shared(_device);
+  }
   _acquiredFences.push(fence);
   return fence;
 }
@@ -152,26 +330,26 @@ void UniformBufferManager::reset() {
 // FrameContext
 //
 FrameContext::FrameContext(const DeviceContext& deviceContext,
-                           std::vector<RenderTask*> tasks)
-    : _deviceContext(deviceContext) {
+                           std::vector<RenderTask*> tasks,
+                           uint32_t frameIndex,
+                           uint32_t initialMaxSets)
+    : _deviceContext(deviceContext), _frameIndex(frameIndex) {
   const Device& device = _deviceContext.device();
 
-  // Initialize command buffer managers
-  Device::QueueFamilyType queueFamilies[] = {Device::QueueFamilyType::Graphics,
-                                             Device::QueueFamilyType::Compute,
-                                             Device::QueueFamilyType::Transfer};
-  for (auto family : queueFamilies) {
-    if (_deviceContext.isQueueFamilySupported(family)) {
-      _commandBufferManagers[family] = std::make_shared<CommandBufferManager>(device, family);
-    }
-  }
+  // The command buffer managers are created by the threads acquiring command buffers.
 
   // Initialize descriptor set manager
   std::vector<DescriptorSetLayout::shared_ptr> descriptorSetLayouts;
   for (auto task : tasks) {
-    descriptorSetLayouts.push_back(task->descriptorSetLayout());
+    for (auto& layout : task->descriptorSetLayouts()) {
+      // Null for the external sets and the tasks without descriptors
+      if (layout) {
+        descriptorSetLayouts.push_back(std::move(layout));
+      }
+    }
   }
-  _descriptorSetManager = std::make_shared<DescriptorSetManager>(device, descriptorSetLayouts);
+  _descriptorSetManager =
+      std::make_shared<DescriptorSetManager>(device, descriptorSetLayouts, initialMaxSets);
   _syncObjectManager    = std::make_shared<SyncObjectManager>(device);
   _framebufferKeeper    = std::make_shared<FramebufferKeeper>();
   _uniformBufferManager = std::make_shared<UniformBufferManager>(device);
@@ -181,13 +359,29 @@ FrameContext::FrameContext(const DeviceContext& deviceContext,
 }
 
 CommandBuffer::shared_ptr FrameContext::acquireCommandBuffer(Device::QueueFamilyType queueFamily) {
-  return _commandBufferManagers[static_cast<size_t>(queueFamily)]->acquireBuffer();
+  MI_VERIFY(_deviceContext.isQueueFamilySupported(queueFamily));
+
+  auto& manager = _commandBufferManagers[static_cast<size_t>(queueFamily)].local();
+  if (!manager) {
+    manager = std::make_shared<CommandBufferManager>(_deviceContext.device(), queueFamily);
+  }
+  return manager->acquireBuffer();
 }
 
 DescriptorSet::shared_ptr FrameContext::acquireDescriptorSet(const DescriptorSetLayout& layout) {
   return _descriptorSetManager->acquireSet(layout);
 }
 
+DescriptorSet::shared_ptr FrameContext::acquireDescriptorSet(
+    const DescriptorUpdateTemplate& updateTemplate,
+    std::span<const DescriptorSet::Info> infos) {
+  return _descriptorSetManager->acquireSet(updateTemplate, infos);
+}
+
+DescriptorSetManager::Statistics FrameContext::descriptorSetStatistics() const {
+  return _descriptorSetManager->statistics();
+}
+
 Semaphore::shared_ptr FrameContext::acquireSemaphore() {
   return _syncObjectManager->acquireSemaphore();
 }
@@ -204,10 +398,19 @@ void FrameContext::registerFramebuffer(const Framebuffer::shared_ptr& framebuffe
   _framebufferKeeper->registerFramebuffer(framebuffer);
 }
 
+void FrameContext::waitFrameRendered() const {
+  if (_framePresented.valid()) {
+    _framePresented.wait();
+  }
+  _frameRendered->wait();
+}
+
 void FrameContext::reset() {
-  for (auto& manager : _commandBufferManagers) {
-    if (manager) {
-      manager->reset();
+  for (auto& managers : _commandBufferManagers) {
+    for (auto& manager : managers) {
+      if (manager) {
+        manager->reset();
+      }
     }
   }
   _descriptorSetManager->reset();
@@ -0,0 +1,230 @@
+#include <Vulk/engine/MappedFile.h>
+
+#include <algorithm>
+
+#if defined(ARCH_OS_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <Vulk/internal/debug.h>
+
+namespace {
+
+#if !defined(ARCH_OS_WINDOWS)
+int toMadvise(Vulk::MappedFile::Access access) {
+  switch (access) {
+    case Vulk::MappedFile::Access::Sequential: return MADV_SEQUENTIAL;
+    case Vulk::MappedFile::Access::Random: return MADV_RANDOM;
+    case Vulk::MappedFile::Access::WillNeed: return MADV_WILLNEED;
+    case Vulk::MappedFile::Access::DontNeed: return MADV_DONTNEED;
+    default: return MADV_NORMAL;
+  }
+}
+#endif
+
+size_t pageSize() {
+#if defined(ARCH_OS_WINDOWS)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwAllocationGranularity;
+#else
+  static const auto size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return size;
+#endif
+}
+
+} // namespace
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+MappedFile::StreamBuf::StreamBuf(const MappedFile& file) {
+  // std::streambuf only hands out non-const pointers; the get area is never written through.
+  auto* begin = const_cast<char*>(reinterpret_cast<const char*>(file.data()));
+  setg(begin, begin, begin + file.size());
+}
+
+auto MappedFile::StreamBuf::seekoff(off_type off,
+                                    std::ios_base::seekdir dir,
+                                    std::ios_base::openmode which) -> pos_type {
+  if ((which & std::ios_base::in) == 0) {
+    return pos_type(off_type(-1));
+  }
+
+  off_type base = 0;
+  if (dir == std::ios_base::cur) {
+    base = gptr() - eback();
+  } else if (dir == std::ios_base::end) {
+    base = egptr() - eback();
+  }
+
+  const off_type pos = base + off;
+  if (pos < 0 || pos > egptr() - eback()) {
+    return pos_type(off_type(-1));
+  }
+  setg(eback(), eback() + pos, egptr());
+  return pos_type(pos);
+}
+
+auto MappedFile::StreamBuf::seekpos(pos_type pos, std::ios_base::openmode which) -> pos_type {
+  return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+MappedFile::MappedFile(const std::string& filename, Access access) {
+  open(filename, access);
+}
+
+MappedFile::~MappedFile() {
+  if (isOpen()) {
+    close();
+  }
+}
+
+void MappedFile::open(const std::string& filename, Access access) {
+  MI_VERIFY(!isOpen());
+
+#if defined(ARCH_OS_WINDOWS)
+  HANDLE file = CreateFileA(filename.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN
+                                                         : FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  MI_VERIFY_MSG(file != INVALID_HANDLE_VALUE, "Failed to open file '%s'", filename.c_str());
+  if (file == INVALID_HANDLE_VALUE) {
+    return;
+  }
+
+  LARGE_INTEGER fileSize{};
+  HANDLE mapping = nullptr;
+  if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  }
+  const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  MI_VERIFY_MSG(data != nullptr, "Failed to map empty or unreadable file '%s'", filename.c_str());
+  if (data == nullptr) {
+    if (mapping) {
+      CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    return;
+  }
+
+  _file    = file;
+  _mapping = mapping;
+  _data    = static_cast<const uint8_t*>(data);
+  _size    = static_cast<size_t>(fileSize.QuadPart);
+#else
+  const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  MI_VERIFY_MSG(fd >= 0, "Failed to open file '%s'", filename.c_str());
+  if (fd < 0) {
+    return;
+  }
+
+  struct stat status{};
+  const bool readable = ::fstat(fd, &status) == 0 && status.st_size > 0;
+  MI_VERIFY_MSG(readable, "Failed to map empty or unreadable file '%s'", filename.c_str());
+  if (!readable) {
+    ::close(fd);
+    return;
+  }
+
+  void* data = ::mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+  MI_VERIFY_MSG(data != MAP_FAILED, "Failed to map file '%s'", filename.c_str());
+  if (data == MAP_FAILED) {
+    return;
+  }
+
+  _data = static_cast<const uint8_t*>(data);
+  _size = static_cast<size_t>(status.st_size);
+#endif
+
+  _filename = filename;
+
+  if (access != Access::Normal) {
+    advise(access);
+  }
+}
+
+void MappedFile::close() {
+  MI_VERIFY(isOpen());
+
+#if defined(ARCH_OS_WINDOWS)
+  UnmapViewOfFile(_data);
+  CloseHandle(_mapping);
+  CloseHandle(_file);
+  _mapping = nullptr;
+  _file    = nullptr;
+#else
+  ::munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+
+  _data = nullptr;
+  _size = 0;
+  _filename.clear();
+}
+
+void MappedFile::advise(Access access, size_t offset, size_t size) const {
+  MI_VERIFY(isOpen());
+  MI_ASSERT(offset + size <= _size);
+
+  if (size == 0) {
+    return;
+  }
+
+  // Advice ranges must start at a page boundary.
+  const size_t begin = offset - offset % pageSize();
+  const size_t end   = std::min(offset + size, _size);
+
+#if defined(ARCH_OS_WINDOWS)
+  if (access == Access::WillNeed || access == Access::Sequential) {
+    WIN32_MEMORY_RANGE_ENTRY range{const_cast<uint8_t*>(_data) + begin, end - begin};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+  }
+#else
+  ::madvise(const_cast<uint8_t*>(_data) + begin, end - begin, toMadvise(access));
+#endif
+}
+
+void MappedFile::forEachChunk(size_t chunkSize,
+                              size_t offset,
+                              size_t size,
+                              const ChunkFunc& func) const {
+  MI_VERIFY(isOpen());
+  MI_VERIFY(offset + size <= _size);
+  MI_VERIFY(chunkSize > 0);
+
+  const size_t end = offset + size;
+
+  advise(Access::Sequential, offset, size);
+  advise(Access::WillNeed, offset, std::min(chunkSize, size));
+
+  for (size_t chunk = offset; chunk < end; chunk += chunkSize) {
+    const size_t chunkEnd = std::min(chunk + chunkSize, end);
+
+    if (chunkEnd < end) {
+      advise(Access::WillNeed, chunkEnd, std::min(chunkSize, end - chunkEnd));
+    }
+
+    func(chunk - offset, _data + chunk, chunkEnd - chunk);
+
+    // Only release whole pages that are fully consumed so the next chunk stays resident.
+    const size_t consumed = chunkEnd - chunkEnd % pageSize();
+    const size_t released = chunk - chunk % pageSize();
+    if (consumed > released) {
+      advise(Access::DontNeed, released, consumed - released);
+    }
+  }
+}
+
+MI_NAMESPACE_END(Vulk)
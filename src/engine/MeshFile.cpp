@@ -0,0 +1,186 @@
+#include <Vulk/engine/MeshFile.h>
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#include <Vulk/internal/debug.h>
+
+namespace {
+
+static_assert(std::is_trivially_copyable_v<Vulk::MeshFile::Header>);
+static_assert(sizeof(Vulk::MeshFile::Header) % Vulk::MeshFile::BLOB_ALIGNMENT == 0);
+
+constexpr uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// FNV-1a
+uint64_t hash64(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ULL) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  uint64_t hash     = seed;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+void writePadding(std::ofstream& out, uint64_t alignment) {
+  static constexpr std::array<char, Vulk::MeshFile::BLOB_ALIGNMENT> zeros{};
+  const auto pos = static_cast<uint64_t>(out.tellp());
+  out.write(zeros.data(), static_cast<std::streamsize>(alignUp(pos, alignment) - pos));
+}
+
+} // namespace
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+MeshFile::MeshFile(const std::string& filename) {
+  open(filename);
+}
+
+bool MeshFile::open(const std::string& filename) {
+  MI_VERIFY(!isOpen());
+
+  if (!std::filesystem::exists(filename)) {
+    return false;
+  }
+
+  _file.open(filename, MappedFile::Access::Sequential);
+  if (!isOpen() || !isValid()) {
+    if (isOpen()) {
+      MI_LOG_WARNING("Invalid mesh file '%s'", filename.c_str());
+      close();
+    }
+    return false;
+  }
+  return true;
+}
+
+void MeshFile::close() {
+  _file.close();
+}
+
+void MeshFile::write(const std::string& filename,
+                     const void* vertices,
+                     uint32_t vertexSize,
+                     uint32_t vertexLayout,
+                     uint64_t numVertices,
+                     const void* indices,
+                     uint32_t indexSize,
+                     uint64_t numIndices,
+                     const BBox& bbox,
+                     uint64_t sourceKey) {
+  MI_VERIFY(indexSize == 1 || indexSize == 2 || indexSize == 4);
+
+  Header header{};
+  header.magic        = MAGIC;
+  header.version      = VERSION;
+  header.sourceKey    = sourceKey;
+  header.vertexSize   = vertexSize;
+  header.indexSize    = indexSize;
+  header.vertexLayout = vertexLayout;
+  header.numVertices  = numVertices;
+  header.numIndices   = numIndices;
+  header.vertexOffset = alignUp(sizeof(Header), BLOB_ALIGNMENT);
+  header.indexOffset  = alignUp(header.vertexOffset + vertexSize * numVertices, BLOB_ALIGNMENT);
+  std::memcpy(header.bboxLower, &bbox.lower(), sizeof(header.bboxLower));
+  std::memcpy(header.bboxUpper, &bbox.upper(), sizeof(header.bboxUpper));
+
+  const auto tmpFilename = filename + ".tmp";
+  {
+    std::ofstream out{tmpFilename, std::ios::binary | std::ios::trunc};
+    MI_VERIFY_MSG(out, "Failed to create file '%s'", tmpFilename.c_str());
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writePadding(out, BLOB_ALIGNMENT);
+    out.write(static_cast<const char*>(vertices),
+              static_cast<std::streamsize>(vertexSize * numVertices));
+    writePadding(out, BLOB_ALIGNMENT);
+    out.write(static_cast<const char*>(indices),
+              static_cast<std::streamsize>(indexSize * numIndices));
+
+    MI_VERIFY_MSG(out.good(), "Failed to write file '%s'", tmpFilename.c_str());
+  }
+
+  std::error_code error;
+  std::filesystem::rename(tmpFilename, filename, error);
+  MI_VERIFY_MSG(!error, "Failed to rename '%s': %s", tmpFilename.c_str(), error.message().c_str());
+}
+
+uint32_t MeshFile::layoutKey(const std::vector<VkVertexInputAttributeDescription>& attributes) {
+  const uint64_t count = attributes.size();
+  uint64_t key         = hash64(&count, sizeof(count));
+  for (const auto& attribute : attributes) {
+    const uint32_t words[3] = {attribute.location,
+                               static_cast<uint32_t>(attribute.format),
+                               attribute.offset};
+    key = hash64(words, sizeof(words), key);
+  }
+  return static_cast<uint32_t>(key ^ (key >> 32));
+}
+
+uint64_t MeshFile::sourceKey(const std::filesystem::path& source) {
+  std::error_code error;
+  const auto path  = std::filesystem::absolute(source, error).string();
+  const auto mtime = std::filesystem::last_write_time(source, error).time_since_epoch().count();
+  const auto size  = std::filesystem::file_size(source, error);
+
+  uint64_t key = hash64(path.data(), path.size());
+  key          = hash64(&mtime, sizeof(mtime), key);
+  key          = hash64(&size, sizeof(size), key);
+  return key;
+}
+
+std::filesystem::path MeshFile::cachePath(const std::filesystem::path& source,
+                                          const std::filesystem::path& cacheDir) {
+  std::error_code error;
+  const auto path = std::filesystem::absolute(source, error).string();
+
+  char name[32];
+  const auto hash = static_cast<unsigned long long>(hash64(path.data(), path.size()));
+  std::snprintf(name, sizeof(name), "%016llx", hash);
+
+  return cacheDir / (source.stem().string() + "-" + name + EXTENSION);
+}
+
+VkIndexType MeshFile::indexType() const {
+  switch (indexSize()) {
+    case 1: return VK_INDEX_TYPE_UINT8_EXT;
+    case 2: return VK_INDEX_TYPE_UINT16;
+    case 4: return VK_INDEX_TYPE_UINT32;
+    default: return VK_INDEX_TYPE_NONE_KHR;
+  }
+}
+
+auto MeshFile::bbox() const -> BBox {
+  const auto& h = header();
+  return BBox{glm::vec3{h.bboxLower[0], h.bboxLower[1], h.bboxLower[2]},
+              glm::vec3{h.bboxUpper[0], h.bboxUpper[1], h.bboxUpper[2]}};
+}
+
+bool MeshFile::isValid() const {
+  if (_file.size() < sizeof(Header)) {
+    return false;
+  }
+
+  const auto& h = header();
+  if (h.magic != MAGIC || h.version != VERSION) {
+    return false;
+  }
+  if (h.indexSize != 1 && h.indexSize != 2 && h.indexSize != 4) {
+    return false;
+  }
+  if (h.vertexOffset % BLOB_ALIGNMENT != 0 || h.indexOffset % BLOB_ALIGNMENT != 0) {
+    return false;
+  }
+
+  const uint64_t vertexEnd = h.vertexOffset + h.vertexSize * h.numVertices;
+  const uint64_t indexEnd  = h.indexOffset + h.indexSize * h.numIndices;
+  return vertexEnd <= h.indexOffset && indexEnd <= _file.size();
+}
+
+MI_NAMESPACE_END(Vulk)
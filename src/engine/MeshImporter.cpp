@@ -0,0 +1,312 @@
+#include <Vulk/engine/MeshImporter.h>
+
+#include <Vulk/engine/MappedFile.h>
+#include <Vulk/internal/debug.h>
+
+#include <tiny_obj_loader.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <istream>
+#include <limits>
+
+namespace {
+
+using Vertex = Vulk::MeshImporter::Vertex;
+using Index  = Vulk::MeshImporter::Index;
+
+static_assert(sizeof(Vertex) == 8 * sizeof(float), "Vertex is expected to be tightly packed");
+static_assert(sizeof(Vulk::MeshImporter::PackedVertex) * 2 == sizeof(Vertex));
+
+// Number of corners deduplicated by one task.
+constexpr size_t kBlockSize = 64 * 1024;
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+uint64_t mix(uint64_t x) {
+  // Finalizer of MurmurHash3
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+//
+// An open-addressing (linear probing) hash table from vertices to their indices in `vertices`.
+// Only indices and hash tags are stored in the slots; the vertices themselves live in the output
+// array so they are never copied twice.
+//
+class VertexTable {
+ public:
+  explicit VertexTable(size_t expectedSize) {
+    rehash(std::bit_ceil(std::max<size_t>(expectedSize * 2, 16)));
+  }
+
+  // Return the index of `vertex`, appending it to `vertices` and `hashes` if it's new.
+  Index insert(const Vertex& vertex,
+               uint64_t hash,
+               std::vector<Vertex>& vertices,
+               std::vector<uint64_t>& hashes) {
+    if ((vertices.size() + 1) * 2 > _slots.size()) {
+      rehash(_slots.size() * 2, hashes);
+    }
+
+    const auto tag = static_cast<uint32_t>(hash >> 32);
+    for (size_t slot = hash & _mask;; slot = (slot + 1) & _mask) {
+      auto& entry = _slots[slot];
+      if (entry.index == kEmpty) {
+        entry = {tag, static_cast<Index>(vertices.size())};
+        vertices.push_back(vertex);
+        hashes.push_back(hash);
+        return entry.index;
+      }
+      if (entry.tag == tag && std::memcmp(&vertices[entry.index], &vertex, sizeof(Vertex)) == 0) {
+        return entry.index;
+      }
+    }
+  }
+
+ private:
+  void rehash(size_t capacity, const std::vector<uint64_t>& hashes = {}) {
+    _slots.assign(capacity, {0, kEmpty});
+    _mask = capacity - 1;
+
+    for (size_t i = 0; i < hashes.size(); ++i) {
+      size_t slot = hashes[i] & _mask;
+      while (_slots[slot].index != kEmpty) {
+        slot = (slot + 1) & _mask;
+      }
+      _slots[slot] = {static_cast<uint32_t>(hashes[i] >> 32), static_cast<Index>(i)};
+    }
+  }
+
+ private:
+  static constexpr Index kEmpty = std::numeric_limits<Index>::max();
+
+  struct Slot {
+    uint32_t tag;
+    Index index;
+  };
+  std::vector<Slot> _slots;
+  size_t _mask = 0;
+};
+
+// A contiguous range of corners of one shape.
+struct Block {
+  const tinyobj::shape_t* shape;
+  size_t begin;
+  size_t end;
+  size_t firstCorner; // offset of the block in the final index buffer
+
+  // Outputs of the per-block deduplication
+  std::vector<Vertex> vertices;
+  std::vector<uint64_t> hashes;
+  std::vector<Index> indices; // local to `vertices`
+};
+
+float canonical(float value) {
+  // Fold -0.0 into 0.0 so they hash and compare equal as they do with operator==.
+  return value + 0.0F;
+}
+
+Vertex makeVertex(const tinyobj::attrib_t& attrib, const tinyobj::index_t& index) {
+  Vertex vertex{};
+
+  vertex.pos = {canonical(attrib.vertices[3 * index.vertex_index + 0]),
+                canonical(attrib.vertices[3 * index.vertex_index + 1]),
+                canonical(attrib.vertices[3 * index.vertex_index + 2])};
+
+  if (index.texcoord_index >= 0) {
+    vertex.texCoord = {canonical(attrib.texcoords[2 * index.texcoord_index + 0]),
+                       canonical(attrib.texcoords[2 * index.texcoord_index + 1])};
+  }
+
+  vertex.color = {1.0F, 1.0F, 1.0F};
+
+  return vertex;
+}
+
+void dedup(const tinyobj::attrib_t& attrib, Block& block) {
+  const size_t numCorners = block.end - block.begin;
+
+  // Most meshes have roughly one unique vertex per 4~6 corners.
+  VertexTable table{numCorners / 4};
+  block.vertices.reserve(numCorners / 4);
+  block.hashes.reserve(numCorners / 4);
+  block.indices.resize(numCorners);
+
+  const auto& corners = block.shape->mesh.indices;
+  for (size_t i = block.begin; i < block.end; ++i) {
+    const Vertex vertex = makeVertex(attrib, corners[i]);
+    const uint64_t hash = Vulk::MeshImporter::hash(vertex);
+
+    block.indices[i - block.begin] = table.insert(vertex, hash, block.vertices, block.hashes);
+  }
+}
+
+// Half the extent of `bbox` in each dimension. Flat dimensions are mapped with a unit scale so the
+// dequantization stays invertible.
+glm::vec3 halfExtentOf(const Vulk::MeshImporter::BBox& bbox) {
+  glm::vec3 halfExtent = bbox.extent() / 2.0F;
+  for (int i = 0; i < 3; ++i) {
+    if (!(halfExtent[i] > 0.0F)) {
+      halfExtent[i] = 1.0F;
+    }
+  }
+  return halfExtent;
+}
+
+} // namespace
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+uint64_t MeshImporter::hash(const Vertex& vertex) {
+  uint64_t words[sizeof(Vertex) / sizeof(uint64_t)];
+  std::memcpy(words, &vertex, sizeof(Vertex));
+
+  uint64_t result = 0x9e3779b97f4a7c15ULL;
+  for (auto word : words) {
+    result = mix(result ^ word) + 0x9e3779b97f4a7c15ULL;
+  }
+  return mix(result);
+}
+
+auto MeshImporter::quantize(const std::vector<Vertex>& vertices, const BBox& bbox)
+    -> std::vector<PackedVertex> {
+  const glm::vec3 center     = bbox.center();
+  const glm::vec3 halfExtent = halfExtentOf(bbox);
+
+  std::vector<PackedVertex> packed(vertices.size());
+  tbb::parallel_for(tbb::blocked_range<size_t>{0, vertices.size(), kBlockSize},
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t i = range.begin(); i != range.end(); ++i) {
+                        const auto& vertex = vertices[i];
+                        const auto pos     = (vertex.pos - center) / halfExtent;
+
+                        packed[i].pos      = snorm16x4{glm::vec4{pos, 1.0F}};
+                        packed[i].color    = unorm8x4{glm::vec4{vertex.color, 1.0F}};
+                        packed[i].texCoord = half2{vertex.texCoord};
+                      }
+                    });
+  return packed;
+}
+
+glm::mat4 MeshImporter::dequantization(const BBox& bbox) {
+  const glm::mat4 translation = glm::translate(glm::mat4{1.0F}, bbox.center());
+  return glm::scale(translation, halfExtentOf(bbox));
+}
+
+bool MeshImporter::importObj(const std::filesystem::path& objFile,
+                             std::vector<Vertex>& vertices,
+                             std::vector<Index>& indices,
+                             Statistics* statistics) {
+  auto start = Clock::now();
+
+  tinyobj::attrib_t attrib;
+  std::vector<tinyobj::shape_t> shapes;
+  std::vector<tinyobj::material_t> materials;
+  std::string warn, err;
+
+  MappedFile file{objFile.string(), MappedFile::Access::Sequential};
+  if (!file.isOpen()) {
+    return false;
+  }
+  MappedFile::StreamBuf streamBuf{file};
+  std::istream objStream{&streamBuf};
+  tinyobj::MaterialFileReader materialReader{objFile.parent_path().string() + "/"};
+
+  if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &objStream, &materialReader)) {
+    MI_LOG_ERROR("Failed to load '%s': %s", objFile.string().c_str(), (warn + err).c_str());
+    return false;
+  }
+
+  const double parseTime = secondsSince(start);
+  start                  = Clock::now();
+
+  // Split all shapes into blocks of corners.
+  std::vector<Block> blocks;
+  size_t numCorners = 0;
+  for (const auto& shape : shapes) {
+    const size_t shapeCorners = shape.mesh.indices.size();
+    for (size_t begin = 0; begin < shapeCorners; begin += kBlockSize) {
+      const size_t end = std::min(begin + kBlockSize, shapeCorners);
+      blocks.push_back({&shape, begin, end, numCorners + begin, {}, {}, {}});
+    }
+    numCorners += shapeCorners;
+  }
+
+  tbb::parallel_for(tbb::blocked_range<size_t>{0, blocks.size()},
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t i = range.begin(); i != range.end(); ++i) {
+                        dedup(attrib, blocks[i]);
+                      }
+                    });
+
+  const double dedupTime = secondsSince(start);
+  start                  = Clock::now();
+
+  // Merge the per-block unique vertices in block order, then remap the local indices in parallel.
+  size_t numBlockVertices = 0;
+  for (const auto& block : blocks) {
+    numBlockVertices += block.vertices.size();
+  }
+
+  std::vector<Vertex> mergedVertices;
+  std::vector<uint64_t> mergedHashes;
+  mergedVertices.reserve(numBlockVertices);
+  mergedHashes.reserve(numBlockVertices);
+
+  VertexTable table{numBlockVertices};
+  std::vector<std::vector<Index>> remaps(blocks.size());
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    auto& block = blocks[i];
+    auto& remap = remaps[i];
+
+    remap.resize(block.vertices.size());
+    for (size_t v = 0; v < block.vertices.size(); ++v) {
+      remap[v] = table.insert(block.vertices[v], block.hashes[v], mergedVertices, mergedHashes);
+    }
+    block.vertices = {};
+    block.hashes   = {};
+  }
+
+  std::vector<Index> mergedIndices(numCorners);
+  tbb::parallel_for(tbb::blocked_range<size_t>{0, blocks.size()},
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t i = range.begin(); i != range.end(); ++i) {
+                        const auto& block = blocks[i];
+                        const auto& remap = remaps[i];
+                        for (size_t c = 0; c < block.indices.size(); ++c) {
+                          mergedIndices[block.firstCorner + c] = remap[block.indices[c]];
+                        }
+                      }
+                    });
+
+  vertices = std::move(mergedVertices);
+  indices  = std::move(mergedIndices);
+
+  if (statistics) {
+    statistics->numCorners = numCorners;
+    statistics->numBlocks  = blocks.size();
+    statistics->parseTime  = parseTime;
+    statistics->dedupTime  = dedupTime;
+    statistics->mergeTime  = secondsSince(start);
+  }
+
+  return true;
+}
+
+MI_NAMESPACE_END(Vulk)
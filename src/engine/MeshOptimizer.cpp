@@ -0,0 +1,381 @@
+#include <Vulk/engine/MeshOptimizer.h>
+
+#include <Vulk/internal/debug.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+//
+// Forsyth, "Linear-Speed Vertex Cache Optimisation", 2006.
+//
+constexpr int kCacheSize           = 32;
+constexpr float kCacheDecayPower   = 1.5F;
+constexpr float kLastTriScore      = 0.75F;
+constexpr float kValenceBoostScale = 2.0F;
+constexpr float kValenceBoostPower = 0.5F;
+constexpr int kMaxValence          = 64; // valence scores are tabulated up to this
+
+struct ScoreTable {
+  std::array<float, kCacheSize> cache{};
+  std::array<float, kMaxValence> valence{};
+
+  ScoreTable() {
+    for (int i = 0; i < kCacheSize; ++i) {
+      if (i < 3) {
+        // The vertices of the last triangle get a fixed score so the next triangle doesn't
+        // simply reuse all of them.
+        cache[i] = kLastTriScore;
+      } else {
+        const float scaler = 1.0F / static_cast<float>(kCacheSize - 3);
+        cache[i] = std::pow(1.0F - static_cast<float>(i - 3) * scaler, kCacheDecayPower);
+      }
+    }
+    for (int i = 1; i < kMaxValence; ++i) {
+      valence[i] = kValenceBoostScale * std::pow(static_cast<float>(i), -kValenceBoostPower);
+    }
+  }
+
+  [[nodiscard]] float score(int cachePosition, uint32_t activeTriangles) const {
+    if (activeTriangles == 0) {
+      // No triangle needs this vertex anymore.
+      return -1.0F;
+    }
+    float score = cachePosition < 0 ? 0.0F : cache[cachePosition];
+    score += activeTriangles < kMaxValence
+                 ? valence[activeTriangles]
+                 : kValenceBoostScale *
+                       std::pow(static_cast<float>(activeTriangles), -kValenceBoostPower);
+    return score;
+  }
+};
+
+using Position = std::array<float, 3>;
+
+float length(const Position& v) {
+  return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+// The misses of the triangle at `triangle` in a FIFO vertex cache of `cacheSize`. Advancing
+// `timestamp` by more than `cacheSize` flushes the cache.
+uint32_t updateCache(const uint32_t* triangle,
+                     uint32_t cacheSize,
+                     std::vector<uint32_t>& timestamps,
+                     uint32_t& timestamp) {
+  uint32_t misses = 0;
+  for (int i = 0; i < 3; ++i) {
+    auto& insertedAt = timestamps[triangle[i]];
+    if (timestamp - insertedAt > cacheSize) {
+      insertedAt = timestamp++;
+      ++misses;
+    }
+  }
+  return misses;
+}
+
+// How much the area-weighted average of the triangles [begin, end) faces away from `center`
+float outwardness(const std::vector<Position>& positions,
+                  const std::vector<uint32_t>& indices,
+                  size_t begin,
+                  size_t end,
+                  const Position& center) {
+  Position centroid{};
+  Position normal{};
+  float area = 0.0F;
+  for (size_t t = begin; t < end; ++t) {
+    const auto& p0 = positions[indices[3 * t + 0]];
+    const auto& p1 = positions[indices[3 * t + 1]];
+    const auto& p2 = positions[indices[3 * t + 2]];
+
+    const Position e1 = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+    const Position e2 = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+    const Position n  = {e1[1] * e2[2] - e1[2] * e2[1],
+                         e1[2] * e2[0] - e1[0] * e2[2],
+                         e1[0] * e2[1] - e1[1] * e2[0]};
+    const float a     = length(n);
+
+    for (int i = 0; i < 3; ++i) {
+      centroid[i] += (p0[i] + p1[i] + p2[i]) * (a / 3.0F);
+      normal[i] += n[i];
+    }
+    area += a;
+  }
+  const float normalLength = length(normal);
+  if (area == 0.0F || normalLength == 0.0F) {
+    return 0.0F;
+  }
+
+  float outwardness = 0.0F;
+  for (int i = 0; i < 3; ++i) {
+    outwardness += (centroid[i] / area - center[i]) * normal[i] / normalLength;
+  }
+  return outwardness;
+}
+
+} // namespace
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices) {
+  MI_VERIFY(indices.size() % 3 == 0);
+
+  const size_t numTriangles = indices.size() / 3;
+  if (numTriangles == 0) {
+    return;
+  }
+
+  static const ScoreTable scores;
+
+  // Vertex-to-triangle adjacency in CSR layout
+  std::vector<uint32_t> activeTriangles(numVertices, 0);
+  for (auto index : indices) {
+    MI_ASSERT(index < numVertices);
+    ++activeTriangles[index];
+  }
+  std::vector<uint32_t> adjacencyOffsets(numVertices + 1, 0);
+  for (size_t v = 0; v < numVertices; ++v) {
+    adjacencyOffsets[v + 1] = adjacencyOffsets[v] + activeTriangles[v];
+  }
+  std::vector<uint32_t> adjacency(indices.size());
+  {
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); ++i) {
+      adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+  }
+
+  std::vector<float> vertexScores(numVertices);
+  for (size_t v = 0; v < numVertices; ++v) {
+    vertexScores[v] = scores.score(-1, activeTriangles[v]);
+  }
+
+  std::vector<float> triangleScores(numTriangles);
+  std::vector<bool> emitted(numTriangles, false);
+  for (size_t t = 0; t < numTriangles; ++t) {
+    triangleScores[t] = vertexScores[indices[3 * t + 0]] + vertexScores[indices[3 * t + 1]] +
+                        vertexScores[indices[3 * t + 2]];
+  }
+
+  std::vector<uint32_t> output;
+  output.reserve(indices.size());
+
+  // The cache has room for one more triangle so vertices pushed out can be rescored.
+  std::array<uint32_t, kCacheSize + 3> cache{};
+  size_t cacheCount = 0;
+
+  size_t bestTriangle = 0;
+  for (size_t t = 1; t < numTriangles; ++t) {
+    if (triangleScores[t] > triangleScores[bestTriangle]) {
+      bestTriangle = t;
+    }
+  }
+  size_t scanCursor = 0;
+
+  for (size_t n = 0; n < numTriangles; ++n) {
+    if (bestTriangle == numTriangles) {
+      // No candidate adjacent to the cache; fall back to the next triangle in the input order.
+      while (emitted[scanCursor]) {
+        ++scanCursor;
+      }
+      bestTriangle = scanCursor;
+    }
+
+    const size_t t = bestTriangle;
+    emitted[t]     = true;
+
+    const uint32_t tri[3] = {indices[3 * t + 0], indices[3 * t + 1], indices[3 * t + 2]};
+    output.insert(output.end(), tri, tri + 3);
+
+    // Remove the triangle from the adjacency of its vertices.
+    for (auto v : tri) {
+      auto* begin = adjacency.data() + adjacencyOffsets[v];
+      auto* end   = begin + activeTriangles[v];
+      auto* it    = std::find(begin, end, static_cast<uint32_t>(t));
+      MI_ASSERT(it != end);
+      std::swap(*it, *(end - 1));
+      --activeTriangles[v];
+    }
+
+    // Move the triangle vertices to the front of the LRU cache.
+    std::array<uint32_t, kCacheSize + 3> newCache{};
+    size_t newCount = 0;
+    for (auto v : tri) {
+      newCache[newCount++] = v;
+    }
+    for (size_t i = 0; i < cacheCount; ++i) {
+      const auto v = cache[i];
+      if (v != tri[0] && v != tri[1] && v != tri[2]) {
+        newCache[newCount++] = v;
+      }
+    }
+
+    // Rescore the vertices in the cache (including the ones just pushed out) and the triangles
+    // that use them. The best of these triangles is the next candidate.
+    bestTriangle    = numTriangles;
+    float bestScore = -1.0F;
+    for (size_t i = 0; i < newCount; ++i) {
+      const auto v       = newCache[i];
+      const int position = i < kCacheSize ? static_cast<int>(i) : -1;
+      vertexScores[v]    = scores.score(position, activeTriangles[v]);
+    }
+    for (size_t i = 0; i < newCount; ++i) {
+      const auto v = newCache[i];
+      for (uint32_t a = 0; a < activeTriangles[v]; ++a) {
+        const auto adjacent = adjacency[adjacencyOffsets[v] + a];
+        const float score   = vertexScores[indices[3 * adjacent + 0]] +
+                            vertexScores[indices[3 * adjacent + 1]] +
+                            vertexScores[indices[3 * adjacent + 2]];
+        triangleScores[adjacent] = score;
+        if (score > bestScore) {
+          bestScore    = score;
+          bestTriangle = adjacent;
+        }
+      }
+    }
+
+    cacheCount = std::min<size_t>(newCount, kCacheSize);
+    std::copy_n(newCache.begin(), cacheCount, cache.begin());
+  }
+
+  indices = std::move(output);
+}
+
+void MeshOptimizer::optimizeOverdraw(const std::vector<std::array<float, 3>>& positions,
+                                     std::vector<uint32_t>& indices) {
+  MI_VERIFY(indices.size() % 3 == 0);
+
+  const size_t numTriangles = indices.size() / 3;
+  if (numTriangles == 0) {
+    return;
+  }
+
+  constexpr uint32_t kFlush = ACMR_CACHE_SIZE + 1;
+  std::vector<uint32_t> timestamps(positions.size(), 0);
+  uint32_t timestamp = kFlush;
+
+  // A triangle missing all its vertices likely starts a patch disjoint from the previous ones.
+  std::vector<size_t> patches;
+  for (size_t t = 0; t < numTriangles; ++t) {
+    if (updateCache(&indices[3 * t], ACMR_CACHE_SIZE, timestamps, timestamp) == 3 || t == 0) {
+      patches.push_back(t);
+    }
+  }
+  patches.push_back(numTriangles);
+
+  // The patches are split into clusters as soon as the ACMR since the last split gets close
+  // enough to the one of the patch; the cache is flushed at each split.
+  std::vector<size_t> clusters;
+  for (size_t p = 0; p + 1 < patches.size(); ++p) {
+    const size_t begin = patches[p];
+    const size_t end   = patches[p + 1];
+
+    timestamp += kFlush;
+    uint32_t patchMisses = 0;
+    for (size_t t = begin; t < end; ++t) {
+      patchMisses += updateCache(&indices[3 * t], ACMR_CACHE_SIZE, timestamps, timestamp);
+    }
+    const float threshold =
+        OVERDRAW_THRESHOLD * static_cast<float>(patchMisses) / static_cast<float>(end - begin);
+
+    clusters.push_back(begin);
+    timestamp += kFlush;
+    uint32_t clusterMisses    = 0;
+    size_t clusterTriangles = 0;
+    for (size_t t = begin; t + 1 < end; ++t) {
+      clusterMisses += updateCache(&indices[3 * t], ACMR_CACHE_SIZE, timestamps, timestamp);
+      ++clusterTriangles;
+      if (static_cast<float>(clusterMisses) <=
+          threshold * static_cast<float>(clusterTriangles)) {
+        clusters.push_back(t + 1);
+        timestamp += kFlush;
+        clusterMisses    = 0;
+        clusterTriangles = 0;
+      }
+    }
+  }
+  clusters.push_back(numTriangles);
+
+  Position center{};
+  for (const auto& position : positions) {
+    for (int i = 0; i < 3; ++i) {
+      center[i] += position[i];
+    }
+  }
+  for (int i = 0; i < 3; ++i) {
+    center[i] /= static_cast<float>(std::max<size_t>(positions.size(), 1));
+  }
+
+  // The clusters facing outward are the most likely to occlude the others from any viewpoint.
+  const size_t numClusters = clusters.size() - 1;
+  std::vector<float> keys(numClusters);
+  for (size_t c = 0; c < numClusters; ++c) {
+    keys[c] = outwardness(positions, indices, clusters[c], clusters[c + 1], center);
+  }
+  std::vector<size_t> order(numClusters);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(
+      order.begin(), order.end(), [&](size_t a, size_t b) { return keys[a] > keys[b]; });
+
+  std::vector<uint32_t> output;
+  output.reserve(indices.size());
+  for (auto c : order) {
+    output.insert(output.end(),
+                  indices.begin() + static_cast<ptrdiff_t>(3 * clusters[c]),
+                  indices.begin() + static_cast<ptrdiff_t>(3 * clusters[c + 1]));
+  }
+  indices = std::move(output);
+}
+
+std::vector<uint32_t> MeshOptimizer::remapVertexFetch(std::vector<uint32_t>& indices,
+                                                      size_t numVertices,
+                                                      size_t& numReferencedVertices) {
+  std::vector<uint32_t> remap(numVertices, UNUSED);
+
+  uint32_t next = 0;
+  for (auto& index : indices) {
+    MI_ASSERT(index < numVertices);
+    if (remap[index] == UNUSED) {
+      remap[index] = next++;
+    }
+    index = remap[index];
+  }
+
+  numReferencedVertices = next;
+  return remap;
+}
+
+float MeshOptimizer::acmr(const std::vector<uint32_t>& indices,
+                          size_t numVertices,
+                          uint32_t cacheSize) {
+  const size_t numTriangles = indices.size() / 3;
+  if (numTriangles == 0) {
+    return 0.0F;
+  }
+
+  // FIFO cache simulation: a vertex is a hit if it was inserted within the last `cacheSize`
+  // misses.
+  std::vector<size_t> insertedAt(numVertices, 0);
+  size_t misses = 0;
+  for (auto index : indices) {
+    if (insertedAt[index] == 0 || misses + 1 - insertedAt[index] > cacheSize) {
+      ++misses;
+      insertedAt[index] = misses;
+    }
+  }
+
+  return static_cast<float>(misses) / static_cast<float>(numTriangles);
+}
+
+std::vector<uint16_t> MeshOptimizer::narrow(const std::vector<uint32_t>& indices) {
+  std::vector<uint16_t> narrowed(indices.size());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    MI_ASSERT(indices[i] <= std::numeric_limits<uint16_t>::max());
+    narrowed[i] = static_cast<uint16_t>(indices[i]);
+  }
+  return narrowed;
+}
+
+MI_NAMESPACE_END(Vulk)
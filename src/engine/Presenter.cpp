@@ -0,0 +1,108 @@
+#include <Vulk/engine/Presenter.h>
+
+#include <algorithm>
+#include <utility>
+
+#include <Vulk/internal/debug.h>
+
+#include <Vulk/engine/FrameContext.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+Presenter::Presenter(uint32_t queueDepth) : _queueDepth(queueDepth) {
+  MI_VERIFY(queueDepth > 0);
+  _frames.set_capacity(queueDepth);
+  _thread = std::thread([this]() { run(); });
+}
+
+Presenter::~Presenter() {
+  // The stop request is queued after the frames, so they are all presented before the thread ends.
+  _frames.push(Frame{});
+  _thread.join();
+}
+
+void Presenter::present(FrameContext& frameContext, PresentFunc present) {
+  {
+    std::scoped_lock lock(_exceptionMutex);
+    if (_exception) {
+      std::rethrow_exception(std::exchange(_exception, nullptr));
+    }
+  }
+
+  const auto queuedAt = Clock::now();
+
+  Frame frame;
+  frame.context   = &frameContext;
+  frame.present   = std::move(present);
+  frame.presented = std::make_shared<std::promise<void>>();
+  frame.queuedAt  = queuedAt;
+  frameContext.setFramePresented(frame.presented->get_future().share());
+
+  const auto pendingFrames = _pendingFrames.fetch_add(1) + 1;
+  _frames.push(std::move(frame));
+
+  const auto blockedTime = Clock::now() - queuedAt;
+  std::scoped_lock lock(_metricsMutex);
+  _metrics.maxQueueDepth = std::max(_metrics.maxQueueDepth, pendingFrames);
+  _metrics.blockedTime += std::chrono::duration_cast<std::chrono::nanoseconds>(blockedTime);
+}
+
+void Presenter::flush() const {
+  MI_VERIFY(std::this_thread::get_id() != _thread.get_id());
+
+  // The present thread notifies once it has presented all the pending frames.
+  for (auto pending = _pendingFrames.load(); pending > 0; pending = _pendingFrames.load()) {
+    _pendingFrames.wait(pending);
+  }
+}
+
+auto Presenter::metrics() const -> Metrics {
+  std::scoped_lock lock(_metricsMutex);
+  Metrics metrics    = _metrics;
+  metrics.queueDepth = _pendingFrames.load();
+  return metrics;
+}
+
+void Presenter::resetMetrics() {
+  std::scoped_lock lock(_metricsMutex);
+  _metrics = {};
+}
+
+void Presenter::run() {
+  while (true) {
+    Frame frame;
+    _frames.pop(frame);
+    if (!frame.context) {
+      return;
+    }
+
+    try {
+      auto frameRendered = frame.present();
+      if (frameRendered) {
+        frame.context->setFrameRendered(frameRendered);
+      }
+    } catch (...) {
+      std::scoped_lock lock(_exceptionMutex);
+      if (!_exception) {
+        _exception = std::current_exception();
+      }
+    }
+    frame.presented->set_value();
+
+    {
+      const auto latency =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - frame.queuedAt);
+
+      std::scoped_lock lock(_metricsMutex);
+      const auto numPresented = static_cast<int64_t>(++_metrics.numPresented);
+      _metrics.lastLatency    = latency;
+      _metrics.averageLatency += (latency - _metrics.averageLatency) / numPresented;
+    }
+
+    if (_pendingFrames.fetch_sub(1) == 1) {
+      _pendingFrames.notify_all();
+    }
+  }
+}
+
+MI_NAMESPACE_END(Vulk)
@@ -0,0 +1,841 @@
+#include <Vulk/engine/RenderGraph.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <utility>
+
+#include <tbb/flow_graph.h>
+
+#include <Vulk/internal/debug.h>
+
+#include <Vulk/Queue.h>
+#include <Vulk/QueuePool.h>
+
+MI_NAMESPACE_BEGIN(Vulk)
+
+namespace {
+
+Device::QueueFamilyType queueFamilyTypeOf(RenderTask::Type type) {
+  switch (type) {
+    case RenderTask::Type::Compute:
+      return Device::QueueFamilyType::Compute;
+    case RenderTask::Type::Transfer:
+      return Device::QueueFamilyType::Transfer;
+    default:
+      return Device::QueueFamilyType::Graphics;
+  }
+}
+
+VkDeviceSize alignUp(VkDeviceSize offset, VkDeviceSize alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+constexpr uint32_t unused = std::numeric_limits<uint32_t>::max();
+
+} // namespace
+
+void RenderGraph::PassBuilder::read(Resource resource,
+                                    VkPipelineStageFlags stages,
+                                    VkAccessFlags access,
+                                    VkImageLayout layout) {
+  _graph.addAccess(_pass, {resource, stages, access, layout, false});
+}
+
+void RenderGraph::PassBuilder::write(Resource resource,
+                                     VkPipelineStageFlags stages,
+                                     VkAccessFlags access,
+                                     VkImageLayout layout) {
+  _graph.addAccess(_pass, {resource, stages, access, layout, true});
+}
+
+RenderGraph::RenderGraph(const DeviceContext& deviceContext) : _deviceContext(deviceContext) {
+}
+
+RenderGraph::~RenderGraph() {
+}
+
+RenderGraph::Resource RenderGraph::createImage(const std::string& name,
+                                               VkFormat format,
+                                               VkExtent2D extent,
+                                               Image2D::Usage usage) {
+  MI_VERIFY(!isCompiled());
+
+  ResourceInfo info;
+  info.name   = name;
+  info.type   = ResourceType::Image;
+  info.format = format;
+  info.extent = extent;
+  info.usage  = usage;
+  _resources.push_back(std::move(info));
+
+  return static_cast<Resource>(_resources.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::createDepthImage(const std::string& name,
+                                                    VkFormat format,
+                                                    VkExtent2D extent) {
+  MI_VERIFY(!isCompiled());
+
+  ResourceInfo info;
+  info.name   = name;
+  info.type   = ResourceType::DepthImage;
+  info.format = format;
+  info.extent = extent;
+  _resources.push_back(std::move(info));
+
+  return static_cast<Resource>(_resources.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::importImage(const std::string& name, const Image& image) {
+  MI_VERIFY(!isCompiled());
+
+  ResourceInfo info;
+  info.name  = name;
+  info.type  = ResourceType::ImportedImage;
+  info.image = image.get_shared();
+  _resources.push_back(std::move(info));
+
+  return static_cast<Resource>(_resources.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::importBuffer(const std::string& name, const Buffer& buffer) {
+  MI_VERIFY(!isCompiled());
+
+  ResourceInfo info;
+  info.name   = name;
+  info.type   = ResourceType::ImportedBuffer;
+  info.buffer = buffer.get_shared();
+  _resources.push_back(std::move(info));
+
+  return static_cast<Resource>(_resources.size() - 1);
+}
+
+void RenderGraph::markOutput(Resource resource) {
+  MI_VERIFY(!isCompiled());
+  MI_VERIFY(resource < _resources.size() && _resources[resource].isTransient());
+  _resources[resource].output = true;
+}
+
+void RenderGraph::addPass(const std::string& name,
+                          RenderTask& task,
+                          const SetupFunc& setup,
+                          PrepareFunc prepare) {
+  MI_VERIFY(!isCompiled());
+
+  _passes.push_back({name, &task, std::move(prepare)});
+
+  PassBuilder builder(*this, static_cast<uint32_t>(_passes.size() - 1));
+  setup(builder);
+}
+
+void RenderGraph::addAccess(uint32_t pass, const Access& access) {
+  MI_VERIFY(access.resource < _resources.size());
+  MI_VERIFY_MSG(access.layout == VK_IMAGE_LAYOUT_UNDEFINED ||
+                    _resources[access.resource].type != ResourceType::ImportedBuffer,
+                "A layout is given for the buffer '%s'",
+                _resources[access.resource].name.c_str());
+  _passes[pass].accesses.push_back(access);
+}
+
+void RenderGraph::compile() {
+  MI_VERIFY(!isCompiled());
+  MI_VERIFY(!_passes.empty());
+
+  schedule();
+  buildBatches();
+  allocateTransientImages();
+  buildBarriers();
+
+  _statistics.numPasses      = static_cast<uint32_t>(_passes.size());
+  _statistics.numSubmissions = static_cast<uint32_t>(_batches.size());
+
+  _compiled = true;
+}
+
+void RenderGraph::schedule() {
+  struct State {
+    std::optional<uint32_t> writer;
+    std::vector<uint32_t> readers;   // Since the last write
+    std::vector<uint32_t> accessors; // All of them
+  };
+  std::vector<State> states(_resources.size());
+
+  // The dependencies follow the order in which the passes are added.
+  for (uint32_t p = 0; p < _passes.size(); ++p) {
+    auto& pass = _passes[p];
+
+    std::set<uint32_t> dependencies;
+    for (const auto& access : pass.accesses) {
+      const auto& state = states[access.resource];
+      if (state.writer) {
+        dependencies.insert(*state.writer);
+      }
+      if (access.write) {
+        dependencies.insert(state.readers.begin(), state.readers.end());
+      }
+      // The transient images are transferred between the queue families in the order of the
+      // passes, so the accesses from another queue are ordered even if they are both reads.
+      if (_resources[access.resource].isTransient()) {
+        for (auto other : state.accessors) {
+          if (_passes[other].task->type() != pass.task->type()) {
+            dependencies.insert(other);
+          }
+        }
+      }
+    }
+    dependencies.erase(p);
+    pass.dependencies.assign(dependencies.begin(), dependencies.end());
+
+    for (const auto& access : pass.accesses) {
+      auto& state = states[access.resource];
+      if (access.write) {
+        state.writer = p;
+        state.readers.clear();
+      } else if (state.writer != p) {
+        state.readers.push_back(p);
+      }
+      state.accessors.push_back(p);
+    }
+  }
+
+  // Topological sort, preferring the queue of the previous pass to extend its submission
+  const auto numPasses = static_cast<uint32_t>(_passes.size());
+
+  std::vector<uint32_t> numPending(numPasses);
+  std::vector<std::vector<uint32_t>> dependents(numPasses);
+  std::set<uint32_t> ready;
+  for (uint32_t p = 0; p < numPasses; ++p) {
+    numPending[p] = static_cast<uint32_t>(_passes[p].dependencies.size());
+    for (auto dependency : _passes[p].dependencies) {
+      dependents[dependency].push_back(p);
+    }
+    if (numPending[p] == 0) {
+      ready.insert(p);
+    }
+  }
+
+  while (!ready.empty()) {
+    auto next = ready.begin();
+    if (!_order.empty()) {
+      const auto type = _passes[_order.back()].task->type();
+      auto sameQueue  = std::find_if(ready.begin(), ready.end(), [&](uint32_t p) {
+        return _passes[p].task->type() == type;
+      });
+      if (sameQueue != ready.end()) {
+        next = sameQueue;
+      }
+    }
+
+    const uint32_t p = *next;
+    ready.erase(next);
+    _order.push_back(p);
+
+    for (auto dependent : dependents[p]) {
+      if (--numPending[dependent] == 0) {
+        ready.insert(dependent);
+      }
+    }
+  }
+  // The dependencies only point to the passes added before, so there is no cycle.
+  MI_VERIFY(_order.size() == numPasses);
+
+  // The lifetimes of the resources in the execution order
+  for (auto& resource : _resources) {
+    resource.first = unused;
+  }
+  for (uint32_t i = 0; i < numPasses; ++i) {
+    for (const auto& access : _passes[_order[i]].accesses) {
+      auto& resource = _resources[access.resource];
+      resource.first = std::min(resource.first, i);
+      resource.last  = std::max(resource.last, i);
+    }
+  }
+  for (auto& resource : _resources) {
+    if (resource.first == unused) {
+      MI_LOG_WARNING("The resource '%s' is not used by any pass", resource.name.c_str());
+      resource.first = 0;
+    }
+    if (resource.output) {
+      resource.last = numPasses; // Beyond the last pass
+    }
+  }
+}
+
+void RenderGraph::buildBatches() {
+  for (auto p : _order) {
+    const auto type = _passes[p].task->type();
+    if (_batches.empty() || _batches.back().type != type) {
+      _batches.push_back({type, {}, {}});
+    }
+    _batches.back().passes.push_back(p);
+    _passes[p].batch = static_cast<uint32_t>(_batches.size() - 1);
+  }
+
+  const auto numBatches = static_cast<uint32_t>(_batches.size());
+
+  std::vector<bool> waited(numBatches, false);
+  for (uint32_t b = 0; b < numBatches; ++b) {
+    std::set<uint32_t> waitBatches;
+    for (auto p : _batches[b].passes) {
+      for (auto dependency : _passes[p].dependencies) {
+        if (_passes[dependency].batch != b) {
+          waitBatches.insert(_passes[dependency].batch);
+        }
+      }
+    }
+    for (auto w : waitBatches) {
+      waited[w] = true;
+    }
+    _batches[b].waitBatches.assign(waitBatches.begin(), waitBatches.end());
+  }
+
+  // The last submission signals the end of the frame, so it waits for the ones nobody waits for.
+  for (uint32_t b = 0; b + 1 < numBatches; ++b) {
+    if (!waited[b]) {
+      _batches.back().waitBatches.push_back(b);
+    }
+  }
+
+  // The transient images used by another queue family are transferred at the batch boundaries.
+  std::vector<std::optional<uint32_t>> lastBatches(_resources.size());
+  for (auto p : _order) {
+    const auto& pass = _passes[p];
+    for (const auto& access : pass.accesses) {
+      if (!_resources[access.resource].isTransient()) {
+        continue;
+      }
+      auto& lastBatch = lastBatches[access.resource];
+      if (lastBatch && *lastBatch != pass.batch &&
+          queueFamilyIndex(_batches[*lastBatch]) != queueFamilyIndex(_batches[pass.batch])) {
+        _transfers.push_back({access.resource, *lastBatch, pass.batch});
+      }
+      lastBatch = pass.batch;
+    }
+  }
+}
+
+void RenderGraph::buildBarriers() {
+  struct State {
+    std::optional<uint32_t> writer;
+    VkPipelineStageFlags writeStages = 0;
+    VkAccessFlags writeAccess        = 0;
+    std::vector<uint32_t> readers; // Since the last write
+  };
+  std::vector<State> states(_resources.size());
+
+  for (uint32_t i = 0; i < _order.size(); ++i) {
+    const uint32_t p = _order[i];
+    auto& pass       = _passes[p];
+
+    // Only the hazards within the submission; the semaphores order the ones between submissions.
+    auto addHazard = [&pass](VkPipelineStageFlags srcStages,
+                             VkAccessFlags srcAccess,
+                             VkPipelineStageFlags dstStages,
+                             VkAccessFlags dstAccess) {
+      pass.srcStages |= srcStages;
+      pass.srcAccess |= srcAccess;
+      pass.dstStages |= dstStages;
+      pass.dstAccess |= dstAccess;
+    };
+
+    for (const auto& access : pass.accesses) {
+      const auto& state = states[access.resource];
+      // Read after write and write after write
+      if (state.writer && *state.writer != p && _passes[*state.writer].batch == pass.batch) {
+        addHazard(state.writeStages, state.writeAccess, access.stages, access.access);
+      }
+      // Write after read only needs an execution dependency.
+      if (access.write) {
+        for (auto reader : state.readers) {
+          if (reader != p && _passes[reader].batch == pass.batch) {
+            addHazard(stagesOf(reader, access.resource), 0, access.stages, 0);
+          }
+        }
+      }
+
+      // The first use of a transient image after the ones in the same memory
+      const auto& resource = _resources[access.resource];
+      if (resource.isTransient() && resource.first == i) {
+        for (auto alias : resource.aliases) {
+          const uint32_t lastPass = _order[_resources[alias].last];
+          if (_passes[lastPass].batch == pass.batch) {
+            addHazard(stagesOf(lastPass, alias), writesOf(lastPass, alias), access.stages, 0);
+          }
+        }
+      }
+    }
+
+    for (const auto& access : pass.accesses) {
+      auto& state = states[access.resource];
+      if (access.write) {
+        if (state.writer != p) {
+          state.writeStages = 0;
+          state.writeAccess = 0;
+        }
+        state.writer = p;
+        state.writeStages |= access.stages;
+        state.writeAccess |= access.access;
+        state.readers.clear();
+      } else if (state.writer != p) {
+        state.readers.push_back(p);
+      }
+    }
+
+    if (pass.dstStages != 0) {
+      ++_statistics.numBarriers;
+    }
+  }
+
+  // A release and an acquire per transfer
+  _statistics.numBarriers += static_cast<uint32_t>(_transfers.size() * 2);
+}
+
+VkPipelineStageFlags RenderGraph::stagesOf(uint32_t pass, Resource resource) const {
+  VkPipelineStageFlags stages = 0;
+  for (const auto& access : _passes[pass].accesses) {
+    if (access.resource == resource) {
+      stages |= access.stages;
+    }
+  }
+  return stages;
+}
+
+VkAccessFlags RenderGraph::writesOf(uint32_t pass, Resource resource) const {
+  VkAccessFlags writes = 0;
+  for (const auto& access : _passes[pass].accesses) {
+    if (access.resource == resource && access.write) {
+      writes |= access.access;
+    }
+  }
+  return writes;
+}
+
+void RenderGraph::allocateTransientImages() {
+  const Device& device = this->device();
+
+  std::vector<Image::shared_ptr> images(_resources.size());
+  std::vector<VkMemoryRequirements> requirements(_resources.size());
+  std::vector<Resource> transients;
+
+  for (Resource r = 0; r < _resources.size(); ++r) {
+    const auto& resource = _resources[r];
+    if (!resource.isTransient()) {
+      continue;
+    }
+    // Created without memory, which is bound below
+    if (resource.type == ResourceType::Image) {
+      images[r] = Image2D::make_shared(device, resource.format, resource.extent, resource.usage);
+    } else {
+      images[r] = DepthImage::make_shared(device, resource.extent, resource.format);
+    }
+    vkGetImageMemoryRequirements(device, *images[r], &requirements[r]);
+
+    _statistics.unaliasedMemory += requirements[r].size;
+    transients.push_back(r);
+  }
+
+  // The largest first, so that the smaller ones fill the gaps
+  std::stable_sort(transients.begin(), transients.end(), [&](Resource a, Resource b) {
+    return requirements[a].size > requirements[b].size;
+  });
+
+  // `earlier` is done with the memory before `later` starts using it: either a barrier orders them
+  // in the same submission, or a chain of semaphores does.
+  auto isOrdered = [this](const ResourceInfo& earlier, const ResourceInfo& later) {
+    if (earlier.last >= later.first) {
+      return false;
+    }
+    const uint32_t from = _passes[_order[earlier.last]].batch;
+    const uint32_t to   = _passes[_order[later.first]].batch;
+    return from == to || isBatchReachable(from, to);
+  };
+  auto canAlias = [&](Resource a, Resource b) {
+    return isOrdered(_resources[a], _resources[b]) || isOrdered(_resources[b], _resources[a]);
+  };
+
+  struct Placement {
+    Resource resource;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+  };
+  struct Heap {
+    uint32_t memoryTypeBits;
+    VkDeviceSize alignment;
+    VkDeviceSize size;
+    std::vector<Placement> placements;
+  };
+  std::vector<Heap> heaps;
+
+  for (auto r : transients) {
+    const auto& requirement = requirements[r];
+
+    // The lowest offset in a heap which doesn't overlap the images in use at the same time
+    std::optional<std::pair<size_t, VkDeviceSize>> best;
+    VkDeviceSize bestGrowth = requirement.size;
+    for (size_t h = 0; h < heaps.size(); ++h) {
+      const auto& heap = heaps[h];
+      if ((heap.memoryTypeBits & requirement.memoryTypeBits) == 0) {
+        continue;
+      }
+
+      std::set<VkDeviceSize> offsets = {0};
+      for (const auto& placement : heap.placements) {
+        offsets.insert(alignUp(placement.offset + placement.size, requirement.alignment));
+      }
+      for (auto offset : offsets) {
+        const bool overlapped =
+            std::any_of(heap.placements.begin(), heap.placements.end(), [&](const auto& other) {
+              return offset < other.offset + other.size &&
+                     other.offset < offset + requirement.size && !canAlias(other.resource, r);
+            });
+        if (overlapped) {
+          continue;
+        }
+        const VkDeviceSize end    = offset + requirement.size;
+        const VkDeviceSize growth = end > heap.size ? end - heap.size : 0;
+        if (growth < bestGrowth) {
+          best       = {h, offset};
+          bestGrowth = growth;
+        }
+        break; // The growth only increases with the offset
+      }
+    }
+
+    if (!best) {
+      heaps.push_back({requirement.memoryTypeBits, requirement.alignment, 0, {}});
+      best = {heaps.size() - 1, 0};
+    }
+
+    auto& heap                = heaps[best->first];
+    const VkDeviceSize offset = best->second;
+    for (const auto& other : heap.placements) {
+      if (offset < other.offset + other.size && other.offset < offset + requirement.size) {
+        if (_resources[other.resource].last < _resources[r].first) {
+          _resources[r].aliases.push_back(other.resource);
+        } else {
+          _resources[other.resource].aliases.push_back(r);
+        }
+      }
+    }
+    heap.placements.push_back({r, offset, requirement.size});
+    heap.memoryTypeBits &= requirement.memoryTypeBits;
+    heap.alignment = std::max(heap.alignment, requirement.alignment);
+    heap.size      = std::max(heap.size, offset + requirement.size);
+  }
+
+  for (const auto& heap : heaps) {
+    const VkMemoryRequirements requirement{heap.size, heap.alignment, heap.memoryTypeBits};
+    auto memory = DeviceMemory::make_shared(
+        device, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, requirement);
+    for (const auto& placement : heap.placements) {
+      images[placement.resource]->bind(*memory, placement.offset);
+    }
+    _statistics.transientMemory += heap.size;
+    _memories.push_back(memory);
+  }
+
+  for (auto r : transients) {
+    _resources[r].image = images[r];
+  }
+}
+
+bool RenderGraph::isBatchReachable(uint32_t from, uint32_t to) const {
+  std::vector<bool> visited(_batches.size(), false);
+  std::vector<uint32_t> pending = {to};
+  while (!pending.empty()) {
+    const uint32_t b = pending.back();
+    pending.pop_back();
+    for (auto w : _batches[b].waitBatches) {
+      if (w == from) {
+        return true;
+      }
+      if (!visited[w]) {
+        visited[w] = true;
+        pending.push_back(w);
+      }
+    }
+  }
+  return false;
+}
+
+uint32_t RenderGraph::queueFamilyIndex(const Batch& batch) const {
+  return device().queueFamilyIndex(queueFamilyTypeOf(batch.type)).value();
+}
+
+std::pair<Semaphore::shared_ptr, Fence::shared_ptr> RenderGraph::execute(
+    FrameContext& frameContext,
+    const std::vector<Semaphore::shared_ptr>& waits) {
+  MI_VERIFY(isCompiled());
+
+  const Device& device = this->device();
+
+  // The previous frame is done with the transient images; the outputs have been consumed by now.
+  for (const auto& resource : _resources) {
+    if (resource.isTransient()) {
+      resource.image->discardContent();
+    }
+  }
+
+  // A semaphore for each dependency between the submissions, by (signaling, waiting) batches
+  std::map<std::pair<uint32_t, uint32_t>, Semaphore::shared_ptr> semaphores;
+  for (uint32_t b = 0; b < _batches.size(); ++b) {
+    for (auto w : _batches[b].waitBatches) {
+      semaphores[{w, b}] = frameContext.acquireSemaphore();
+    }
+  }
+  auto finished = frameContext.acquireSemaphore();
+  auto fence    = frameContext.acquireFence();
+
+  const auto commandBuffers = _parallelRecording ? recordInParallel(frameContext)
+                                                 : recordInSequence(frameContext);
+
+  for (uint32_t b = 0; b < _batches.size(); ++b) {
+    const auto& batch = _batches[b];
+
+    std::vector<Semaphore*> batchWaits;
+    if (b == 0) {
+      for (const auto& wait : waits) {
+        batchWaits.push_back(wait.get());
+      }
+    }
+    for (auto w : batch.waitBatches) {
+      batchWaits.push_back(semaphores[{w, b}].get());
+    }
+
+    std::vector<Semaphore*> batchSignals;
+    for (const auto& [edge, semaphore] : semaphores) {
+      if (edge.first == b) {
+        batchSignals.push_back(semaphore.get());
+      }
+    }
+
+    const bool isLast = b + 1 == _batches.size();
+    if (isLast) {
+      batchSignals.push_back(finished.get());
+    }
+    const Fence noFence;
+    const Fence& batchFence = isLast ? *fence : noFence;
+
+    std::vector<const CommandBuffer*> batchCommandBuffers;
+    for (const auto& commandBuffer : commandBuffers[b]) {
+      batchCommandBuffers.push_back(commandBuffer.get());
+    }
+
+    const Queue& queue = batch.type == RenderTask::Type::Compute
+                             ? device.queuePool().queue(QueuePool::Workload::AsyncCompute)
+                             : commandBuffers[b].front()->queue();
+    queue.submitCommands(batchCommandBuffers, batchWaits, batchSignals, batchFence);
+  }
+
+  return {finished, fence};
+}
+
+std::vector<std::vector<CommandBuffer::shared_ptr>> RenderGraph::recordInSequence(
+    FrameContext& frameContext) const {
+  std::vector<std::vector<CommandBuffer::shared_ptr>> commandBuffers(_batches.size());
+
+  for (uint32_t b = 0; b < _batches.size(); ++b) {
+    const auto& batch = _batches[b];
+
+    auto commandBuffer = frameContext.acquireCommandBuffer(queueFamilyTypeOf(batch.type));
+    commandBuffer->beginRecording();
+    {
+      recordAcquires(b, *commandBuffer);
+      for (auto p : batch.passes) {
+        recordBarriers(_passes[p], *commandBuffer);
+        recordPass(_passes[p], frameContext, commandBuffer);
+      }
+      recordReleases(b, *commandBuffer);
+    }
+    commandBuffer->endRecording();
+
+    commandBuffers[b].push_back(commandBuffer);
+  }
+
+  return commandBuffers;
+}
+
+std::vector<std::vector<CommandBuffer::shared_ptr>> RenderGraph::recordInParallel(
+    FrameContext& frameContext) const {
+  const auto numPasses = static_cast<uint32_t>(_passes.size());
+
+  // The commands of the graph are recorded first on this thread in the execution order, as they
+  // follow the layouts of the images. They go into their own command buffers around the ones of
+  // the passes.
+  std::vector<CommandBuffer::shared_ptr> barriers(numPasses);
+  std::vector<CommandBuffer::shared_ptr> releases(_batches.size());
+  for (uint32_t b = 0; b < _batches.size(); ++b) {
+    const auto& batch      = _batches[b];
+    const auto queueFamily = queueFamilyTypeOf(batch.type);
+
+    bool hasAcquires = false;
+    bool hasReleases = false;
+    for (const auto& transfer : _transfers) {
+      hasAcquires |= transfer.dstBatch == b;
+      hasReleases |= transfer.srcBatch == b;
+    }
+
+    for (auto p : batch.passes) {
+      const bool isFirst = p == batch.passes.front();
+      if ((isFirst && hasAcquires) || hasBarriers(_passes[p])) {
+        barriers[p] = frameContext.acquireCommandBuffer(queueFamily);
+        barriers[p]->beginRecording();
+        if (isFirst) {
+          recordAcquires(b, *barriers[p]);
+        }
+        recordBarriers(_passes[p], *barriers[p]);
+        barriers[p]->endRecording();
+      }
+    }
+    if (hasReleases) {
+      releases[b] = frameContext.acquireCommandBuffer(queueFamily);
+      releases[b]->beginRecording();
+      recordReleases(b, *releases[b]);
+      releases[b]->endRecording();
+    }
+  }
+
+  // The passes are prepared and recorded by the TBB threads as soon as the passes they depend on
+  // are, each into a command buffer of its thread.
+  std::vector<CommandBuffer::shared_ptr> passes(numPasses);
+
+  tbb::flow::graph flowGraph;
+  std::vector<std::unique_ptr<tbb::flow::continue_node<tbb::flow::continue_msg>>> nodes;
+  nodes.reserve(numPasses);
+  for (uint32_t p = 0; p < numPasses; ++p) {
+    nodes.push_back(std::make_unique<tbb::flow::continue_node<tbb::flow::continue_msg>>(
+        flowGraph, [&, p](const tbb::flow::continue_msg&) {
+          const auto& pass       = _passes[p];
+          const auto queueFamily = queueFamilyTypeOf(pass.task->type());
+
+          auto commandBuffer = frameContext.acquireCommandBuffer(queueFamily);
+          commandBuffer->beginRecording();
+          recordPass(pass, frameContext, commandBuffer);
+          commandBuffer->endRecording();
+          passes[p] = commandBuffer;
+        }));
+  }
+
+  // A task keeps the state of a pass until its `run()`, so the passes of a task are serialized.
+  std::vector<std::set<uint32_t>> predecessors(numPasses);
+  std::map<const RenderTask*, uint32_t> lastPassOfTask;
+  for (auto p : _order) {
+    predecessors[p].insert(_passes[p].dependencies.begin(), _passes[p].dependencies.end());
+    if (auto it = lastPassOfTask.find(_passes[p].task); it != lastPassOfTask.end()) {
+      predecessors[p].insert(it->second);
+    }
+    lastPassOfTask[_passes[p].task] = p;
+  }
+  for (uint32_t p = 0; p < numPasses; ++p) {
+    for (auto predecessor : predecessors[p]) {
+      tbb::flow::make_edge(*nodes[predecessor], *nodes[p]);
+    }
+  }
+  for (uint32_t p = 0; p < numPasses; ++p) {
+    if (predecessors[p].empty()) {
+      nodes[p]->try_put(tbb::flow::continue_msg());
+    }
+  }
+  flowGraph.wait_for_all();
+
+  // Joined in the execution order
+  std::vector<std::vector<CommandBuffer::shared_ptr>> commandBuffers(_batches.size());
+  for (uint32_t b = 0; b < _batches.size(); ++b) {
+    for (auto p : _batches[b].passes) {
+      if (barriers[p]) {
+        commandBuffers[b].push_back(barriers[p]);
+      }
+      commandBuffers[b].push_back(passes[p]);
+    }
+    if (releases[b]) {
+      commandBuffers[b].push_back(releases[b]);
+    }
+  }
+
+  return commandBuffers;
+}
+
+void RenderGraph::recordAcquires(uint32_t batch, const CommandBuffer& commandBuffer) const {
+  for (const auto& transfer : _transfers) {
+    if (transfer.dstBatch == batch) {
+      image(transfer.resource)
+          .acquireOwnership(commandBuffer, queueFamilyIndex(_batches[transfer.srcBatch]));
+    }
+  }
+}
+
+void RenderGraph::recordReleases(uint32_t batch, const CommandBuffer& commandBuffer) const {
+  for (const auto& transfer : _transfers) {
+    if (transfer.srcBatch == batch) {
+      const auto& transferred = image(transfer.resource);
+      transferred.releaseOwnership(
+          commandBuffer, transferred.layout(), queueFamilyIndex(_batches[transfer.dstBatch]));
+    }
+  }
+}
+
+bool RenderGraph::hasBarriers(const Pass& pass) const {
+  if (pass.dstStages != 0) {
+    return true;
+  }
+  return std::any_of(pass.accesses.begin(), pass.accesses.end(), [this](const Access& access) {
+    return access.layout != VK_IMAGE_LAYOUT_UNDEFINED &&
+           image(access.resource).layout() != access.layout;
+  });
+}
+
+void RenderGraph::recordBarriers(const Pass& pass, const CommandBuffer& commandBuffer) const {
+  if (pass.dstStages != 0) {
+    commandBuffer.memoryBarrier(pass.srcStages, pass.srcAccess, pass.dstStages, pass.dstAccess);
+  }
+  for (const auto& access : pass.accesses) {
+    if (access.layout != VK_IMAGE_LAYOUT_UNDEFINED &&
+        image(access.resource).layout() != access.layout) {
+      image(access.resource).transitToNewLayout(commandBuffer, access.layout);
+    }
+  }
+}
+
+void RenderGraph::recordPass(const Pass& pass,
+                             FrameContext& frameContext,
+                             const CommandBuffer::shared_ptr& commandBuffer) const {
+  auto label = commandBuffer->scopedLabel(pass.name.c_str());
+
+  pass.task->setFrameContext(frameContext, commandBuffer);
+  if (pass.prepare) {
+    pass.prepare(*this);
+  }
+  // The task only records into the command buffer of the graph, which submits it; the returned
+  // semaphore and fence are never signaled.
+  [[maybe_unused]] auto unsubmitted = pass.task->run();
+  MI_VERIFY_MSG(commandBuffer->state() == CommandBuffer::State::Recording,
+                "The pass '%s' ended the recording of the graph",
+                pass.name.c_str());
+}
+
+const Image& RenderGraph::image(Resource resource) const {
+  MI_VERIFY(resource < _resources.size() && _resources[resource].image);
+  return *_resources[resource].image;
+}
+
+const Image2D& RenderGraph::image2D(Resource resource) const {
+  MI_VERIFY(resource < _resources.size() && _resources[resource].type == ResourceType::Image);
+  return static_cast<const Image2D&>(image(resource));
+}
+
+const DepthImage& RenderGraph::depthImage(Resource resource) const {
+  MI_VERIFY(resource < _resources.size() &&
+            _resources[resource].type == ResourceType::DepthImage);
+  return static_cast<const DepthImage&>(image(resource));
+}
+
+const Buffer& RenderGraph::buffer(Resource resource) const {
+  MI_VERIFY(resource < _resources.size() && _resources[resource].buffer);
+  return *_resources[resource].buffer;
+}
+
+MI_NAMESPACE_END(Vulk)
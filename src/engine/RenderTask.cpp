@@ -1,5 +1,7 @@
 #include <Vulk/engine/RenderTask.h>
 
+#include <utility>
+
 #include <Vulk/internal/debug.h>
 
 MI_NAMESPACE_BEGIN(Vulk)
@@ -10,9 +12,15 @@ RenderTask::RenderTask(const DeviceContext& deviceContext, Type type)
     : _deviceContext(deviceContext), _type(type), _id(_nextId++) {
 }
 
-void RenderTask::setFrameContext(FrameContext& frameContext) {
+void RenderTask::setFrameContext(FrameContext& frameContext,
+                                 CommandBuffer::shared_ptr commandBuffer) {
   _frameContext = &frameContext;
 
+  if (commandBuffer) {
+    _commandBuffer = std::move(commandBuffer);
+    return;
+  }
+
   switch (_type)
   {
   case Type::Graphics:
@@ -29,4 +37,24 @@ void RenderTask::setFrameContext(FrameContext& frameContext) {
   }
 }
 
+void RenderTask::prepareTimestamps(const QueryPool* queryPool, uint32_t firstQuery) {
+  _timestamps     = queryPool ? queryPool->get_shared() : nullptr;
+  _firstTimestamp = firstQuery;
+}
+
+void RenderTask::writeBeginTimestamp() const {
+  if (_timestamps) {
+    _timestamps->reset(*_commandBuffer, _firstTimestamp, 2);
+    _timestamps->writeTimestamp(
+        *_commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _firstTimestamp);
+  }
+}
+
+void RenderTask::writeEndTimestamp() const {
+  if (_timestamps) {
+    _timestamps->writeTimestamp(
+        *_commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _firstTimestamp + 1);
+  }
+}
+
 MI_NAMESPACE_END(Vulk)
\ No newline at end of file
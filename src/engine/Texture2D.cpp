@@ -1,5 +1,7 @@
 #include <Vulk/engine/Texture2D.h>
 
+#include <Vulk/internal/debug.h>
+
 #include <Vulk/Device.h>
 #include <Vulk/Queue.h>
 #include <Vulk/CommandBuffer.h>
@@ -15,6 +17,10 @@ Texture2D::Texture2D(const Device& device,
   create(device, format, extent, usage, filter, addressMode);
 }
 
+Texture2D::~Texture2D() {
+  unregister();
+}
+
 void Texture2D::create(const Device& device,
                        VkFormat format,
                        VkExtent2D extent,
@@ -29,11 +35,30 @@ void Texture2D::create(const Device& device,
 }
 
 void Texture2D::destroy() {
+  unregister();
+
   _sampler.reset();
   _view.reset();
   _image.reset();
 }
 
+BindlessTextureTable::Slot Texture2D::registerTo(BindlessTextureTable& table) {
+  MI_VERIFY(isCreated());
+  MI_VERIFY_MSG(!isRegistered(), "The texture is already registered to a bindless texture table.");
+
+  _bindlessSlot  = table.add(*this);
+  _bindlessTable = table.get_weak();
+  return _bindlessSlot;
+}
+
+void Texture2D::unregister() {
+  if (auto table = _bindlessTable.lock()) {
+    table->remove(*this);
+  }
+  _bindlessTable.reset();
+  _bindlessSlot = {};
+}
+
 void Texture2D::copyFrom(const CommandBuffer& commandBuffer,
                          const StagingBuffer& stagingBuffer,
                          const std::vector<Semaphore*>& waits,
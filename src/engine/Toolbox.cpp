@@ -3,9 +3,13 @@
 #include <Vulk/CommandBuffer.h>
 #include <Vulk/CommandPool.h>
 #include <Vulk/Device.h>
+#include <Vulk/Queue.h>
+#include <Vulk/QueuePool.h>
 #include <Vulk/StagingBuffer.h>
 #include <Vulk/internal/debug.h>
 
+#include <cstring>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
@@ -23,19 +27,7 @@ Image2D::shared_ptr Toolbox::createImage2D(const char* imageFile) const {
 
   image->allocate();
 
-  const auto& commandPool                 = device.commandPool(Device::QueueFamilyType::Transfer);
-  CommandBuffer::shared_ptr commandBuffer = CommandBuffer::make_shared(commandPool);
-  Fence::shared_ptr fence                 = Fence::make_shared(device);
-
-  commandBuffer->beginRecording(CommandBuffer::Usage::OneTimeSubmit);
-  {
-    image->copyFrom(*commandBuffer, *stagingBuffer);
-    image->transitToNewLayout(*commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-  }
-  commandBuffer->endRecording();
-  commandBuffer->submitCommands(*fence);
-
-  fence->wait();
+  upload(*image, *stagingBuffer);
 
   return image;
 }
@@ -49,13 +41,7 @@ Texture2D::shared_ptr Toolbox::createTexture2D(const char* textureFile) const {
                                         VkExtent2D{width, height},
                                         Image2D::Usage::TRANSFER_DST);
 
-  const auto& commandPool                 = device.commandPool(Device::QueueFamilyType::Transfer);
-  CommandBuffer::shared_ptr commandBuffer = CommandBuffer::make_shared(commandPool);
-  Fence::shared_ptr fence                 = Fence::make_shared(device);
-
-  texture->copyFrom(*commandBuffer, *stagingBuffer, *fence);
-
-  fence->wait();
+  upload(texture->image(), *stagingBuffer);
 
   return texture;
 }
@@ -64,25 +50,77 @@ Texture2D::shared_ptr Toolbox::createTexture2D(TextureFormat format,
                                                const uint8_t* data,
                                                uint32_t width,
                                                uint32_t height) const {
-  const auto& device = _context.device();
-
   const uint32_t size = width * height * (format == TextureFormat::RGBA ? 4 : 3);
   auto stagingBuffer  = createStagingBuffer(data, size);
 
+  return createTexture2D(format, *stagingBuffer, width, height);
+}
+
+Texture2D::shared_ptr Toolbox::createTexture2D(TextureFormat format,
+                                               const MappedFile& file,
+                                               size_t offset,
+                                               uint32_t width,
+                                               uint32_t height) const {
+  const size_t size  = size_t{width} * height * (format == TextureFormat::RGBA ? 4 : 3);
+  auto stagingBuffer = createStagingBuffer(file, offset, size);
+
+  return createTexture2D(format, *stagingBuffer, width, height);
+}
+
+Texture2D::shared_ptr Toolbox::createTexture2D(TextureFormat format,
+                                               const StagingBuffer& stagingBuffer,
+                                               uint32_t width,
+                                               uint32_t height) const {
+  const auto& device = _context.device();
+
   const auto vkFormat =
       format == TextureFormat::RGBA ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8_SRGB;
   auto texture = Texture2D::make_shared(
-      _context.device(), vkFormat, VkExtent2D{width, height}, Image2D::Usage::TRANSFER_DST);
+      device, vkFormat, VkExtent2D{width, height}, Image2D::Usage::TRANSFER_DST);
+
+  upload(texture->image(), stagingBuffer);
+
+  return texture;
+}
+
+void Toolbox::upload(Image& image, const StagingBuffer& stagingBuffer) const {
+  const auto& device = _context.device();
+
+  const auto& transferQueue      = device.queuePool().queue(QueuePool::Workload::Streaming);
+  const auto graphicsQueueFamily = device.queueFamilyIndex(Device::QueueFamilyType::Graphics);
 
   const auto& commandPool                 = device.commandPool(Device::QueueFamilyType::Transfer);
   CommandBuffer::shared_ptr commandBuffer = CommandBuffer::make_shared(commandPool);
   Fence::shared_ptr fence                 = Fence::make_shared(device);
 
-  texture->copyFrom(*commandBuffer, *stagingBuffer, *fence);
+  // The image is sampled by the graphics queue. The transition to the sampling layout is folded
+  // into the ownership transfer.
+  const uint32_t ownerQueueFamily = graphicsQueueFamily.value_or(transferQueue.queueFamilyIndex());
+  commandBuffer->beginRecording(CommandBuffer::Usage::OneTimeSubmit);
+  {
+    image.copyFrom(*commandBuffer, stagingBuffer);
+    image.releaseOwnership(
+        *commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, ownerQueueFamily);
+  }
+  commandBuffer->endRecording();
+
+  if (ownerQueueFamily == transferQueue.queueFamilyIndex()) {
+    commandBuffer->submitCommandsTo(transferQueue, {}, {}, *fence);
+    fence->wait();
+    return;
+  }
 
-  fence->wait();
+  Semaphore::shared_ptr copied = Semaphore::make_shared(device);
+  commandBuffer->submitCommandsTo(transferQueue, {}, {copied.get()});
 
-  return texture;
+  const auto& graphicsCommandPool       = device.commandPool(Device::QueueFamilyType::Graphics);
+  CommandBuffer::shared_ptr acquisition = CommandBuffer::make_shared(graphicsCommandPool);
+  acquisition->recordCommands([&](const CommandBuffer& buffer) {
+    image.acquireOwnership(buffer, transferQueue.queueFamilyIndex());
+  });
+  acquisition->submitCommands({copied.get()}, {}, *fence);
+
+  fence->wait();
 }
 
 auto Toolbox::createStagingBuffer(const char* imageFile) const
@@ -91,7 +129,16 @@ auto Toolbox::createStagingBuffer(const char* imageFile) const
   int texHeight   = 0;
   int texChannels = 0;
 
-  stbi_uc* pixels = stbi_load(imageFile, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+  // Decode from the file mapping to avoid a heap copy of the encoded file.
+  MappedFile file{imageFile, MappedFile::Access::Sequential};
+  MI_VERIFY_MSG(file.isOpen(), "Failed to open file '%s'", imageFile);
+
+  stbi_uc* pixels = stbi_load_from_memory(file.data(),
+                                          static_cast<int>(file.size()),
+                                          &texWidth,
+                                          &texHeight,
+                                          &texChannels,
+                                          STBI_rgb_alpha);
   MI_VERIFY(pixels != nullptr);
 
   auto imageSize = static_cast<VkDeviceSize>(texWidth * texHeight * 4);
@@ -107,4 +154,22 @@ StagingBuffer::shared_ptr Toolbox::createStagingBuffer(const uint8_t* data, uint
   return StagingBuffer::make_shared(_context.device(), size, data);
 }
 
+StagingBuffer::shared_ptr Toolbox::createStagingBuffer(const MappedFile& file,
+                                                       size_t offset,
+                                                       size_t size) const {
+  constexpr size_t streamingChunkSize = 16 * 1024 * 1024;
+
+  MI_VERIFY(offset + size <= file.size());
+
+  auto stagingBuffer = StagingBuffer::make_shared(_context.device(), size);
+  auto* dst          = stagingBuffer->mappedData();
+
+  auto copyChunk = [dst](size_t chunkOffset, const uint8_t* data, size_t chunkSize) {
+    std::memcpy(dst + chunkOffset, data, chunkSize);
+  };
+  file.forEachChunk(streamingChunkSize, offset, size, copyChunk);
+
+  return stagingBuffer;
+}
+
 MI_NAMESPACE_END(Vulk)
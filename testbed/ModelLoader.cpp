@@ -0,0 +1,97 @@
+#include "ModelLoader.h"
+
+#include <Vulk/engine/MeshImporter.h>
+#include <Vulk/engine/MeshOptimizer.h>
+
+#include <cstdio>
+#include <stdexcept>
+
+void ModelLoader::loadObj(const std::filesystem::path& objFile,
+                          std::vector<Vertex>& vertices,
+                          std::vector<Index>& indices) {
+  if (!Vulk::MeshImporter::importObj(objFile, vertices, indices)) {
+    throw std::runtime_error("Failed to load model " + objFile.string());
+  }
+}
+
+void ModelLoader::convert(const std::filesystem::path& objFile,
+                          const std::filesystem::path& meshFile,
+                          uint64_t sourceKey,
+                          bool optimize) {
+  std::vector<Vertex> vertices;
+  std::vector<Index> indices;
+  loadObj(objFile, vertices, indices);
+
+  const auto bbox = bboxOf(vertices);
+
+  if (!optimize) {
+    const auto packed = Vulk::MeshImporter::quantize(vertices, bbox);
+    Vulk::MeshFile::write(meshFile.string(), packed, indices, bbox, sourceKey);
+    return;
+  }
+
+  Vulk::MeshOptimizer::Statistics stats;
+  Vulk::MeshOptimizer::optimize(vertices, indices, &stats);
+
+  const bool narrow = Vulk::MeshOptimizer::canNarrow(vertices.size());
+  const auto packed = Vulk::MeshImporter::quantize(vertices, bbox);
+
+  // Printed in all builds, e.g. by the MeshConverter tool
+  std::printf("Optimized %s: ACMR %.3f -> %.3f, %d-bit indices, %zu-byte vertices, "
+              "%zu unreferenced vertices removed\n",
+              objFile.filename().string().c_str(),
+              stats.acmrBefore,
+              stats.acmrAfter,
+              narrow ? 16 : 32,
+              sizeof(PackedVertex),
+              stats.numUnreferencedVertices);
+
+  if (narrow) {
+    const auto narrowed = Vulk::MeshOptimizer::narrow(indices);
+    Vulk::MeshFile::write(meshFile.string(), packed, narrowed, bbox, sourceKey);
+  } else {
+    Vulk::MeshFile::write(meshFile.string(), packed, indices, bbox, sourceKey);
+  }
+}
+
+Vulk::MeshFile::shared_ptr ModelLoader::load(const std::filesystem::path& modelFile) {
+  auto meshFile = Vulk::MeshFile::make_shared();
+
+  if (modelFile.extension() == Vulk::MeshFile::EXTENSION) {
+    if (!meshFile->open(modelFile.string())) {
+      throw std::runtime_error("Failed to open mesh file " + modelFile.string());
+    }
+    return meshFile;
+  }
+
+  const auto sourceKey = Vulk::MeshFile::sourceKey(modelFile);
+  const auto cacheFile = Vulk::MeshFile::cachePath(modelFile, cacheDir());
+
+  if (meshFile->open(cacheFile.string())) {
+    if (meshFile->sourceKey() == sourceKey) {
+      return meshFile;
+    }
+    // The source has been modified since it was cached.
+    meshFile->close();
+  }
+
+  std::filesystem::create_directories(cacheFile.parent_path());
+  convert(modelFile, cacheFile, sourceKey);
+
+  if (!meshFile->open(cacheFile.string())) {
+    throw std::runtime_error("Failed to cache model " + modelFile.string());
+  }
+  return meshFile;
+}
+
+auto ModelLoader::bboxOf(const std::vector<Vertex>& vertices) -> BBox {
+  auto bbox = BBox::null();
+  for (const auto& vertex : vertices) {
+    bbox += vertex.pos;
+  }
+  return bbox;
+}
+
+std::filesystem::path ModelLoader::cacheDir() {
+  return std::filesystem::temp_directory_path() / "Vulk" / "meshes";
+}
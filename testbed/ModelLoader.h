@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Vulk/engine/MeshFile.h>
+#include <Vulk/engine/MeshImporter.h>
+
+#include <filesystem>
+#include <vector>
+
+//
+// Loads models for the testbed apps. Models are converted once to the binary mesh format and
+// cached so subsequent loads are a single mmap plus upload.
+//
+class ModelLoader {
+ public:
+  using Vertex       = Vulk::MeshImporter::Vertex;
+  using PackedVertex = Vulk::MeshImporter::PackedVertex;
+  using Index        = Vulk::MeshImporter::Index;
+  using BBox         = Vulk::MeshFile::BBox;
+
+ public:
+  // Parse an OBJ file and deduplicate its vertices.
+  static void loadObj(const std::filesystem::path& objFile,
+                      std::vector<Vertex>& vertices,
+                      std::vector<Index>& indices);
+
+  // Convert an OBJ file to a binary mesh file of `PackedVertex`. If `optimize` is true, the mesh is
+  // optimized for vertex cache and fetch efficiency and the indices are narrowed to 16 bits when
+  // possible.
+  static void convert(const std::filesystem::path& objFile,
+                      const std::filesystem::path& meshFile,
+                      uint64_t sourceKey = 0,
+                      bool optimize      = true);
+
+  // Open the binary mesh of `modelFile`. A binary mesh file is opened directly. Other files are
+  // converted into the cache on the first load or when the source has changed since.
+  static Vulk::MeshFile::shared_ptr load(const std::filesystem::path& modelFile);
+
+  [[nodiscard]] static BBox bboxOf(const std::vector<Vertex>& vertices);
+
+  [[nodiscard]] static std::filesystem::path cacheDir();
+};
@@ -5,10 +5,14 @@
 #include <Vulk/CommandBuffer.h>
 #include <Vulk/VertexShader.h>
 #include <Vulk/FragmentShader.h>
+#include <Vulk/ComputeShader.h>
 #include <Vulk/Exception.h>
+#include <Vulk/ImageViewCache.h>
+#include <Vulk/FramebufferCache.h>
 
 #include <Vulk/internal/debug.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <cstring>
 
@@ -22,6 +26,37 @@ std::filesystem::path executablePath() {
   return std::filesystem::path{};
 }
 #endif
+
+std::string shaderFile(const char* name) {
+  return (executablePath() / "shaders" / name).string();
+}
+
+// Blit the whole `src` into the `dstOffset`/`dstExtent` rectangle of `dst`. The images have to be
+// in the transfer layouts.
+void blit(const Vulk::CommandBuffer& commandBuffer,
+          const Vulk::Image& src,
+          const Vulk::Image& dst,
+          VkOffset2D dstOffset,
+          VkExtent2D dstExtent) {
+  VkImageBlit region{};
+  region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+  region.srcOffsets[1]  = {
+      static_cast<int32_t>(src.width()), static_cast<int32_t>(src.height()), 1};
+  region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+  region.dstOffsets[0]  = {dstOffset.x, dstOffset.y, 0};
+  region.dstOffsets[1]  = {dstOffset.x + static_cast<int32_t>(dstExtent.width),
+                           dstOffset.y + static_cast<int32_t>(dstExtent.height),
+                           1};
+
+  vkCmdBlitImage(commandBuffer,
+                 src,
+                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                 dst,
+                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 1,
+                 &region,
+                 VK_FILTER_LINEAR);
+}
 } // namespace
 
 MI_NAMESPACE_BEGIN(Vulk)
@@ -30,7 +65,32 @@ MI_NAMESPACE_BEGIN(Vulk)
 //
 //
 TextureMappingTask::TextureMappingTask(const DeviceContext& deviceContext)
+    : TextureMappingTask(deviceContext, {}, {}) {
+}
+
+TextureMappingTask::TextureMappingTask(
+    const DeviceContext& deviceContext,
+    const VkVertexInputBindingDescription& vertexBinding,
+    const std::vector<VkVertexInputAttributeDescription>& vertexAttributes)
     : RenderTask(deviceContext, Type::Graphics) {
+  create(vertexBinding, vertexAttributes);
+}
+
+TextureMappingTask::TextureMappingTask(
+    const DeviceContext& deviceContext,
+    const VkVertexInputBindingDescription& vertexBinding,
+    const std::vector<VkVertexInputAttributeDescription>& vertexAttributes,
+    const BindlessTextureTable& table)
+    : RenderTask(deviceContext, Type::Graphics), _textureTable(table.get_shared()) {
+  create(vertexBinding, vertexAttributes);
+}
+
+TextureMappingTask::~TextureMappingTask() {
+}
+
+void TextureMappingTask::create(
+    const VkVertexInputBindingDescription& vertexBinding,
+    const std::vector<VkVertexInputAttributeDescription>& vertexAttributes) {
   // Create render pass
   const VkFormat colorFormat        = VK_FORMAT_B8G8R8A8_SRGB;
   const VkFormat depthStencilFormat = VK_FORMAT_D24_UNORM_S8_UINT;
@@ -39,18 +99,34 @@ TextureMappingTask::TextureMappingTask(const DeviceContext& deviceContext)
   // Create pipeline
   auto vertShaderFile = executablePath() / "shaders/textureMapping.vert.spv";
   VertexShader vertShader{device(), vertShaderFile.string().c_str()};
-  auto fragShaderFile = executablePath() / "shaders/textureMapping.frag.spv";
+  if (!vertexAttributes.empty()) {
+    vertShader.overrideVertexInputLayout(vertexBinding, vertexAttributes);
+  }
+  const char* fragShaderName = _textureTable ? "shaders/textureMappingBindless.frag.spv"
+                                             : "shaders/textureMapping.frag.spv";
+  auto fragShaderFile        = executablePath() / fragShaderName;
   FragmentShader fragShader{device(), fragShaderFile.string().c_str()};
-  _pipeline = Pipeline::make_shared(device(), *_renderPass, vertShader, fragShader);
+
+  Pipeline::Configuration config{};
+  if (_textureTable) {
+    config.externalSetLayouts[BindlessTextureTable::kSet] = _textureTable->layout();
+  }
+  _pipeline = Pipeline::make_shared(device(), *_renderPass, vertShader, fragShader, config);
+
+  // The names and the types need to match the bindings in the shaders.
+  if (const auto& updateTemplate = _pipeline->descriptorUpdateTemplate()) {
+    _infos.resize(updateTemplate->numBindings());
+    _transformationBinding = updateTemplate->index("xform", "Transformation");
+    if (!_textureTable) {
+      _textureBinding = updateTemplate->index("texSampler", "sampler2D");
+    }
+  }
 
   // For now, we only have one vertex buffer binding (hence, 0 indexed). Check
   // `ShaderModule::reflectVertexInputs` to see how `_vertexInputBindings` are reflected.
   _vertexBufferBinding = 0U;
 }
 
-TextureMappingTask::~TextureMappingTask() {
-}
-
 void TextureMappingTask::prepareGeometry(const VertexBuffer& vertexBuffer,
                                          const IndexBuffer& indexBuffer,
                                          size_t numIndices) {
@@ -74,6 +150,8 @@ void TextureMappingTask::prepareUniforms(const glm::mat4& model2world,
 }
 
 void TextureMappingTask::prepareInputs(const Texture2D& texture) {
+  MI_VERIFY_MSG(!_textureTable || texture.isRegistered(),
+                "The texture isn't registered to the bindless texture table.");
   _texture = texture.get_shared();
 }
 
@@ -97,44 +175,35 @@ std::pair<Semaphore::shared_ptr, Fence::shared_ptr> TextureMappingTask::run() {
     waits.push_back(semaphore.get());
   }
 
-  auto label = _commandBuffer->queue().scopedLabel("TextureMappingTask::run()");
-
-  // TODO We should cache and reuse descriptor sets. For now, we create a new one for each frame and
-  //      reset the pool at the end of the frame (see `_descriptorPool->reset()`).
-  auto descriptorSet = _frameContext->acquireDescriptorSet(*_pipeline->descriptorSetLayout());
-
-  // TODO rework on how binding is done. We would like to specify the buffer/image directly instead
-  // of creating VkDescriptorXXXInfo.
-  VkDescriptorImageInfo textureImageInfo{};
-  textureImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  textureImageInfo.imageView   = _texture->view();
-  textureImageInfo.sampler     = _texture->sampler();
-
-  VkDescriptorBufferInfo transformationBufferInfo{};
-  transformationBufferInfo.offset = 0;
-  transformationBufferInfo.range  = VK_WHOLE_SIZE;
-  transformationBufferInfo.buffer = *_uniformBuffer;
-
-  // The order of bindings must match the order of bindings in shaders. The name and the type need
-  // to match them in the shader as well.
-  std::vector<DescriptorSet::Binding> bindings = {
-      {"xform", "Transformation", &transformationBufferInfo},
-      {"texSampler", "sampler2D", &textureImageInfo}};
-
-  descriptorSet->bind(bindings);
+  // The bindings missing from the layout are skipped.
+  if (_transformationBinding != DescriptorUpdateTemplate::kInvalidIndex) {
+    _infos[_transformationBinding].buffer = {*_uniformBuffer, 0, VK_WHOLE_SIZE};
+  }
+  if (_textureBinding != DescriptorUpdateTemplate::kInvalidIndex) {
+    _infos[_textureBinding].image = {
+        _texture->sampler(), _texture->view(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+  }
 
-  auto colorAttachment        = ImageView::make_shared(device(), *_colorBuffer);
-  auto depthStencilAttachment = ImageView::make_shared(device(), *_depthStencilBuffer);
+  // The set written in an earlier frame is reused as long as the bound buffers and images are the
+  // same.
+  DescriptorSet::shared_ptr descriptorSet;
+  if (!_infos.empty()) {
+    descriptorSet =
+        _frameContext->acquireDescriptorSet(*_pipeline->descriptorUpdateTemplate(), _infos);
+  }
 
-  // TODO We should cache and reuse framebuffers. For now, we create a new one for each frame.
-  auto framebuffer =
-      Framebuffer::make_shared(device(), _renderPass, colorAttachment, depthStencilAttachment);
+  // Created at the first frame rendering to the buffers and reused after
+  auto colorAttachment        = device().imageViewCache().view(*_colorBuffer);
+  auto depthStencilAttachment = device().imageViewCache().view(*_depthStencilBuffer);
+  auto framebuffer            = device().framebufferCache().framebuffer(
+      _renderPass, colorAttachment, depthStencilAttachment);
 
-  _frameContext->registerFramebuffer(framebuffer); // To keep it alive until the finish of the frame
+  // To keep it alive until the finish of the frame, even if the cache drops it
+  _frameContext->registerFramebuffer(framebuffer);
 
   _commandBuffer->beginRecording();
   {
-    auto label = _commandBuffer->scopedLabel("Frame");
+    auto label = _commandBuffer->scopedLabel("TextureMappingTask::run()");
 
     _commandBuffer->beginRenderPass(*_renderPass, *framebuffer);
 
@@ -145,7 +214,13 @@ std::pair<Semaphore::shared_ptr, Fence::shared_ptr> TextureMappingTask::run() {
 
     _commandBuffer->bindVertexBuffer(*_vertexBuffer, _vertexBufferBinding);
     _commandBuffer->bindIndexBuffer(*_indexBuffer);
-    _commandBuffer->bindDescriptorSet(*_pipeline, *descriptorSet);
+    if (descriptorSet) {
+      _commandBuffer->bindDescriptorSet(*_pipeline, *descriptorSet);
+    }
+    if (_textureTable) {
+      _textureTable->bind(*_commandBuffer, *_pipeline);
+      _commandBuffer->pushConstants(*_pipeline, _texture->bindlessSlot());
+    }
 
     _commandBuffer->drawIndexed(_numIndices);
 
@@ -201,6 +276,11 @@ ParticlesRenderingTask::ParticlesRenderingTask(const DeviceContext& deviceContex
 
   _pipeline = Pipeline::make_shared(device(), *_renderPass, vertShader, fragShader, config);
 
+  if (const auto& updateTemplate = _pipeline->descriptorUpdateTemplate()) {
+    _infos.resize(updateTemplate->numBindings());
+    _transformationBinding = updateTemplate->index("xform", "Transformation");
+  }
+
   // For now, we only have one vertex buffer binding (hence, 0 indexed). Check
   // `ShaderModule::reflectVertexInputs` to see how `_vertexInputBindings` are reflected.
   _vertexBufferBinding = 0U;
@@ -210,7 +290,16 @@ ParticlesRenderingTask::~ParticlesRenderingTask() {
 }
 
 void ParticlesRenderingTask::prepareGeometry(const VertexBuffer& vertexBuffer) {
-  _vertexBuffer = vertexBuffer.get_shared();
+  prepareGeometry(vertexBuffer, vertexBuffer.numVertices());
+}
+
+void ParticlesRenderingTask::prepareGeometry(const Buffer& buffer, size_t numVertices) {
+  _vertexBuffer = buffer.get_shared();
+  _numVertices  = numVertices;
+}
+
+void ParticlesRenderingTask::prepareQueueFamilyTransfer(std::optional<uint32_t> ownerQueueFamily) {
+  _vertexBufferOwner = ownerQueueFamily;
 }
 
 void ParticlesRenderingTask::prepareUniforms(const glm::mat4& model2world,
@@ -251,38 +340,36 @@ std::pair<Semaphore::shared_ptr, Fence::shared_ptr> ParticlesRenderingTask::run(
     waits.push_back(semaphore.get());
   }
 
-  auto label = _commandBuffer->queue().scopedLabel("ParticlesRenderingTask::run()");
-
-  // TODO We should cache and reuse descriptor sets. For now, we create a new one for each frame and
-  //      reset the pool at the end of the frame (see `_descriptorPool->reset()`).
-  auto descriptorSet = _frameContext->acquireDescriptorSet(*_pipeline->descriptorSetLayout());
-
-  // TODO rework on how binding is done. We would like to specify the buffer/image directly instead
-  // of creating VkDescriptorXXXInfo.
-  VkDescriptorBufferInfo transformationBufferInfo{};
-  transformationBufferInfo.offset = 0;
-  transformationBufferInfo.range  = VK_WHOLE_SIZE;
-  transformationBufferInfo.buffer = *_uniformBuffer;
-
-  // The order of bindings must match the order of bindings in shaders. The name and the type need
-  // to match them in the shader as well.
-  std::vector<DescriptorSet::Binding> bindings = {
-      {"xform", "Transformation", &transformationBufferInfo}};
-
-  descriptorSet->bind(bindings);
+  if (_transformationBinding != DescriptorUpdateTemplate::kInvalidIndex) {
+    _infos[_transformationBinding].buffer = {*_uniformBuffer, 0, VK_WHOLE_SIZE};
+  }
 
-  auto colorAttachment        = ImageView::make_shared(device(), *_colorBuffer);
-  auto depthStencilAttachment = ImageView::make_shared(device(), *_depthStencilBuffer);
+  DescriptorSet::shared_ptr descriptorSet;
+  if (!_infos.empty()) {
+    descriptorSet =
+        _frameContext->acquireDescriptorSet(*_pipeline->descriptorUpdateTemplate(), _infos);
+  }
 
-  // TODO We should cache and reuse framebuffers. For now, we create a new one for each frame.
-  auto framebuffer =
-      Framebuffer::make_shared(device(), _renderPass, colorAttachment, depthStencilAttachment);
+  // Created at the first frame rendering to the buffers and reused after
+  auto colorAttachment        = device().imageViewCache().view(*_colorBuffer);
+  auto depthStencilAttachment = device().imageViewCache().view(*_depthStencilBuffer);
+  auto framebuffer            = device().framebufferCache().framebuffer(
+      _renderPass, colorAttachment, depthStencilAttachment);
 
-  _frameContext->registerFramebuffer(framebuffer); // To keep it alive until the finish of the frame
+  // To keep it alive until the finish of the frame, even if the cache drops it
+  _frameContext->registerFramebuffer(framebuffer);
 
   _commandBuffer->beginRecording();
   {
-    auto label = _commandBuffer->scopedLabel("Frame");
+    auto label = _commandBuffer->scopedLabel("ParticlesRenderingTask::run()");
+    writeBeginTimestamp();
+
+    if (_vertexBufferOwner) {
+      _commandBuffer->acquireBuffer(*_vertexBuffer,
+                                    *_vertexBufferOwner,
+                                    VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                    VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+    }
 
     _commandBuffer->beginRenderPass(*_renderPass, *framebuffer, {0.0F, 0.0F, 0.0F, 1.0F});
 
@@ -292,11 +379,21 @@ std::pair<Semaphore::shared_ptr, Fence::shared_ptr> ParticlesRenderingTask::run(
     _commandBuffer->setViewport({0.0F, 0.0F}, {extent.width, extent.height});
 
     _commandBuffer->bindVertexBuffer(*_vertexBuffer, _vertexBufferBinding);
-    _commandBuffer->bindDescriptorSet(*_pipeline, *descriptorSet);
+    if (descriptorSet) {
+      _commandBuffer->bindDescriptorSet(*_pipeline, *descriptorSet);
+    }
 
-    _commandBuffer->draw(_vertexBuffer->numVertices());
+    _commandBuffer->draw(_numVertices);
 
     _commandBuffer->endRenderpass();
+
+    if (_vertexBufferOwner) {
+      // Only read; there is no write to make available.
+      _commandBuffer->releaseBuffer(
+          *_vertexBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, *_vertexBufferOwner);
+    }
+
+    writeEndTimestamp();
   }
   _commandBuffer->endRecording();
   _commandBuffer->submitCommands(waits, {signal.get()}, *fence);
@@ -311,8 +408,189 @@ DescriptorSetLayout::shared_ptr ParticlesRenderingTask::descriptorSetLayout() {
 //
 //
 //
+ParticlesSimulationTask::ParticlesSimulationTask(const DeviceContext& deviceContext, Type type)
+    : ComputeTask(deviceContext,
+                  ComputeShader{deviceContext.device(), shaderFile("particles.comp.spv").c_str()},
+                  type) {
+  if (const auto& updateTemplate = _pipeline->descriptorUpdateTemplate()) {
+    _infos.resize(updateTemplate->numBindings());
+    _particlesBinding  = updateTemplate->index("particles", "Particles");
+    _simulationBinding = updateTemplate->index("simulation", "Simulation");
+  }
+}
+
+ParticlesSimulationTask::~ParticlesSimulationTask() {
+}
+
+void ParticlesSimulationTask::prepareUniforms(float deltaTime) {
+  Uniforms uniforms{};
+
+  uniforms.deltaTime    = deltaTime;
+  uniforms.numParticles = static_cast<uint32_t>(_numParticles);
+
+  _uniformBuffer = _frameContext->acquireUniformBuffer(id(), uniforms.size());
+  memcpy(_uniformBuffer->map(), &uniforms, sizeof(uniforms));
+  _uniformBuffer->unmap();
+}
+
+void ParticlesSimulationTask::prepareInputs(const StorageBuffer& particles, size_t numParticles) {
+  _particles    = particles.get_shared();
+  _numParticles = numParticles;
+}
+
+void ParticlesSimulationTask::prepareOutputs(const StorageBuffer& vertices,
+                                             uint32_t renderQueueFamily,
+                                             bool drawnBefore) {
+  _vertices          = vertices.get_shared();
+  _renderQueueFamily = renderQueueFamily;
+  _acquireVertices   = drawnBefore;
+}
+
+std::pair<Semaphore::shared_ptr, Fence::shared_ptr> ParticlesSimulationTask::run() {
+  auto label = _commandBuffer->queue().scopedLabel("ParticlesSimulationTask::run()");
+
+  if (_particlesBinding != DescriptorUpdateTemplate::kInvalidIndex) {
+    _infos[_particlesBinding].buffer = {*_particles, 0, VK_WHOLE_SIZE};
+  }
+  if (_simulationBinding != DescriptorUpdateTemplate::kInvalidIndex) {
+    _infos[_simulationBinding].buffer = {*_uniformBuffer, 0, VK_WHOLE_SIZE};
+  }
+
+  if (!_vertices) {
+    return submit("Simulation", _infos, [this](const CommandBuffer& commandBuffer) {
+      // The previous frame may still be drawing the particles.
+      commandBuffer.bufferBarrier(*_particles,
+                                  VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                  VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+      commandBuffer.dispatch(groupCount(_numParticles, WORKGROUP_SIZE));
+
+      // Make the new positions visible to the vertex fetch of the rendering.
+      commandBuffer.bufferBarrier(*_particles,
+                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  VK_ACCESS_SHADER_WRITE_BIT,
+                                  VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                  VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+    });
+  }
+
+  return submit("Async Simulation", _infos, [this](const CommandBuffer& commandBuffer) {
+    // The particles are only accessed by this queue: order the dispatch after the dispatch and the
+    // copy of the previous frame.
+    const VkPipelineStageFlags previousStages =
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+    commandBuffer.bufferBarrier(*_particles,
+                                previousStages,
+                                VK_ACCESS_SHADER_WRITE_BIT,
+                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    commandBuffer.dispatch(groupCount(_numParticles, WORKGROUP_SIZE));
+
+    commandBuffer.bufferBarrier(*_particles,
+                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                VK_ACCESS_SHADER_WRITE_BIT,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                VK_ACCESS_TRANSFER_READ_BIT);
+
+    // The frame that drew `_vertices` last has finished (see `FrameContext::waitFrameRendered()`)
+    // but the buffer is still owned by the graphics queue family.
+    if (_acquireVertices) {
+      commandBuffer.acquireBuffer(*_vertices,
+                                  _renderQueueFamily,
+                                  VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                  VK_ACCESS_TRANSFER_WRITE_BIT);
+    }
+    commandBuffer.copyBuffer(
+        *_particles, *_vertices, std::min(_particles->size(), _vertices->size()));
+    commandBuffer.releaseBuffer(*_vertices,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                VK_ACCESS_TRANSFER_WRITE_BIT,
+                                _renderQueueFamily);
+  });
+}
+
+//
+//
+//
+CompositionTask::CompositionTask(const DeviceContext& deviceContext)
+    : RenderTask(deviceContext, Type::Graphics) {
+}
+
+CompositionTask::~CompositionTask() {
+}
+
+void CompositionTask::prepareInputs(const Image2D& frame) {
+  _frame = frame.get_shared();
+}
+
+void CompositionTask::prepareOverlay(const Image2D& overlay, VkOffset2D offset) {
+  _overlay       = overlay.get_shared();
+  _overlayOffset = offset;
+}
+
+void CompositionTask::prepareOutputs(const Image2D& colorBuffer) {
+  _colorBuffer = colorBuffer.get_shared();
+}
+
+void CompositionTask::prepareSynchronization(const std::vector<Semaphore::shared_ptr>& waits) {
+  _waits = waits;
+}
+
+std::pair<Semaphore::shared_ptr, Fence::shared_ptr> CompositionTask::run() {
+  auto fence  = _frameContext->acquireFence();
+  auto signal = _frameContext->acquireSemaphore();
+
+  std::vector<Semaphore*> waits;
+  waits.reserve(_waits.size());
+  for (const auto& semaphore : _waits) {
+    waits.push_back(semaphore.get());
+  }
+
+  _commandBuffer->beginRecording();
+  {
+    auto label = _commandBuffer->scopedLabel("CompositionTask::run()");
+
+    // No-op in a `RenderGraph`, which transitions the images before the pass
+    _frame->transitToNewLayout(*_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    _colorBuffer->transitToNewLayout(*_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    blit(*_commandBuffer,
+         *_frame,
+         *_colorBuffer,
+         {0, 0},
+         {_colorBuffer->width(), _colorBuffer->height()});
+
+    if (_overlay) {
+      _overlay->transitToNewLayout(*_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+      // Both blits write the overlapping rectangle.
+      _commandBuffer->memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    VK_ACCESS_TRANSFER_WRITE_BIT,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    VK_ACCESS_TRANSFER_WRITE_BIT);
+      blit(*_commandBuffer,
+           *_overlay,
+           *_colorBuffer,
+           _overlayOffset,
+           {_overlay->width(), _overlay->height()});
+    }
+  }
+  _commandBuffer->endRecording();
+  _commandBuffer->submitCommands(waits, {signal.get()}, *fence);
+
+  return {signal, fence};
+}
+
+//
+//
+//
+// The frame is blitted by the graphics queue: the frame is rendered (so owned) by it, and
+// vkCmdBlitImage isn't supported by transfer-only queues.
 PresentTask::PresentTask(const DeviceContext& deviceContext)
-    : RenderTask(deviceContext, Type::Transfer) {
+    : RenderTask(deviceContext, Type::Graphics) {
 }
 
 PresentTask::~PresentTask() {
@@ -345,14 +623,33 @@ std::pair<Semaphore::shared_ptr, Fence::shared_ptr> PresentTask::run() {
   auto fence          = _frameContext->acquireFence();
   auto readyToPresent = _frameContext->acquireSemaphore();
 
+  const auto& device         = _deviceContext.device();
+  const uint32_t queueFamily = _commandBuffer->queue().queueFamilyIndex();
+  const uint32_t presentQueueFamily =
+      device.queueFamilyIndex(Device::QueueFamilyType::Present).value_or(queueFamily);
+
+  auto& swapchainFrame = const_cast<Image&>(swapchain.activeImage());
   _commandBuffer->beginRecording();
   {
-    auto& swapchainFrame = const_cast<Image&>(swapchain.activeImage());
     swapchainFrame.blitFrom(*_commandBuffer, *_frame);
-    swapchainFrame.transitToNewLayout(*_commandBuffer, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    swapchainFrame.releaseOwnership(
+        *_commandBuffer, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, presentQueueFamily);
   }
   _commandBuffer->endRecording();
-  _commandBuffer->submitCommands(waits, {readyToPresent.get()}, *fence);
+
+  if (presentQueueFamily == queueFamily) {
+    _commandBuffer->submitCommands(waits, {readyToPresent.get()}, *fence);
+  } else {
+    // The present queue family acquires the swapchain image before presenting it.
+    auto released = _frameContext->acquireSemaphore();
+    _commandBuffer->submitCommands(waits, {released.get()});
+
+    auto acquisition = _frameContext->acquireCommandBuffer(Device::QueueFamilyType::Present);
+    acquisition->recordCommands([&](const CommandBuffer& commandBuffer) {
+      swapchainFrame.acquireOwnership(commandBuffer, queueFamily);
+    });
+    acquisition->submitCommands({released.get()}, {readyToPresent.get()}, *fence);
+  }
 
   swapchain.present({readyToPresent.get()});
 
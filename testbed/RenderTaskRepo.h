@@ -1,7 +1,12 @@
 #pragma once
 
+#include <optional>
+#include <vector>
+
 #include <Vulk/engine/RenderTask.h>
+#include <Vulk/engine/ComputeTask.h>
 #include <Vulk/engine/Texture2D.h>
+#include <Vulk/engine/BindlessTextureTable.h>
 
 #include <Vulk/RenderPass.h>
 #include <Vulk/Pipeline.h>
@@ -16,6 +21,7 @@
 #include <Vulk/Image2D.h>
 #include <Vulk/VertexBuffer.h>
 #include <Vulk/IndexBuffer.h>
+#include <Vulk/StorageBuffer.h>
 
 MI_NAMESPACE_BEGIN(Vulk)
 
@@ -42,6 +48,17 @@ class TextureMappingTask : public RenderTask {
 
  public:
   explicit TextureMappingTask(const DeviceContext& deviceContext);
+  // Create the pipeline for vertices of the given layout instead of the reflected one, e.g. for
+  // vertices with packed attributes.
+  TextureMappingTask(const DeviceContext& deviceContext,
+                     const VkVertexInputBindingDescription& vertexBinding,
+                     const std::vector<VkVertexInputAttributeDescription>& vertexAttributes);
+  // Sample the texture through `table` (see textureMappingBindless.frag) instead of a descriptor
+  // set of the task. The textures have to be registered to `table`.
+  TextureMappingTask(const DeviceContext& deviceContext,
+                     const VkVertexInputBindingDescription& vertexBinding,
+                     const std::vector<VkVertexInputAttributeDescription>& vertexAttributes,
+                     const BindlessTextureTable& table);
   ~TextureMappingTask() override;
 
   void prepareGeometry(const VertexBuffer& vertexBuffer,
@@ -62,12 +79,22 @@ class TextureMappingTask : public RenderTask {
   //
   MI_DEFINE_SHARED_PTR(TextureMappingTask, RenderTask);
 
+ private:
+  void create(const VkVertexInputBindingDescription& vertexBinding,
+              const std::vector<VkVertexInputAttributeDescription>& vertexAttributes);
+
  private:
   RenderPass::shared_ptr _renderPass;
   Pipeline::shared_ptr _pipeline;
 
   uint32_t _vertexBufferBinding = 0U;
 
+  // Indices of the descriptor bindings in `_infos`, see `DescriptorUpdateTemplate::index()`
+  uint32_t _transformationBinding = DescriptorUpdateTemplate::kInvalidIndex;
+  uint32_t _textureBinding        = DescriptorUpdateTemplate::kInvalidIndex;
+  // One per binding of the set 0, empty if it has none
+  std::vector<DescriptorSet::Info> _infos;
+
   // Geometry
   VertexBuffer::shared_ptr_const _vertexBuffer;
   IndexBuffer::shared_ptr_const _indexBuffer;
@@ -75,6 +102,7 @@ class TextureMappingTask : public RenderTask {
 
   // Inputs
   Texture2D::shared_ptr_const _texture;
+  BindlessTextureTable::shared_ptr_const _textureTable; // Null if not bindless
 
   // Uniforms
   UniformBuffer::shared_ptr _uniformBuffer;
@@ -113,6 +141,12 @@ class ParticlesRenderingTask : public RenderTask {
   ~ParticlesRenderingTask() override;
 
   void prepareGeometry(const VertexBuffer& vertexBuffer);
+  // Draw `numVertices` particles straight from `buffer`, e.g. a storage buffer created with
+  // `StorageBuffer::AS_VERTEX_BUFFER` and written by `ParticlesSimulationTask`.
+  void prepareGeometry(const Buffer& buffer, size_t numVertices);
+  // The vertex buffer is owned by `ownerQueueFamily` (e.g. written by an async simulation). It's
+  // acquired before the drawing and released back after.
+  void prepareQueueFamilyTransfer(std::optional<uint32_t> ownerQueueFamily);
   void prepareUniforms(const glm::mat4& model2world,
                        const glm::mat4& world2view,
                        const glm::mat4& project);
@@ -132,10 +166,14 @@ class ParticlesRenderingTask : public RenderTask {
   RenderPass::shared_ptr _renderPass;
   Pipeline::shared_ptr _pipeline;
 
-  uint32_t _vertexBufferBinding = 0U;
+  uint32_t _vertexBufferBinding   = 0U;
+  uint32_t _transformationBinding = DescriptorUpdateTemplate::kInvalidIndex;
+  std::vector<DescriptorSet::Info> _infos;
 
   // Geometry
-  VertexBuffer::shared_ptr_const _vertexBuffer;
+  Buffer::shared_ptr_const _vertexBuffer;
+  size_t _numVertices = 0;
+  std::optional<uint32_t> _vertexBufferOwner;
 
   // Inputs
 
@@ -150,6 +188,102 @@ class ParticlesRenderingTask : public RenderTask {
   std::vector<Semaphore::shared_ptr> _waits;
 };
 
+//
+// Integrate the particles on the GPU. The particles are updated in place so the buffer can be drawn
+// by `ParticlesRenderingTask` right after without any host traffic.
+//
+// With `Type::Compute` the simulation runs on the compute queue, overlapping the rendering of the
+// previous frame, and copies the particles into a vertex buffer of the frame (see
+// `prepareOutputs()`) which is handed over to the graphics queue.
+//
+class ParticlesSimulationTask : public ComputeTask {
+ public:
+  struct Uniforms {
+    float deltaTime;
+    uint32_t numParticles;
+
+    static size_t size() {
+      return sizeof(Uniforms);
+    }
+  };
+
+  // Must match `local_size_x` in particles.comp
+  static constexpr uint32_t WORKGROUP_SIZE = 256U;
+
+ public:
+  explicit ParticlesSimulationTask(const DeviceContext& deviceContext,
+                                   Type type = Type::Graphics);
+  ~ParticlesSimulationTask() override;
+
+  void prepareUniforms(float deltaTime);
+  void prepareInputs(const StorageBuffer& particles, size_t numParticles);
+  // Copy the simulated particles into `vertices` and release it to `renderQueueFamily`. If
+  // `vertices` has been drawn before, it's acquired back from `renderQueueFamily` first.
+  void prepareOutputs(const StorageBuffer& vertices, uint32_t renderQueueFamily, bool drawnBefore);
+
+  std::pair<Semaphore::shared_ptr, Fence::shared_ptr> run() override;
+
+  //
+  // Override the sharable types and functions
+  //
+  MI_DEFINE_SHARED_PTR(ParticlesSimulationTask, ComputeTask);
+
+ private:
+  // Inputs
+  StorageBuffer::shared_ptr_const _particles;
+  size_t _numParticles = 0;
+
+  // Uniforms
+  UniformBuffer::shared_ptr _uniformBuffer;
+
+  // Outputs
+  StorageBuffer::shared_ptr_const _vertices;
+  uint32_t _renderQueueFamily = 0U;
+  bool _acquireVertices       = false;
+
+  // Indices of the descriptor bindings in `_infos`
+  uint32_t _particlesBinding  = DescriptorUpdateTemplate::kInvalidIndex;
+  uint32_t _simulationBinding = DescriptorUpdateTemplate::kInvalidIndex;
+  std::vector<DescriptorSet::Info> _infos;
+};
+
+//
+// Blit the supersampled frame down into the color buffer with a linear filter, and the overlay, if
+// any, at its own size on top. The inputs are read in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL and the
+// color buffer written in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, which is where the task leaves them.
+//
+class CompositionTask : public RenderTask {
+ public:
+  explicit CompositionTask(const DeviceContext& deviceContext);
+  ~CompositionTask() override;
+
+  void prepareInputs(const Image2D& frame);
+  // Blit `overlay` at `offset` of the color buffer, e.g. an inset view
+  void prepareOverlay(const Image2D& overlay, VkOffset2D offset);
+  void prepareOutputs(const Image2D& colorBuffer);
+  void prepareSynchronization(const std::vector<Semaphore::shared_ptr>& waits = {});
+
+  std::pair<Semaphore::shared_ptr, Fence::shared_ptr> run() override;
+  DescriptorSetLayout::shared_ptr descriptorSetLayout() override { return nullptr; }
+
+  //
+  // Override the sharable types and functions
+  //
+  MI_DEFINE_SHARED_PTR(CompositionTask, RenderTask);
+
+ private:
+  // Inputs
+  Image2D::shared_ptr_const _frame;
+  Image2D::shared_ptr_const _overlay;
+  VkOffset2D _overlayOffset = {0, 0};
+
+  // Outputs
+  Image2D::shared_ptr_const _colorBuffer;
+
+  // Synchronizations
+  std::vector<Semaphore::shared_ptr> _waits;
+};
+
 //
 //
 //
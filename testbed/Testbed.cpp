@@ -6,10 +6,14 @@
 #include <GLFW/glfw3.h>
 
 #include <queue>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <filesystem>
 
 #include <Vulk/internal/debug.h>
+#include <Vulk/Queue.h>
+#include <Vulk/PipelineCache.h>
 
 Testbed::ValidationLevel Testbed::_validationLevel = ValidationLevel::None;
 bool Testbed::_debugUtilsEnabled                   = false;
@@ -38,8 +42,23 @@ void Testbed::init(int width, int height) {
   App::Params params;
   params.add(App::PARAM_MODEL_FILE, _modelFile);
   params.add(App::PARAM_TEXTURE_FILE, _textureFile);
+  params.add(App::PARAM_NUM_PARTICLES, _numParticles);
+  params.add(App::PARAM_CPU_SIMULATION, _cpuSimulation);
+  params.add(App::PARAM_ASYNC_COMPUTE, _asyncCompute);
+  params.add(App::PARAM_BENCHMARK, _benchmark);
+  params.add(App::PARAM_PARALLEL_RECORDING, _parallelRecording);
+  params.add(App::PARAM_BINDLESS, _bindless);
   _app->init(_deviceContext, params);
 
+  // Compare the runs without the file of the pipeline cache (cold) and with it (warm), in all
+  // builds.
+  const auto pipelines = _deviceContext->device().pipelineCache().statistics();
+  std::printf("Created %u pipelines in %.3f ms (%s start, %zu bytes of pipeline cache loaded)\n",
+              pipelines.numPipelines,
+              std::chrono::duration<double, std::milli>(pipelines.creationTime).count(),
+              pipelines.loadedSize > 0 ? "warm" : "cold",
+              pipelines.loadedSize);
+
   _zoomFactor = 1.0F;
 
   // After we init all Vulkan resource and before the rendering, make sure the/ device is idle and
@@ -53,6 +72,18 @@ void Testbed::cleanup() {
 
   _app->cleanup();
 
+  if (_queueContention) {
+    _deviceContext->device().forEachQueue([](const Vulk::Queue& queue) {
+      const auto contention = queue.contention();
+      std::printf("Queue %u.%u: %llu submissions, %llu contended, %.3f ms waiting for the queue\n",
+                  queue.queueFamilyIndex(),
+                  queue.queueIndex(),
+                  static_cast<unsigned long long>(contention.numSubmissions),
+                  static_cast<unsigned long long>(contention.numContended),
+                  std::chrono::duration<double, std::milli>(contention.waitTime).count());
+    });
+  }
+
   _deviceContext->destroy();
 
   MainWindow::cleanup();
@@ -78,7 +109,7 @@ void Testbed::drawFrame() {
 void Testbed::createDeviceContext() {
   Vulk::DeviceContext::CreateInfo createInfo;
   createInfo.versionMajor       = 1;
-  createInfo.versionMinor       = 0;
+  createInfo.versionMinor       = 1;
   createInfo.instanceExtensions = getRequiredInstanceExtensions();
   if (_debugUtilsEnabled) {
     createInfo.instanceExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -90,9 +121,16 @@ void Testbed::createDeviceContext() {
   };
 
   createInfo.queueFamilies.graphics = true;
-  // createInfo.queueFamilies.compute     = true;
+  createInfo.queueFamilies.compute  = true; // A compute-only family if any, for async compute
   createInfo.queueFamilies.transfer = true;
   createInfo.queueFamilies.present  = true;
+  // Main, streaming/async compute and background queues where the families have that many.
+  createInfo.queuePriorities = {1.0F, 0.5F, 0.1F};
+
+  createInfo.submissionMode        = _submissionThreads ? Vulk::Device::SubmissionMode::Threaded
+                                                        : Vulk::Device::SubmissionMode::Direct;
+  createInfo.queueContentionTiming = _queueContention;
+  createInfo.descriptorIndexing    = _bindless;
 
   createInfo.deviceExtensions          = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
   createInfo.hasPhysicalDeviceFeatures = [](VkPhysicalDeviceFeatures supportedFeatures) {
@@ -104,6 +142,8 @@ void Testbed::createDeviceContext() {
     return chooseSwapchainSurfaceExtent(caps, width(), height());
   };
   createInfo.choosePresentMode = &Testbed::chooseSwapchainPresentMode;
+  createInfo.presentQueueDepth = _presentQueueDepth;
+  createInfo.pipelineCacheFile = _pipelineCacheFile.string();
 
   _deviceContext = Vulk::DeviceContext::make_shared();
   _deviceContext->create(createInfo);
@@ -287,3 +327,34 @@ void Testbed::setTextureFile(const std::string& textureFile) {
 
   MI_LOG_INFO("Texture file: %s", _textureFile.c_str());
 }
+void Testbed::setNumParticles(uint32_t numParticles) {
+  _numParticles = numParticles;
+}
+void Testbed::setCpuSimulation(bool enable) {
+  _cpuSimulation = enable;
+}
+void Testbed::setAsyncCompute(bool enable) {
+  _asyncCompute = enable;
+}
+void Testbed::setBenchmark(bool enable) {
+  _benchmark = enable;
+}
+void Testbed::setParallelRecording(bool enable) {
+  _parallelRecording = enable;
+}
+void Testbed::setBindless(bool enable) {
+  _bindless = enable;
+}
+void Testbed::setSubmissionThreads(bool enable) {
+  _submissionThreads = enable;
+}
+void Testbed::setQueueContention(bool enable) {
+  _queueContention = enable;
+}
+void Testbed::setPresentQueueDepth(uint32_t depth) {
+  _presentQueueDepth = depth;
+}
+
+void Testbed::setPipelineCacheFile(const std::string& pipelineCacheFile) {
+  _pipelineCacheFile = pipelineCacheFile;
+}
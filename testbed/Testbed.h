@@ -18,6 +18,16 @@ class Testbed : public MainWindow {
   void setApp(const std::string& appName);
   void setModelFile(const std::string& modelFile);
   void setTextureFile(const std::string& textureFile);
+  void setNumParticles(uint32_t numParticles);
+  void setCpuSimulation(bool enable);
+  void setAsyncCompute(bool enable);
+  void setBenchmark(bool enable);
+  void setParallelRecording(bool enable);
+  void setBindless(bool enable);
+  void setSubmissionThreads(bool enable);
+  void setQueueContention(bool enable);
+  void setPresentQueueDepth(uint32_t depth);
+  void setPipelineCacheFile(const std::string& pipelineCacheFile);
 
   // Settings of the Testbed execution
   using ValidationLevel = Vulk::DeviceContext::ValidationLevel;
@@ -69,4 +79,19 @@ class Testbed : public MainWindow {
   // Input data
   std::filesystem::path _modelFile{};
   std::filesystem::path _textureFile{};
+  uint32_t _numParticles = 0U; // 0: the app default
+  bool _cpuSimulation    = false;
+  bool _asyncCompute     = false;
+  bool _benchmark        = false;
+
+  bool _parallelRecording = false; // Of the render graph
+  bool _bindless          = false; // Requires the descriptor indexing
+
+  // Queue submission
+  bool _submissionThreads = false;
+  bool _queueContention   = false;
+
+  uint32_t _presentQueueDepth = 0U; // 0: present on the render thread
+
+  std::filesystem::path _pipelineCacheFile{}; // Empty: the pipeline cache is not saved
 };
@@ -4,6 +4,15 @@ void App::init(Vulk::DeviceContext::shared_ptr deviceContext, const Params&) {
   _deviceContext = deviceContext.get();
 }
 
+void App::present(Vulk::FrameContext& frameContext,
+                  const Vulk::Presenter::PresentFunc& presentFrame) {
+  if (auto* presenter = deviceContext().presenter()) {
+    presenter->present(frameContext, presentFrame);
+  } else {
+    frameContext.setFrameRendered(presentFrame());
+  }
+}
+
 App::Registry& App::registry() {
   static Registry registry;
   return registry;
@@ -13,6 +13,13 @@ class App {
  public:
   constexpr static std::string PARAM_MODEL_FILE   = "model";
   constexpr static std::string PARAM_TEXTURE_FILE = "texture";
+  constexpr static std::string PARAM_NUM_PARTICLES  = "particles";
+  constexpr static std::string PARAM_CPU_SIMULATION = "cpu-simulation";
+  constexpr static std::string PARAM_ASYNC_COMPUTE  = "async-compute";
+  constexpr static std::string PARAM_BENCHMARK      = "benchmark";
+
+  constexpr static std::string PARAM_PARALLEL_RECORDING = "parallel-recording";
+  constexpr static std::string PARAM_BINDLESS           = "bindless";
 
   class Params;
 
@@ -37,6 +44,10 @@ class App {
   [[nodiscard]] Vulk::DeviceContext& deviceContext() { return *_deviceContext; }
   [[nodiscard]] const Vulk::DeviceContext& deviceContext() const { return *_deviceContext; }
 
+  // Present the frame of `frameContext` by `presentFrame`, on the present thread if there is one.
+  // `presentFrame` must not use the per-frame state of the app that the next frame overwrites.
+  void present(Vulk::FrameContext& frameContext, const Vulk::Presenter::PresentFunc& presentFrame);
+
  private:
   std::string _id;
   std::string _description;
@@ -124,7 +124,6 @@ void ImageViewer::drawFrame() {
     _currentFrame->context->reset();
 
     _textureMappingTask->setFrameContext(*_currentFrame->context);
-    _presentTask->setFrameContext(*_currentFrame->context);
 
     //
     // Texture Mapping Task
@@ -142,12 +141,14 @@ void ImageViewer::drawFrame() {
     //
     // Present Task
     //
-    _presentTask->prepareInput(*_currentFrame->colorBuffer);
-    _presentTask->prepareSynchronization({frameReady});
+    present(*_currentFrame->context, [this, frame = _currentFrame, frameReady]() {
+      _presentTask->setFrameContext(*frame->context);
+      _presentTask->prepareInput(*frame->colorBuffer);
+      _presentTask->prepareSynchronization({frameReady});
 
-    auto [__, framePresented] = _presentTask->run();
-
-    _currentFrame->context->setFrameRendered(framePresented);
+      auto [__, framePresented] = _presentTask->run();
+      return framePresented;
+    });
 
   } catch (const Vulk::Exception& e) {
     if (e.result() == VK_ERROR_OUT_OF_DATE_KHR || e.result() == VK_SUBOPTIMAL_KHR) {
@@ -248,8 +249,9 @@ void ImageViewer::createFrames() {
   constexpr uint32_t stencilBits = 8U;
   auto depthFormat               = Vulk::DepthImage::findFormat(depthBits, stencilBits);
 
+  // The color buffers are only used by the graphics queue.
   auto commandBuffer =
-      _currentFrame->context->acquireCommandBuffer(Vulk::Device::QueueFamilyType::Transfer);
+      _currentFrame->context->acquireCommandBuffer(Vulk::Device::QueueFamilyType::Graphics);
 
   commandBuffer->beginRecording();
   for (auto& frame : _frames) {
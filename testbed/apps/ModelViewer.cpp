@@ -4,24 +4,17 @@
 
 #include <Vulk/engine/Toolbox.h>
 
+#include <Vulk/internal/debug.h>
+
+#include <ModelLoader.h>
+
 // Defined in CMakeLists.txt:GLM_FORCE_DEPTH_ZERO_TO_ONE, GLM_FORCE_RADIANS, GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
-#include <glm/gtx/hash.hpp>
-
-#include <tiny_obj_loader.h>
 
+#include <cmath>
+#include <cstdio>
 #include <filesystem>
 
-namespace std {
-template <>
-struct hash<ModelViewer::Vertex> {
-  size_t operator()(const ModelViewer::Vertex& vertex) const {
-    return ((hash<glm::vec3>()(vertex.pos) ^ (hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^
-           (hash<glm::vec2>()(vertex.texCoord) << 1);
-  }
-};
-} // namespace std
-
 namespace {
 struct Checkerboard : public std::vector<uint8_t> {
   Checkerboard(glm::uvec2 numBlocks,
@@ -79,8 +72,20 @@ void ModelViewer::init(Vulk::DeviceContext::shared_ptr deviceContext, const Para
 
   auto* modelFile   = params[PARAM_MODEL_FILE];
   auto* textureFile = params[PARAM_TEXTURE_FILE];
+  auto* parallel    = params[PARAM_PARALLEL_RECORDING];
+  auto* bindless    = params[PARAM_BINDLESS];
+
+  _parallelRecording = parallel ? parallel->value<bool>() : false;
+  _bindless          = bindless ? bindless->value<bool>() : false;
+
   createDrawable(modelFile ? modelFile->value<std::filesystem::path>() : "",
                  textureFile ? textureFile->value<std::filesystem::path>() : "");
+  if (_bindless) {
+    // Only the texture of the model
+    _textureTable =
+        Vulk::BindlessTextureTable::make_shared(deviceContext(), 1, 1, _maxFramesInFlight);
+    _texture->registerTo(*_textureTable);
+  }
   createRenderTask();
   createFrames();
 
@@ -94,14 +99,27 @@ void ModelViewer::cleanup() {
   deviceContext().waitIdle();
 
   _textureMappingTask.reset();
+  _insetTask.reset();
+  _compositionTask.reset();
   _presentTask.reset();
 
   _texture->destroy();
   _drawable.destroy();
-
-  for (auto& frame : _frames) {
-    frame.colorBuffer->destroy();
-    frame.depthBuffer->destroy();
+  _textureTable.reset();
+
+  // To size the first descriptor pools, see `_initialMaxSets`
+  for (uint32_t i = 0; i < _frames.size(); ++i) {
+    const auto statistics = _frames[i].context->descriptorSetStatistics();
+    std::printf("Frame %u descriptor sets: %llu hits, %llu misses, %llu evictions, %u pools of %u "
+                "sets, at most %u acquired per frame and %u cached\n",
+                i,
+                static_cast<unsigned long long>(statistics.numHits),
+                static_cast<unsigned long long>(statistics.numMisses),
+                static_cast<unsigned long long>(statistics.numEvictions),
+                statistics.numPools,
+                statistics.poolMaxSets,
+                statistics.maxFrameSets,
+                statistics.maxCachedSets);
   }
   _frames.clear();
 }
@@ -124,32 +142,26 @@ void ModelViewer::drawFrame() {
     // been finished.
     _currentFrame->context->waitFrameRendered();
     _currentFrame->context->reset();
-
-    _textureMappingTask->setFrameContext(*_currentFrame->context);
-    _presentTask->setFrameContext(*_currentFrame->context);
+    if (_textureTable) {
+      _textureTable->nextFrame();
+    }
 
     //
-    // Texture Mapping Task
+    // Texture Mapping, Inset and Composition Tasks (see `createFrames()`)
     //
-    _textureMappingTask->prepareGeometry(
-        _drawable.vertexBuffer(), _drawable.indexBuffer(), _drawable.numIndices());
-    _textureMappingTask->prepareUniforms(
-        glm::mat4{1.0F}, _camera->viewMatrix(), _camera->projectionMatrix());
-    _textureMappingTask->prepareInputs(*_texture);
-    _textureMappingTask->prepareOutputs(*_currentFrame->colorBuffer, *_currentFrame->depthBuffer);
-    _textureMappingTask->prepareSynchronization();
-
-    auto [frameReady, _] = _textureMappingTask->run();
+    auto [frameReady, _] = _currentFrame->graph->execute(*_currentFrame->context);
 
     //
     // Present Task
     //
-    _presentTask->prepareInput(*_currentFrame->colorBuffer);
-    _presentTask->prepareSynchronization({frameReady});
-
-    auto [__, framePresented] = _presentTask->run();
+    present(*_currentFrame->context, [this, frame = _currentFrame, frameReady]() {
+      _presentTask->setFrameContext(*frame->context);
+      _presentTask->prepareInput(frame->graph->image2D(frame->colorBuffer));
+      _presentTask->prepareSynchronization({frameReady});
 
-    _currentFrame->context->setFrameRendered(framePresented);
+      auto [__, framePresented] = _presentTask->run();
+      return framePresented;
+    });
 
   } catch (const Vulk::Exception& e) {
     if (e.result() == VK_ERROR_OUT_OF_DATE_KHR || e.result() == VK_SUBOPTIMAL_KHR) {
@@ -162,55 +174,32 @@ void ModelViewer::drawFrame() {
 }
 
 void ModelViewer::createRenderTask() {
-  _textureMappingTask = Vulk::TextureMappingTask::make_shared(deviceContext());
-  _presentTask        = Vulk::PresentTask::make_shared(deviceContext());
-}
-
-void ModelViewer::loadModel(const std::filesystem::path& modelFile,
-                            std::vector<Vertex>& vertices,
-                            std::vector<uint32_t>& indices) {
-  tinyobj::attrib_t attrib;
-  std::vector<tinyobj::shape_t> shapes;
-  std::vector<tinyobj::material_t> materials;
-  std::string warn, err;
-
-  if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, modelFile.c_str())) {
-    throw std::runtime_error(warn + err);
-  }
-
-  std::unordered_map<Vertex, uint32_t> uniqueVertices;
-
-  for (const auto& shape : shapes) {
-    for (const auto& index : shape.mesh.indices) {
-      Vertex vertex{};
-
-      vertex.pos = {attrib.vertices[3 * index.vertex_index + 0],
-                    attrib.vertices[3 * index.vertex_index + 1],
-                    attrib.vertices[3 * index.vertex_index + 2]};
-
-      vertex.texCoord = {attrib.texcoords[2 * index.texcoord_index + 0],
-                         attrib.texcoords[2 * index.texcoord_index + 1]};
-
-      vertex.color = {1.0F, 1.0F, 1.0F};
-
-      if (uniqueVertices.count(vertex) == 0) {
-        uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-        vertices.push_back(vertex);
-      }
-      indices.push_back(uniqueVertices[vertex]);
+  auto createTextureMappingTask = [this]() {
+    if (_textureTable) {
+      return Vulk::TextureMappingTask::make_shared(deviceContext(),
+                                                   Vertex::bindingDescription(0),
+                                                   Vertex::attributesDescription(0),
+                                                   *_textureTable);
     }
-  }
+    return Vulk::TextureMappingTask::make_shared(
+        deviceContext(), Vertex::bindingDescription(0), Vertex::attributesDescription(0));
+  };
+  _textureMappingTask = createTextureMappingTask();
+  _insetTask          = createTextureMappingTask();
+  _compositionTask    = Vulk::CompositionTask::make_shared(deviceContext());
+  _presentTask        = Vulk::PresentTask::make_shared(deviceContext());
 }
 
-void ModelViewer::initCamera(const std::vector<Vertex>& vertices) {
-  auto bbox = Vulk::Camera::BBox::null();
-  for (const auto& vertex : vertices) {
-    bbox += vertex.pos;
-  }
+void ModelViewer::initCamera(Vulk::Camera::BBox bbox) {
   bbox.expandPlanarSide(1.0F);
 
   auto extent = deviceContext().swapchain().surfaceExtent();
   _camera     = Vulk::ArcCamera::make_shared(glm::vec2{extent.width, extent.height}, bbox);
+
+  // Looks at the model from the side
+  const glm::vec2 insetSize{extent.width / _insetRatio, extent.height / _insetRatio};
+  _insetCamera = Vulk::ArcCamera::make_shared(insetSize, bbox);
+  _insetCamera->orbitHorizontal(M_PI / 2.0F);
 }
 
 void ModelViewer::createDrawable(const std::filesystem::path& modelFile,
@@ -238,9 +227,10 @@ void ModelViewer::createDrawable(const std::filesystem::path& modelFile,
     deviceContext().device().setObjectName(VK_OBJECT_TYPE_IMAGE, (uint64_t)image, name.c_str());
   }
 
-  std::vector<Vertex> vertices;
-  std::vector<uint32_t> indices;
   if (modelFile.empty()) {
+    std::vector<ModelLoader::Vertex> vertices;
+    std::vector<uint32_t> indices;
+
     float left{-1.0F};
     float right{1.0F};
     float bottom{-1.0F};
@@ -265,12 +255,18 @@ void ModelViewer::createDrawable(const std::filesystem::path& modelFile,
                 {{right, bottom, 0.0F}, {1.0F, 1.0F, 1.0F}, {1.0F, 1.0F}}};
     indices  = {0, 1, 2, 2, 3, 0};
 
+    const auto bbox = ModelLoader::bboxOf(vertices);
+    _drawable.create(
+        deviceContext().device(), Vulk::MeshImporter::quantize(vertices, bbox), indices);
+    _dequantization = Vulk::MeshImporter::dequantization(bbox);
+    initCamera(bbox);
   } else {
-    loadModel(modelFile, vertices, indices);
-  }
-  _drawable.create(deviceContext().device(), vertices, indices);
+    auto meshFile = ModelLoader::load(modelFile);
 
-  initCamera(vertices);
+    _drawable.create(deviceContext().device(), *meshFile);
+    _dequantization = Vulk::MeshImporter::dequantization(meshFile->bbox());
+    initCamera(meshFile->bbox());
+  }
 }
 
 void ModelViewer::createFrames() {
@@ -279,36 +275,129 @@ void ModelViewer::createFrames() {
   _currentFrameIdx = 0;
   _currentFrame    = &_frames[_currentFrameIdx];
 
-  const auto& device = deviceContext().device();
   const auto& extent = deviceContext().swapchain().surfaceExtent();
-
-  std::vector<Vulk::RenderTask*> tasks = {_textureMappingTask.get()};
-  for (auto& frame : _frames) {
-    frame.context = Vulk::FrameContext::make_shared(deviceContext(), tasks);
+  const VkExtent2D sceneExtent{extent.width * _supersampling, extent.height * _supersampling};
+  const VkExtent2D insetExtent{extent.width / _insetRatio, extent.height / _insetRatio};
+  // In the top right corner
+  const VkOffset2D insetOffset{static_cast<int32_t>(extent.width - insetExtent.width), 0};
+
+  std::vector<Vulk::RenderTask*> tasks = {_textureMappingTask.get(), _insetTask.get()};
+  for (uint32_t i = 0; i < _frames.size(); ++i) {
+    _frames[i].context =
+        Vulk::FrameContext::make_shared(deviceContext(), tasks, i, _initialMaxSets);
   }
 
   constexpr uint32_t depthBits   = 24U;
   constexpr uint32_t stencilBits = 8U;
   auto depthFormat               = Vulk::DepthImage::findFormat(depthBits, stencilBits);
 
-  auto commandBuffer =
-      _currentFrame->context->acquireCommandBuffer(Vulk::Device::QueueFamilyType::Transfer);
-
-  commandBuffer->beginRecording();
   for (auto& frame : _frames) {
-    const auto usage  = Vulk::Image2D::Usage::COLOR_ATTACHMENT | Vulk::Image2D::Usage::TRANSFER_SRC;
-    frame.colorBuffer = Vulk::Image2D::make_shared(device, VK_FORMAT_B8G8R8A8_SRGB, extent, usage);
-    frame.colorBuffer->allocate();
-    frame.depthBuffer = Vulk::DepthImage::make_shared(device, extent, depthFormat);
-    frame.depthBuffer->allocate();
-
-    frame.colorBuffer->transitToNewLayout(*commandBuffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    frame.graph = Vulk::RenderGraph::make_shared(deviceContext());
+
+    const auto sceneUsage =
+        Vulk::Image2D::Usage::COLOR_ATTACHMENT | Vulk::Image2D::Usage::TRANSFER_SRC;
+    const auto colorUsage = Vulk::Image2D::Usage::TRANSFER_DST | Vulk::Image2D::Usage::TRANSFER_SRC;
+
+    auto sceneBuffer =
+        frame.graph->createImage("Scene", VK_FORMAT_B8G8R8A8_SRGB, sceneExtent, sceneUsage);
+    auto depthBuffer = frame.graph->createDepthImage("Depth", depthFormat, sceneExtent);
+    auto insetBuffer =
+        frame.graph->createImage("Inset", VK_FORMAT_B8G8R8A8_SRGB, insetExtent, sceneUsage);
+    auto insetDepthBuffer = frame.graph->createDepthImage("InsetDepth", depthFormat, insetExtent);
+    // Can share the memory of the depth buffers, which are done with by then
+    frame.colorBuffer =
+        frame.graph->createImage("Color", VK_FORMAT_B8G8R8A8_SRGB, extent, colorUsage);
+    frame.graph->markOutput(frame.colorBuffer);
+
+    frame.graph->addPass(
+        "TextureMapping",
+        *_textureMappingTask,
+        [&](Vulk::RenderGraph::PassBuilder& builder) {
+          builder.write(sceneBuffer,
+                        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+          // The render pass transitions the depth buffer from VK_IMAGE_LAYOUT_UNDEFINED.
+          builder.write(depthBuffer,
+                        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                            VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+        },
+        [this, sceneBuffer, depthBuffer](const Vulk::RenderGraph& graph) {
+          _textureMappingTask->prepareGeometry(
+              _drawable.vertexBuffer(), _drawable.indexBuffer(), _drawable.numIndices());
+          _textureMappingTask->prepareUniforms(
+              _dequantization, _camera->viewMatrix(), _camera->projectionMatrix());
+          _textureMappingTask->prepareInputs(*_texture);
+          _textureMappingTask->prepareOutputs(graph.image2D(sceneBuffer),
+                                              graph.depthImage(depthBuffer));
+          _textureMappingTask->prepareSynchronization();
+        });
+
+    frame.graph->addPass(
+        "Inset",
+        *_insetTask,
+        [&](Vulk::RenderGraph::PassBuilder& builder) {
+          builder.write(insetBuffer,
+                        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+          builder.write(insetDepthBuffer,
+                        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                            VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+        },
+        [this, insetBuffer, insetDepthBuffer](const Vulk::RenderGraph& graph) {
+          _insetTask->prepareGeometry(
+              _drawable.vertexBuffer(), _drawable.indexBuffer(), _drawable.numIndices());
+          _insetTask->prepareUniforms(
+              _dequantization, _insetCamera->viewMatrix(), _insetCamera->projectionMatrix());
+          _insetTask->prepareInputs(*_texture);
+          _insetTask->prepareOutputs(graph.image2D(insetBuffer),
+                                     graph.depthImage(insetDepthBuffer));
+          _insetTask->prepareSynchronization();
+        });
+
+    frame.graph->addPass(
+        "Composition",
+        *_compositionTask,
+        [&](Vulk::RenderGraph::PassBuilder& builder) {
+          builder.read(sceneBuffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_ACCESS_TRANSFER_READ_BIT,
+                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+          builder.read(insetBuffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_ACCESS_TRANSFER_READ_BIT,
+                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+          builder.write(frame.colorBuffer,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                        VK_ACCESS_TRANSFER_WRITE_BIT,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        },
+        [this, sceneBuffer, insetBuffer, insetOffset, colorBuffer = frame.colorBuffer](
+            const Vulk::RenderGraph& graph) {
+          _compositionTask->prepareInputs(graph.image2D(sceneBuffer));
+          _compositionTask->prepareOverlay(graph.image2D(insetBuffer), insetOffset);
+          _compositionTask->prepareOutputs(graph.image2D(colorBuffer));
+          _compositionTask->prepareSynchronization();
+        });
+
+    frame.graph->setParallelRecording(_parallelRecording);
+    frame.graph->compile();
   }
-  commandBuffer->endRecording();
 
-  commandBuffer->submitCommands();
-  // No need to wait here since we are going to ait for the device idle after before the 1st
-  // frame rendering
+  const auto& statistics = _frames.front().graph->statistics();
+  std::printf(
+      "Render graph: %u passes, %u submissions and %u barriers per frame, %llu KiB transient "
+      "memory (%llu KiB without aliasing)\n",
+      statistics.numPasses,
+      statistics.numSubmissions,
+      statistics.numBarriers,
+      static_cast<unsigned long long>(statistics.transientMemory / 1024),
+      static_cast<unsigned long long>(statistics.unaliasedMemory / 1024));
 }
 
 void ModelViewer::nextFrame() {
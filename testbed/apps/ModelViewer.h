@@ -2,18 +2,21 @@
 
 #include <Vulk/engine/DeviceContext.h>
 #include <Vulk/engine/FrameContext.h>
+#include <Vulk/engine/RenderGraph.h>
 #include <Vulk/engine/Drawable.h>
 #include <Vulk/engine/Vertex.h>
 #include <Vulk/engine/Camera.h>
+#include <Vulk/engine/BindlessTextureTable.h>
 
 #include <apps/App.h>
 #include <RenderTaskRepo.h>
+#include <ModelLoader.h>
 
 #include <filesystem>
 
 class ModelViewer : public App {
  public:
-  using Vertex = Vulk::VertexPCT<glm::vec3, glm::vec3, glm::vec2>;
+  using Vertex = ModelLoader::PackedVertex;
 
  public:
   ModelViewer();
@@ -39,30 +42,46 @@ class ModelViewer : public App {
 
   void nextFrame();
 
-  void loadModel(const std::filesystem::path& modelFile,
-                 std::vector<Vertex>& vertices,
-                 std::vector<uint32_t>& indices);
-  void initCamera(const std::vector<Vertex>& vertices);
+  void initCamera(Vulk::Camera::BBox bbox);
 
  private:
   Vulk::TextureMappingTask::shared_ptr _textureMappingTask;
+  // Renders the side view of the inset, independently of `_textureMappingTask`
+  Vulk::TextureMappingTask::shared_ptr _insetTask;
+  Vulk::CompositionTask::shared_ptr _compositionTask;
   Vulk::PresentTask::shared_ptr _presentTask;
 
   Vulk::Camera::shared_ptr _camera;
+  Vulk::Camera::shared_ptr _insetCamera;
 
   Vulk::MeshDrawable<Vertex, uint32_t> _drawable;
+  // Maps the quantized positions of `_drawable` back to the model space
+  glm::mat4 _dequantization{1.0F};
   Vulk::Texture2D::shared_ptr _texture;
+  // Null unless the texture is sampled through the table
+  Vulk::BindlessTextureTable::shared_ptr _textureTable;
 
   struct Frame {
     Vulk::FrameContext::shared_ptr context;
 
-    Vulk::Image2D::shared_ptr colorBuffer;
-    Vulk::DepthImage::shared_ptr depthBuffer;
+    // Renders the scene into the transient buffers at `_supersampling` times the resolution of the
+    // swapchain and the inset at 1/`_insetRatio` of it, then blits both into the color buffer,
+    // which is presented. The scene and the inset passes can be recorded in parallel.
+    Vulk::RenderGraph::shared_ptr graph;
+    Vulk::RenderGraph::Resource colorBuffer = 0;
   };
 
+  bool _parallelRecording = false;
+  bool _bindless          = false;
+
   std::vector<Frame> _frames;
   Frame* _currentFrame = nullptr;
 
+  constexpr static uint32_t _supersampling     = 2;
+  constexpr static uint32_t _insetRatio        = 4;
   constexpr static uint32_t _maxFramesInFlight = 3;
-  uint32_t _currentFrameIdx                    = 0;
+  // The sets of each layout the first descriptor pools of a frame hold. The tasks acquire one per
+  // frame; `cleanup()` prints the high-water marks of the run.
+  constexpr static uint32_t _initialMaxSets = 1;
+  uint32_t _currentFrameIdx                 = 0;
 };
@@ -4,23 +4,31 @@
 
 #include <Vulk/engine/Toolbox.h>
 
+#include <Vulk/internal/debug.h>
+
 // Defined in CMakeLists.txt:GLM_FORCE_DEPTH_ZERO_TO_ONE, GLM_FORCE_RADIANS, GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
 #include <glm/gtx/hash.hpp>
 
+#include <algorithm>
 #include <random>
 #include <chrono>
+#include <cstdio>
 
 namespace std {
 template <>
 struct hash<ParticlesViewer::Particle> {
   size_t operator()(const ParticlesViewer::Particle& particle) const {
-    return ((hash<glm::vec3>()(particle.pos) ^ (hash<glm::vec3>()(particle.color) << 1)) >> 1);
+    return ((hash<glm::vec4>()(particle.pos) ^ (hash<glm::vec4>()(particle.color) << 1)) >> 1);
   }
 };
 } // namespace std
 
 namespace {
+constexpr uint32_t kDefaultNumParticles = 32 * 1024U;
+// The benchmark reports the average over this period (in seconds).
+constexpr float kBenchmarkPeriod = 2.0F;
+
 struct Uniforms {
   alignas(sizeof(glm::vec4)) glm::mat4 model;
   alignas(sizeof(glm::vec4)) glm::mat4 view;
@@ -42,7 +50,22 @@ ParticlesViewer::ParticlesViewer() : App{ID, DESCRIPTION} {
 void ParticlesViewer::init(Vulk::DeviceContext::shared_ptr deviceContext, const Params& params) {
   App::init(deviceContext, params);
 
-  createDrawable();
+  auto* numParticles  = params[PARAM_NUM_PARTICLES];
+  auto* cpuSimulation = params[PARAM_CPU_SIMULATION];
+  auto* asyncCompute  = params[PARAM_ASYNC_COMPUTE];
+  auto* benchmark     = params[PARAM_BENCHMARK];
+  _cpuSimulation      = cpuSimulation ? cpuSimulation->value<bool>() : false;
+  _asyncCompute       = !_cpuSimulation && asyncCompute ? asyncCompute->value<bool>() : false;
+  _benchmark          = benchmark ? benchmark->value<bool>() : false;
+
+  if (_asyncCompute &&
+      !deviceContext->device().queueFamilyIndex(Vulk::Device::QueueFamilyType::Compute)) {
+    MI_LOG_WARNING("No compute queue family. The simulation runs on the graphics queue.");
+    _asyncCompute = false;
+  }
+
+  const uint32_t count = numParticles ? numParticles->value<uint32_t>() : 0U;
+  createDrawable(count > 0 ? count : kDefaultNumParticles);
   createRenderTask();
   createFrames();
 
@@ -55,10 +78,12 @@ void ParticlesViewer::cleanup() {
   // Before we clean up all Vulkan resource, make sure the device is idle.
   deviceContext().waitIdle();
 
+  _particlesSimulationTask.reset();
   _particlesRenderingTask.reset();
   _presentTask.reset();
 
-  _drawable.destroy();
+  _particleStorage.reset();
+  _particleBuffer.reset();
 
   for (auto& frame : _frames) {
     frame.colorBuffer->destroy();
@@ -88,38 +113,78 @@ void ParticlesViewer::drawFrame() {
 
     // TODO Label the drawFrame() function in the queue
 
-    updateDrawable(elapsedTime);
-
     // The new current frame may be in use so make sure the last time this frame is rendered to has
     // been finished.
     _currentFrame->context->waitFrameRendered();
     _currentFrame->context->reset();
 
+    if (_benchmark) {
+      readTimestamps(*_currentFrame);
+      reportBenchmark(elapsedTime);
+    }
+    const Vulk::QueryPool* timestamps = _gpuTiming ? _currentFrame->timestamps.get() : nullptr;
+    _currentFrame->timestampsWritten  = _gpuTiming;
+
     _particlesRenderingTask->setFrameContext(*_currentFrame->context);
-    _presentTask->setFrameContext(*_currentFrame->context);
+
+    std::vector<Vulk::Semaphore::shared_ptr> particlesReady;
+    if (_cpuSimulation) {
+      // The particle buffer slot of this frame is no longer read by the GPU.
+      updateDrawable(elapsedTime);
+      _particlesRenderingTask->prepareGeometry(_particleBuffer->slot(*_currentFrame->context));
+    } else {
+      //
+      // Particles Simulation Task
+      //
+      _particlesSimulationTask->setFrameContext(*_currentFrame->context);
+      _particlesSimulationTask->prepareInputs(*_particleStorage, _particles.size());
+      _particlesSimulationTask->prepareUniforms(elapsedTime);
+      if (_asyncCompute) {
+        _particlesSimulationTask->prepareOutputs(*_currentFrame->particleVertices,
+                                                 _graphicsQueueFamily,
+                                                 _currentFrame->particlesDrawn);
+      }
+      // No wait: in the async mode the simulation overlaps the rendering of the previous frame.
+      _particlesSimulationTask->prepareSynchronization();
+      _particlesSimulationTask->prepareTimestamps(timestamps, 0);
+
+      auto [simulated, _] = _particlesSimulationTask->run();
+      particlesReady.push_back(simulated);
+
+      if (_asyncCompute) {
+        _particlesRenderingTask->prepareGeometry(*_currentFrame->particleVertices,
+                                                 _particles.size());
+        _particlesRenderingTask->prepareQueueFamilyTransfer(_computeQueueFamily);
+        _currentFrame->particlesDrawn = true;
+      } else {
+        _particlesRenderingTask->prepareGeometry(*_particleStorage, _particles.size());
+      }
+    }
 
     //
+    // Particles Rendering Task
     //
-    //
-    _particlesRenderingTask->prepareGeometry(_drawable.vertexBuffer());
     _particlesRenderingTask->prepareUniforms(
         glm::mat4{1.0F}, _camera->viewMatrix(), _camera->projectionMatrix());
     _particlesRenderingTask->prepareInputs();
     _particlesRenderingTask->prepareOutputs(*_currentFrame->colorBuffer,
                                             *_currentFrame->depthBuffer);
-    _particlesRenderingTask->prepareSynchronization();
+    _particlesRenderingTask->prepareSynchronization(particlesReady);
+    _particlesRenderingTask->prepareTimestamps(timestamps, 2);
 
     auto [frameReady, _] = _particlesRenderingTask->run();
 
     //
     // Present Task
     //
-    _presentTask->prepareInput(*_currentFrame->colorBuffer);
-    _presentTask->prepareSynchronization({frameReady});
+    present(*_currentFrame->context, [this, frame = _currentFrame, frameReady]() {
+      _presentTask->setFrameContext(*frame->context);
+      _presentTask->prepareInput(*frame->colorBuffer);
+      _presentTask->prepareSynchronization({frameReady});
 
-    auto [__, framePresented] = _presentTask->run();
-
-    _currentFrame->context->setFrameRendered(framePresented);
+      auto [__, framePresented] = _presentTask->run();
+      return framePresented;
+    });
 
   } catch (const Vulk::Exception& e) {
     if (e.result() == VK_ERROR_OUT_OF_DATE_KHR || e.result() == VK_SUBOPTIMAL_KHR) {
@@ -132,6 +197,22 @@ void ParticlesViewer::drawFrame() {
 }
 
 void ParticlesViewer::createRenderTask() {
+  const auto& device   = deviceContext().device();
+  _graphicsQueueFamily = device.queueFamilyIndex(Vulk::Device::QueueFamilyType::Graphics).value();
+  // Without a compute queue family, the simulation isn't async and runs on the graphics one.
+  _computeQueueFamily = device.queueFamilyIndex(Vulk::Device::QueueFamilyType::Compute)
+                            .value_or(_graphicsQueueFamily);
+
+  if (!_cpuSimulation) {
+    const auto type = _asyncCompute ? Vulk::RenderTask::Type::Compute
+                                    : Vulk::RenderTask::Type::Graphics;
+    _particlesSimulationTask = Vulk::ParticlesSimulationTask::make_shared(deviceContext(), type);
+  }
+  if (_asyncCompute && _computeQueueFamily == _graphicsQueueFamily &&
+      device.queues(Vulk::Device::QueueFamilyType::Compute).size() == 1) {
+    MI_LOG_WARNING("No dedicated compute queue. The async simulation shares the queue of the "
+                   "rendering.");
+  }
   _particlesRenderingTask = Vulk::ParticlesRenderingTask::make_shared(deviceContext());
   _presentTask            = Vulk::PresentTask::make_shared(deviceContext());
 }
@@ -139,7 +220,7 @@ void ParticlesViewer::createRenderTask() {
 void ParticlesViewer::initCamera(const std::vector<Particle>& particles) {
   auto bbox = Vulk::Camera::BBox::null();
   for (const auto& vertex : particles) {
-    bbox += vertex.pos;
+    bbox += glm::vec3(vertex.pos);
   }
   bbox.expandPlanarSide(1.0F);
 
@@ -147,11 +228,10 @@ void ParticlesViewer::initCamera(const std::vector<Particle>& particles) {
   _camera     = Vulk::ArcCamera::make_shared(glm::vec2{extent.width, extent.height}, bbox);
 }
 
-void ParticlesViewer::initParticles() {
+void ParticlesViewer::initParticles(uint32_t numParticles) {
   std::default_random_engine rndEngine((unsigned)time(nullptr));
   std::uniform_real_distribution<float> rndDist(0.0f, 1.0f);
 
-  constexpr uint32_t numParticles = 32 * 1024U;
   _particles.resize(numParticles);
 
   for (auto& particle : _particles) {
@@ -166,15 +246,29 @@ void ParticlesViewer::initParticles() {
     float y = r * sin(phi) * sin(theta);
     float z = r * cos(phi);
 
-    particle.pos   = glm::vec3(x, y, z);
+    particle.pos   = glm::vec4(x, y, z, 1.0f);
     particle.color = glm::vec4(x * x * 2, y * y * 2, z * z * 2, 1.0f);
   }
 }
 
-void ParticlesViewer::createDrawable() {
-  initParticles();
+void ParticlesViewer::createDrawable(uint32_t numParticles) {
+  initParticles(numParticles);
 
-  _drawable.create(deviceContext().device(), _particles);
+  const auto& device = deviceContext().device();
+  if (_cpuSimulation) {
+    _particleBuffer =
+        Vulk::DynamicVertexBuffer::make_shared(device, _particles, _maxFramesInFlight);
+  } else {
+    // Uploaded once. From then on the particles never leave the GPU.
+    const VkDeviceSize size = sizeof(Particle) * _particles.size();
+    _particleStorage        = Vulk::StorageBuffer::make_shared(
+        device, size, Vulk::StorageBuffer::Property::AS_VERTEX_BUFFER);
+    if (_asyncCompute) {
+      // Only the simulation on the compute queue uses it.
+      _particleStorage->setOwnerQueueFamily(Vulk::Device::QueueFamilyType::Compute);
+    }
+    _particleStorage->load(_particles.data(), size);
+  }
 
   initCamera(_particles);
 }
@@ -187,15 +281,97 @@ void ParticlesViewer::updateParticles(float deltaTime) {
   glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0F), angle, glm::vec3(0.0F, 1.0F, 0.0F));
 
   for (auto& particle : _particles) {
-    glm::vec4 pos = glm::vec4(particle.pos, 1.0F);
-    pos           = rotationMatrix * pos;
-    particle.pos  = glm::vec3(pos);
+    particle.pos = rotationMatrix * glm::vec4(glm::vec3(particle.pos), 1.0F);
   }
 }
 
 void ParticlesViewer::updateDrawable(float deltaTime) {
   updateParticles(deltaTime);
-  _drawable.update(_particles);
+  _particleBuffer->update(*_currentFrame->context, _particles);
+}
+
+void ParticlesViewer::readTimestamps(Frame& frame) {
+  if (!frame.timestampsWritten) {
+    return;
+  }
+  frame.timestampsWritten = false;
+
+  // The frame has been rendered so the results are available.
+  std::vector<uint64_t> rendering;
+  if (!frame.timestamps->results(2, 2, rendering)) {
+    return;
+  }
+  const double msPerTick = deviceContext().device().physicalDevice().timestampPeriod() * 1.0e-6;
+  _gpuRenderingTime += static_cast<double>(rendering[1] - rendering[0]) * msPerTick;
+
+  std::vector<uint64_t> simulation;
+  if (_particlesSimulationTask && frame.timestamps->results(0, 2, simulation)) {
+    _gpuSimulationTime += static_cast<double>(simulation[1] - simulation[0]) * msPerTick;
+
+    // Timestamps of different queues are assumed to be in the same time domain, which holds on
+    // the common implementations.
+    if (_lastRenderingEnd > 0) {
+      const auto begin = std::max(simulation[0], _lastRenderingBegin);
+      const auto end   = std::min(simulation[1], _lastRenderingEnd);
+      if (end > begin) {
+        _gpuOverlapTime += static_cast<double>(end - begin) * msPerTick;
+      }
+    }
+  }
+  _lastRenderingBegin = rendering[0];
+  _lastRenderingEnd   = rendering[1];
+
+  ++_gpuFrames;
+}
+
+void ParticlesViewer::reportBenchmark(float frameTime) {
+  _benchmarkTime += frameTime;
+  ++_benchmarkFrames;
+  if (_benchmarkTime < kBenchmarkPeriod) {
+    return;
+  }
+
+  const auto frames      = static_cast<float>(_benchmarkFrames);
+  const float msPerFrame = 1000.0F * _benchmarkTime / frames;
+  const float mparticlesPerSec =
+      static_cast<float>(_particles.size()) * frames / _benchmarkTime / 1.0e6F;
+  const char* mode = _cpuSimulation ? "CPU" : (_asyncCompute ? "GPU async" : "GPU");
+  // Printed in all builds, the release ones being the only ones worth benchmarking
+  std::printf("[%s] %zu particles: %.3f ms/frame, %.1f Mparticles/s\n",
+              mode,
+              _particles.size(),
+              msPerFrame,
+              mparticlesPerSec);
+  if (_gpuFrames > 0) {
+    const auto gpuFrames = static_cast<double>(_gpuFrames);
+    std::printf("[%s] GPU simulation %.3f ms, rendering %.3f ms, overlap %.3f ms per frame\n",
+                mode,
+                _gpuSimulationTime / gpuFrames,
+                _gpuRenderingTime / gpuFrames,
+                _gpuOverlapTime / gpuFrames);
+  }
+  if (auto* presenter = deviceContext().presenter()) {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    const auto metrics = presenter->metrics();
+    // The depths count the frame being presented on top of the queued ones.
+    std::printf("[%s] Present latency %.3f ms (last %.3f ms), queue depth %u (max %u of %u), "
+                "blocked %.3f ms\n",
+                mode,
+                Milliseconds(metrics.averageLatency).count(),
+                Milliseconds(metrics.lastLatency).count(),
+                metrics.queueDepth,
+                metrics.maxQueueDepth,
+                presenter->queueDepth() + 1,
+                Milliseconds(metrics.blockedTime).count());
+    presenter->resetMetrics();
+  }
+
+  _benchmarkTime     = 0.0F;
+  _benchmarkFrames   = 0U;
+  _gpuFrames         = 0U;
+  _gpuSimulationTime = 0.0;
+  _gpuRenderingTime  = 0.0;
+  _gpuOverlapTime    = 0.0;
 }
 
 void ParticlesViewer::createFrames() {
@@ -208,16 +384,39 @@ void ParticlesViewer::createFrames() {
   const auto& extent = deviceContext().swapchain().surfaceExtent();
 
   std::vector<Vulk::RenderTask*> tasks = {_particlesRenderingTask.get()};
-  for (auto& frame : _frames) {
-    frame.context = Vulk::FrameContext::make_shared(deviceContext(), tasks);
+  if (_particlesSimulationTask) {
+    tasks.push_back(_particlesSimulationTask.get());
+  }
+  for (uint32_t i = 0; i < _maxFramesInFlight; ++i) {
+    _frames[i].context = Vulk::FrameContext::make_shared(deviceContext(), tasks, i);
+  }
+
+  if (_asyncCompute) {
+    const VkDeviceSize size = sizeof(Particle) * _particles.size();
+    for (auto& frame : _frames) {
+      frame.particleVertices = Vulk::StorageBuffer::make_shared(
+          device, size, Vulk::StorageBuffer::Property::AS_VERTEX_BUFFER);
+    }
+  }
+
+  const auto& limits = device.physicalDevice().properties().limits;
+  _gpuTiming         = _benchmark && limits.timestampComputeAndGraphics;
+  if (_benchmark && !_gpuTiming) {
+    MI_LOG_WARNING("Timestamps are not supported by all the graphics and compute queues.");
+  }
+  if (_gpuTiming) {
+    for (auto& frame : _frames) {
+      frame.timestamps = Vulk::QueryPool::make_shared(device, VK_QUERY_TYPE_TIMESTAMP, 4);
+    }
   }
 
   constexpr uint32_t depthBits   = 24U;
   constexpr uint32_t stencilBits = 8U;
   auto depthFormat               = Vulk::DepthImage::findFormat(depthBits, stencilBits);
 
+  // The color buffers are only used by the graphics queue.
   auto commandBuffer =
-      _currentFrame->context->acquireCommandBuffer(Vulk::Device::QueueFamilyType::Transfer);
+      _currentFrame->context->acquireCommandBuffer(Vulk::Device::QueueFamilyType::Graphics);
 
   commandBuffer->beginRecording();
   for (auto& frame : _frames) {
@@ -2,10 +2,12 @@
 
 #include <Vulk/engine/DeviceContext.h>
 #include <Vulk/engine/FrameContext.h>
-#include <Vulk/engine/Drawable.h>
+#include <Vulk/engine/DynamicVertexBuffer.h>
 #include <Vulk/engine/Vertex.h>
 #include <Vulk/engine/Camera.h>
 
+#include <Vulk/QueryPool.h>
+
 #include <apps/App.h>
 #include <RenderTaskRepo.h>
 
@@ -13,7 +15,8 @@
 
 class ParticlesViewer : public App {
  public:
-  using Particle = Vulk::VertexPC<glm::vec3, glm::vec4>;
+  // `pos.w` is unused. It pads the particle to the std430 layout of particles.comp.
+  using Particle = Vulk::VertexPC<glm::vec4, glm::vec4>;
 
  public:
   ParticlesViewer();
@@ -34,7 +37,7 @@ class ParticlesViewer : public App {
   void drawFrame();
 
  private:
-  void createDrawable();
+  void createDrawable(uint32_t numParticles);
   void createRenderTask();
   void createFrames();
 
@@ -42,24 +45,47 @@ class ParticlesViewer : public App {
 
   void initCamera(const std::vector<Particle>& vertices);
 
-  void initParticles();
+  void initParticles(uint32_t numParticles);
   void updateParticles(float deltaTime);
 
   void updateDrawable(float deltaTime);
 
+  struct Frame;
+  void readTimestamps(Frame& frame);
+  void reportBenchmark(float frameTime);
+
  private:
+  Vulk::ParticlesSimulationTask::shared_ptr _particlesSimulationTask;
   Vulk::ParticlesRenderingTask::shared_ptr _particlesRenderingTask;
   Vulk::PresentTask::shared_ptr _presentTask;
 
   Vulk::Camera::shared_ptr _camera;
 
-  Vulk::PointsDrawable<Particle> _drawable;
+  // GPU simulation: the particles live in a device local buffer, integrated by a compute shader and
+  // drawn from the same buffer.
+  Vulk::StorageBuffer::shared_ptr _particleStorage;
+  // CPU simulation: one slot per frame in flight so updating the particles never waits for the GPU.
+  Vulk::DynamicVertexBuffer::shared_ptr _particleBuffer;
+  bool _cpuSimulation = false;
+  // Async GPU simulation: the particles are integrated on the compute queue and copied into the
+  // vertex buffer of the frame, which is handed over to the graphics queue.
+  bool _asyncCompute            = false;
+  uint32_t _graphicsQueueFamily = 0U;
+  uint32_t _computeQueueFamily  = 0U;
 
   struct Frame {
     Vulk::FrameContext::shared_ptr context;
 
     Vulk::Image2D::shared_ptr colorBuffer;
     Vulk::DepthImage::shared_ptr depthBuffer;
+
+    // Async compute only
+    Vulk::StorageBuffer::shared_ptr particleVertices;
+    bool particlesDrawn = false;
+
+    // GPU timestamps of the simulation (0, 1) and the rendering (2, 3) of the frame
+    Vulk::QueryPool::shared_ptr timestamps;
+    bool timestampsWritten = false;
   };
 
   std::vector<Frame> _frames;
@@ -69,4 +95,17 @@ class ParticlesViewer : public App {
   uint32_t _currentFrameIdx                    = 0;
 
   std::vector<Particle> _particles;
+
+  // Benchmark
+  bool _benchmark           = false;
+  uint32_t _benchmarkFrames = 0U;
+  float _benchmarkTime      = 0.0F;
+
+  bool _gpuTiming              = false;
+  uint32_t _gpuFrames          = 0U;
+  double _gpuSimulationTime    = 0.0; // in ms
+  double _gpuRenderingTime     = 0.0; // in ms
+  double _gpuOverlapTime       = 0.0; // of the simulation and the rendering of the previous frame
+  uint64_t _lastRenderingBegin = 0U;
+  uint64_t _lastRenderingEnd   = 0U;
 };
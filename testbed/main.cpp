@@ -29,7 +29,7 @@ int main(int argc, char** argv) {
     )
     (
       "m,model",
-      "Set the input model file (.obj file only)",
+      "Set the input model file (.obj or .vmesh file)",
       cxxopts::value<std::string>()
     )
     (
@@ -37,6 +37,56 @@ int main(int argc, char** argv) {
       "Set the input texture file (.jpg/.png file only)",
       cxxopts::value<std::string>()
     )
+    (
+      "particles",
+      "Set the number of particles of ParticlesViewer",
+      cxxopts::value<uint32_t>()
+    )
+    (
+      "cpu-simulation",
+      "Simulate the particles on the CPU instead of a compute shader (ParticlesViewer)",
+      cxxopts::value<bool>()->default_value("false")
+    )
+    (
+      "async-compute",
+      "Simulate the particles on the compute queue, overlapping the rendering (ParticlesViewer)",
+      cxxopts::value<bool>()->default_value("false")
+    )
+    (
+      "benchmark",
+      "Periodically log the frame time, the GPU time and the throughput of the app",
+      cxxopts::value<bool>()->default_value("false")
+    )
+    (
+      "parallel-recording",
+      "Record the passes of the render graph on the TBB threads (ModelViewer)",
+      cxxopts::value<bool>()->default_value("false")
+    )
+    (
+      "bindless",
+      "Sample the texture through a bindless texture table of descriptor indexing (ModelViewer)",
+      cxxopts::value<bool>()->default_value("false")
+    )
+    (
+      "submission-threads",
+      "Submit to the queues from a submission thread per queue instead of the calling threads",
+      cxxopts::value<bool>()->default_value("false")
+    )
+    (
+      "queue-contention",
+      "Log the time the submissions waited for the queues at exit",
+      cxxopts::value<bool>()->default_value("false")
+    )
+    (
+      "present-thread",
+      "Present on a present thread with a queue of up to N rendered frames (0: on the render thread)",
+      cxxopts::value<uint32_t>()->default_value("0")
+    )
+    (
+      "pipeline-cache",
+      "Load the pipeline cache from the file at startup and save it back at exit",
+      cxxopts::value<std::string>()
+    )
     (
       "v, validation-level",
       "Set Vulkan validation level (0: none, 1: error, 2: warning, 3: info, 4: verbose)",
@@ -92,6 +142,20 @@ int main(int argc, char** argv) {
   if (options.count("texture")) {
     testbed.setTextureFile(options["texture"].as<std::string>());
   }
+  if (options.count("particles")) {
+    testbed.setNumParticles(options["particles"].as<uint32_t>());
+  }
+  testbed.setCpuSimulation(options["cpu-simulation"].as<bool>());
+  testbed.setAsyncCompute(options["async-compute"].as<bool>());
+  testbed.setBenchmark(options["benchmark"].as<bool>());
+  testbed.setParallelRecording(options["parallel-recording"].as<bool>());
+  testbed.setBindless(options["bindless"].as<bool>());
+  testbed.setSubmissionThreads(options["submission-threads"].as<bool>());
+  testbed.setQueueContention(options["queue-contention"].as<bool>());
+  testbed.setPresentQueueDepth(options["present-thread"].as<uint32_t>());
+  if (options.count("pipeline-cache")) {
+    testbed.setPipelineCacheFile(options["pipeline-cache"].as<std::string>());
+  }
 
   constexpr int width  = 960;
   constexpr int height = 540;
@@ -0,0 +1,23 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// The arrays of `Vulk::BindlessTextureTable`
+layout(set = 1, binding = 0) uniform texture2D textures[];
+layout(set = 1, binding = 1) uniform sampler samplers[];
+
+// `Vulk::BindlessTextureTable::Slot` of the texture
+layout(push_constant) uniform Slot {
+  uint image;
+  uint sampler;
+}
+slot;
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+  outColor = texture(sampler2D(textures[nonuniformEXT(slot.image)], samplers[slot.sampler]),
+                     fragTexCoord);
+}
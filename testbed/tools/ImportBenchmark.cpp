@@ -0,0 +1,187 @@
+#include <Vulk/engine/MeshImporter.h>
+#include <Vulk/engine/MappedFile.h>
+
+// Defined in CMakeLists.txt:GLM_FORCE_DEPTH_ZERO_TO_ONE, GLM_FORCE_RADIANS, GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+#include <tiny_obj_loader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <istream>
+#include <unordered_map>
+
+#include <cxxopts.hpp>
+
+using Vertex = Vulk::MeshImporter::Vertex;
+using Index  = Vulk::MeshImporter::Index;
+
+namespace std {
+template <>
+struct hash<Vertex> {
+  size_t operator()(const Vertex& vertex) const {
+    return ((hash<glm::vec3>()(vertex.pos) ^ (hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^
+           (hash<glm::vec2>()(vertex.texCoord) << 1);
+  }
+};
+} // namespace std
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// The single-threaded import through std::unordered_map that MeshImporter replaces.
+bool importObjLegacy(const std::filesystem::path& objFile,
+                     std::vector<Vertex>& vertices,
+                     std::vector<Index>& indices,
+                     double& parseTime,
+                     double& dedupTime) {
+  auto start = Clock::now();
+
+  tinyobj::attrib_t attrib;
+  std::vector<tinyobj::shape_t> shapes;
+  std::vector<tinyobj::material_t> materials;
+  std::string warn, err;
+
+  Vulk::MappedFile file{objFile.string(), Vulk::MappedFile::Access::Sequential};
+  Vulk::MappedFile::StreamBuf streamBuf{file};
+  std::istream objStream{&streamBuf};
+  tinyobj::MaterialFileReader materialReader{objFile.parent_path().string() + "/"};
+
+  if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &objStream, &materialReader)) {
+    std::cerr << warn << err << std::endl;
+    return false;
+  }
+
+  parseTime = secondsSince(start);
+  start     = Clock::now();
+
+  std::unordered_map<Vertex, Index> uniqueVertices;
+
+  for (const auto& shape : shapes) {
+    for (const auto& index : shape.mesh.indices) {
+      Vertex vertex{};
+
+      vertex.pos = {attrib.vertices[3 * index.vertex_index + 0],
+                    attrib.vertices[3 * index.vertex_index + 1],
+                    attrib.vertices[3 * index.vertex_index + 2]};
+
+      if (index.texcoord_index >= 0) {
+        vertex.texCoord = {attrib.texcoords[2 * index.texcoord_index + 0],
+                           attrib.texcoords[2 * index.texcoord_index + 1]};
+      }
+
+      vertex.color = {1.0F, 1.0F, 1.0F};
+
+      if (uniqueVertices.count(vertex) == 0) {
+        uniqueVertices[vertex] = static_cast<Index>(vertices.size());
+        vertices.push_back(vertex);
+      }
+      indices.push_back(uniqueVertices[vertex]);
+    }
+  }
+
+  dedupTime = secondsSince(start);
+  return true;
+}
+
+} // namespace
+
+// Compare the legacy OBJ import with the parallel MeshImporter on the same model.
+int main(int argc, char** argv) {
+  cxxopts::Options supportedOptions("ImportBenchmark", "Benchmark of OBJ model import");
+
+  // clang-format off
+  supportedOptions.add_options()
+    (
+      "m,model",
+      "Set the input model file (.obj file only)",
+      cxxopts::value<std::string>()
+    )
+    (
+      "r,repeat",
+      "Number of runs of each importer; the best run is reported",
+      cxxopts::value<int>()->default_value("3")
+    )
+    (
+      "h,help",
+      "Print usage"
+    );
+  // clang-format on
+
+  auto options = supportedOptions.parse(argc, argv);
+
+  if (options.count("help") || !options.count("model")) {
+    std::cout << supportedOptions.help() << std::endl;
+    return options.count("help") ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  const std::filesystem::path model = options["model"].as<std::string>();
+  const int repeat                  = std::max(options["repeat"].as<int>(), 1);
+
+  double legacyParse = 1e30;
+  double legacyDedup = 1e30;
+  std::vector<Vertex> legacyVertices;
+  std::vector<Index> legacyIndices;
+  for (int i = 0; i < repeat; ++i) {
+    std::vector<Vertex> vertices;
+    std::vector<Index> indices;
+    double parseTime = 0.0;
+    double dedupTime = 0.0;
+    if (!importObjLegacy(model, vertices, indices, parseTime, dedupTime)) {
+      return EXIT_FAILURE;
+    }
+    if (parseTime + dedupTime < legacyParse + legacyDedup) {
+      legacyParse = parseTime;
+      legacyDedup = dedupTime;
+    }
+    legacyVertices = std::move(vertices);
+    legacyIndices  = std::move(indices);
+  }
+
+  Vulk::MeshImporter::Statistics best{};
+  best.parseTime = 1e30;
+  std::vector<Vertex> vertices;
+  std::vector<Index> indices;
+  for (int i = 0; i < repeat; ++i) {
+    Vulk::MeshImporter::Statistics stats{};
+    vertices.clear();
+    indices.clear();
+    if (!Vulk::MeshImporter::importObj(model, vertices, indices, &stats)) {
+      return EXIT_FAILURE;
+    }
+    if (stats.parseTime + stats.dedupTime + stats.mergeTime <
+        best.parseTime + best.dedupTime + best.mergeTime) {
+      best = stats;
+    }
+  }
+
+  const double legacyTotal   = legacyParse + legacyDedup;
+  const double importerDedup = best.dedupTime + best.mergeTime;
+  const double importerTotal = best.parseTime + importerDedup;
+
+  std::cout << "Model    : " << model << "\n";
+  std::cout << "Corners  : " << best.numCorners << " in " << best.numBlocks << " blocks\n";
+  std::cout << "Vertices : legacy " << legacyVertices.size() << ", importer " << vertices.size()
+            << "\n";
+  std::cout << "Legacy   : parse " << legacyParse << " s, dedup " << legacyDedup << " s, total "
+            << legacyTotal << " s\n";
+  std::cout << "Importer : parse " << best.parseTime << " s, dedup " << best.dedupTime
+            << " s, merge " << best.mergeTime << " s, total " << importerTotal << " s\n";
+  std::cout << "Speedup  : dedup " << legacyDedup / importerDedup << "x, total "
+            << legacyTotal / importerTotal << "x\n";
+
+  // Both importers deduplicate in first-occurrence order so their results must be identical
+  // (except for -0.0 which the importer folds into 0.0).
+  const bool identical = legacyIndices == indices && legacyVertices == vertices;
+  std::cout << "Results  : " << (identical ? "identical" : "DIFFERENT") << std::endl;
+
+  return EXIT_SUCCESS;
+}
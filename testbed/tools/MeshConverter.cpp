@@ -0,0 +1,57 @@
+#include <ModelLoader.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+#include <cxxopts.hpp>
+
+// Offline conversion of OBJ models to the binary mesh format loaded by ModelViewer.
+int main(int argc, char** argv) {
+  cxxopts::Options supportedOptions("MeshConverter", "Convert OBJ models to binary mesh files");
+
+  // clang-format off
+  supportedOptions.add_options()
+    (
+      "i,input",
+      "Set the input model file (.obj file only)",
+      cxxopts::value<std::string>()
+    )
+    (
+      "o,output",
+      "Set the output mesh file. Default to the input file with .vmesh extension",
+      cxxopts::value<std::string>()
+    )
+    (
+      "no-optimize",
+      "Keep the triangle and vertex order of the input and 32-bit indices"
+    )
+    (
+      "h,help",
+      "Print usage"
+    );
+  // clang-format on
+
+  auto options = supportedOptions.parse(argc, argv);
+
+  if (options.count("help") || !options.count("input")) {
+    std::cout << supportedOptions.help() << std::endl;
+    return options.count("help") ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  std::filesystem::path input = options["input"].as<std::string>();
+  std::filesystem::path output =
+      options.count("output") ? std::filesystem::path{options["output"].as<std::string>()}
+                              : std::filesystem::path{input}.replace_extension(
+                                    Vulk::MeshFile::EXTENSION);
+
+  try {
+    ModelLoader::convert(input, output, 0, options.count("no-optimize") == 0);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Converted " << input << " to " << output << std::endl;
+  return EXIT_SUCCESS;
+}